@@ -0,0 +1,46 @@
+#ifndef __AST_H__
+#define __AST_H__
+
+#include <stddef.h>
+#include "matrix.h"
+
+typedef enum {
+    NOEUD_CONSTANTE,
+    NOEUD_VARIABLE,
+    NOEUD_MATRICE,      // fils : les lignes (aucun si la matrice est lue d'un bloc)
+    NOEUD_LIGNE,        // fils : les coefficients
+    NOEUD_SOMME,        // fils : les termes, de gauche à droite
+    NOEUD_PRODUIT,      // fils : les facteurs, de gauche à droite
+    NOEUD_OPPOSE,
+    NOEUD_INVERSE,
+    NOEUD_APPEL,        // fils : les arguments
+    NOEUD_ARGUMENTS,    // liste d'arguments en cours d'analyse
+    NOEUD_AFFECTATION,
+    NOEUD_RESOLUTION    // A X = B : fils A et B
+} nature_noeud;
+
+// Arbre syntaxique d'une ligne, construit par l'analyseur et évalué
+// ensuite : aucun calcul n'est fait pendant l'analyse, si bien qu'un retour
+// arrière de l'analyseur ne coûte que la construction des noeuds
+typedef struct s_node {
+    nature_noeud nature;
+    char * nom;                 // fonction appelée
+    unsigned int symbole;       // variable lue ou affectée (voir interner)
+    E s;                        // valeur d'une constante
+    Matrix m;                   // matrice de constantes lue d'un bloc
+    unsigned int nb;
+    struct s_node ** fils;
+} * Node;
+
+Node newNode(nature_noeud nature, unsigned int nb);
+Node newConstante(E s);
+void deleteNode(Node n);
+Node simplifier(Node n);
+
+// Table des symboles : chaque nom de variable reçoit à l'analyse un
+// numéro, le même à chaque occurrence, qui indexe l'environnement
+unsigned int interner(const char * nom, size_t n);
+const char * nom_symbole(unsigned int symbole);
+void liberer_symboles(void);
+
+#endif
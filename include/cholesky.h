@@ -0,0 +1,16 @@
+#ifndef __CHOLESKY_H__
+#define __CHOLESKY_H__
+
+#include "matrix.h"
+
+// Largeur des blocs de la factorisation de Cholesky
+#define CHOLESKY_NB 128
+
+int decomposition_cholesky_en_place(Matrix m);
+Matrix decomposition_cholesky(Matrix m);
+E det_cholesky(Matrix l);
+E log_det_cholesky(Matrix l);
+Matrix resolution_cholesky(Matrix l, Matrix b);
+Matrix inversion_cholesky(Matrix l);
+
+#endif
@@ -0,0 +1,15 @@
+#ifndef __EIGEN_H__
+#define __EIGEN_H__
+
+#include "matrix.h"
+
+// Nombre maximal d'itérations QR par valeur propre
+#define QR_MAX_ITERATIONS 60
+
+void equilibrage(double * a, unsigned int n);
+void hessenberg(double * a, unsigned int n);
+int qr_hessenberg(double * h, unsigned int n, double * re, double * im);
+Matrix valeurs_propres(Matrix m);
+Matrix valeurs_propres_symetrique(Matrix m, Matrix * vecteurs);
+
+#endif
@@ -0,0 +1,36 @@
+#ifndef __GEMM_H__
+#define __GEMM_H__
+
+#include "matrix.h"
+
+// Tailles des blocs (en nombre d'éléments)
+// MC x KC : bloc de A empaqueté (doit tenir dans le cache L2)
+// KC x NC : bloc de B empaqueté (doit tenir dans le cache L3)
+// La tuile de registres MR x NR dépend du micro-noyau (voir kernels.h) :
+// MC et NC sont choisis multiples de toutes les tailles de tuile.
+#define GEMM_MC 144
+#define GEMM_KC 256
+#define GEMM_NC 4096
+
+// En dessous de ce nombre d'opérations (m * n * k), le produit est
+// calculé directement, sans empaquetage ni micro-noyau
+#define GEMM_DIRECT 128
+
+// C = alpha * A * B + beta * C
+// A est de taille m x k, B de taille k x n et C de taille m x n,
+// toutes stockées ligne par ligne avec les pas lda, ldb et ldc.
+// Si beta vaut 0, C n'est pas lu (il peut contenir n'importe quoi).
+void gemm(unsigned int m, unsigned int n, unsigned int k,
+          E alpha, const E * a, unsigned int lda,
+          const E * b, unsigned int ldb,
+          E beta, E * c, unsigned int ldc);
+
+// C = alpha * op(A) * op(B) + beta * C, où op(X) vaut X ou sa transposée
+// selon transa et transb. op(A) est de taille m x k : si transa vaut 1,
+// a est stockée comme une matrice k x m (de même pour b).
+void gemm_t(int transa, int transb, unsigned int m, unsigned int n, unsigned int k,
+            E alpha, const E * a, unsigned int lda,
+            const E * b, unsigned int ldb,
+            E beta, E * c, unsigned int ldc);
+
+#endif
@@ -0,0 +1,40 @@
+#ifndef __IMPLICIT_H__
+#define __IMPLICIT_H__
+
+#include "matrix.h"
+#include "sparse.h"
+
+typedef enum {
+    IMPLICITE_NULLE,
+    IMPLICITE_IDENTITE,
+    IMPLICITE_PERMUTATION
+} nature_implicite;
+
+// Matrice connue par sa seule structure, sans coefficients stockés : la
+// matrice nulle m x n, alpha I ou alpha P (n x n). La ligne i de P A est
+// la ligne perm[i] de A ; perm vaut NULL pour les deux autres natures.
+typedef struct implicit {
+    nature_implicite nature;
+    unsigned int nb_rows;
+    unsigned int nb_columns;
+    E alpha;
+    unsigned int * perm;
+} * Implicit;
+
+Implicit newNulle(unsigned int nb_rows, unsigned int nb_columns);
+Implicit newIdentite(unsigned int n, E alpha);
+Implicit newPermutation(unsigned int n, unsigned int * perm, E alpha);
+void deleteImplicit(Implicit m);
+Implicit new_implicit_copy(Implicit m);
+void printImplicit(Implicit m);
+Matrix implicit_to_dense(Implicit m);
+Sparse implicit_to_sparse(Implicit m);
+size_t implicit_nnz(Implicit m);
+Implicit implicit_transpose(Implicit m);
+Implicit implicit_inverse(Implicit m);
+Implicit implicit_multiplication(Implicit a, Implicit b);
+Matrix implicit_mult_dense(Implicit a, Matrix b);
+Matrix dense_mult_implicit(Matrix a, Implicit b);
+E implicit_det(Implicit m);
+
+#endif
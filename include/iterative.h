@@ -0,0 +1,34 @@
+#ifndef __ITERATIVE_H__
+#define __ITERATIVE_H__
+
+#include "matrix.h"
+#include "sparse.h"
+#include "precond.h"
+
+// Paramètres par défaut des solveurs itératifs
+#define ITERATIF_TOLERANCE 1e-6
+#define ITERATIF_MAX_ITERATIONS 1000
+#define GMRES_REDEMARRAGE 30
+
+// Opérateur A d'un système A x = b : matrice dense ou creuse (l'autre
+// pointeur vaut NULL)
+typedef struct {
+    Matrix dense;
+    Sparse creuse;
+} operateur;
+
+// Bilan d'une résolution itérative
+typedef struct {
+    unsigned int iterations;
+    double residu;          // ||b - A x|| / ||b|| à la sortie
+    int converge;           // vaut 1 si residu <= tolérance
+} bilan_iteratif;
+
+unsigned int operateur_taille(operateur a);
+Matrix gradient_conjugue(operateur a, Matrix b, Precond m, double tol, unsigned int max_iter,
+                         bilan_iteratif * bilan);
+Matrix bicgstab(operateur a, Matrix b, Precond m, double tol, unsigned int max_iter, bilan_iteratif * bilan);
+Matrix gmres(operateur a, Matrix b, Precond p, double tol, unsigned int max_iter, unsigned int redemarrage,
+             bilan_iteratif * bilan);
+
+#endif
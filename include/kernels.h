@@ -0,0 +1,37 @@
+#ifndef __KERNELS_H__
+#define __KERNELS_H__
+
+#include <stddef.h>
+#include "matrix.h"
+
+// Tuile de registres maximale parmi tous les micro-noyaux GEMM
+#define KERNEL_MR_MAX 8
+#define KERNEL_NR_MAX 32
+
+// Table des noyaux de calcul pour un jeu d'instructions donné
+typedef struct {
+    const char * nom;
+    unsigned int mr;    // lignes de la tuile du micro-noyau GEMM
+    unsigned int nr;    // colonnes de la tuile du micro-noyau GEMM
+
+    // z = x + y
+    void (*add)(size_t n, const E * x, const E * y, E * z);
+    // y = s * x
+    void (*scale)(size_t n, E s, const E * x, E * y);
+    // y = x
+    void (*copy)(size_t n, const E * x, E * y);
+    // b = transposée de a (a est de taille rows x cols)
+    void (*transpose)(unsigned int rows, unsigned int cols,
+                      const E * a, unsigned int lda, E * b, unsigned int ldb);
+    // tuile mr x nr de C = alpha * Ap * Bp + beta * C (voir gemm.c)
+    void (*gemm_micro)(unsigned int kc, E alpha, const E * ap, const E * bp,
+                       E beta, E * c, unsigned int ldc,
+                       unsigned int mr, unsigned int nr);
+} kernels_t;
+
+// Retourne les noyaux du jeu d'instructions le plus large disponible
+// (détecté avec CPUID au premier appel, forçable avec MATRIX_ISA=
+// scalar|sse2|avx2|avx512)
+const kernels_t * kernels(void);
+
+#endif
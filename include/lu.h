@@ -0,0 +1,27 @@
+#ifndef __LU_H__
+#define __LU_H__
+
+#include "matrix.h"
+
+// Factorisation PA = LU avec pivot partiel, stockée de façon compacte :
+// L (diagonale unité, non stockée) sous la diagonale de lu, U au-dessus
+typedef struct {
+    Matrix lu;
+    unsigned int * piv;     // à l'étape k, la ligne k a été échangée avec piv[k]
+    int signe;              // signe de la permutation (+1 ou -1)
+    int singuliere;         // vaut 1 si un pivot est nul
+} LU;
+
+LU decomposition_LU_en_place(Matrix m);
+LU decomposition_LU(Matrix m);
+void deleteLU(LU f);
+E det_LU(LU f);
+E log_det(Matrix m, int * signe);
+Matrix resolution_LU(LU f, Matrix b);
+Matrix inversion_LU(LU f);
+unsigned int * LU_permutation(LU f);
+Matrix LU_p(LU f);
+Matrix LU_l(LU f);
+Matrix LU_u(LU f);
+
+#endif
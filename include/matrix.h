@@ -2,6 +2,11 @@
 #define __MATRIX_H__
 
 typedef float E;
+
+// Les matrices stockées autrement qu'en dense (creuses, bandes, compactes,
+// implicites) sont affichées comme des matrices denses jusqu'à ce nombre
+// de coefficients, et par un simple résumé au-delà
+#define AFFICHAGE_MAX 1000000
 typedef struct matrix {
     E * mat;
     unsigned int nb_rows;
@@ -17,6 +22,7 @@ typedef struct {
 Matrix new_matrix_copy(Matrix m);
 Matrix newMatrix(unsigned int nb_rows, unsigned int nb_columns);
 Matrix newMatrix_tab(unsigned int nb_rows, unsigned int nb_columns, E * tab);
+Matrix newMatrix_buffer(unsigned int nb_rows, unsigned int nb_columns, E * tab);
 E getElt(Matrix m, unsigned int row, unsigned int column);
 void setElt(Matrix m, unsigned int row, unsigned int column, E val);
 void deleteMatrix(Matrix m);
@@ -28,6 +34,7 @@ Matrix transpose(Matrix m);
 void printMatrix(Matrix m);
 Matrix matrix_identite(unsigned int n);
 Matrix addition(Matrix m1, Matrix m2);
+E norme(Matrix m);
 Matrix mult_scalar(E s, Matrix m);
 Matrix multiplication(Matrix a, Matrix b);
 Matrix extraction(Matrix m, unsigned int row, unsigned int column);
@@ -45,6 +52,7 @@ void m_PLU(Matrix m);
 Matrix m_PLU_p(Matrix m);
 Matrix m_PLU_l(Matrix m);
 Matrix m_PLU_u(Matrix m);
-void valeurs_propres(Matrix m);
+Matrix m_QR_q(Matrix m);
+Matrix m_QR_r(Matrix m);
 
 #endif
@@ -0,0 +1,13 @@
+#ifndef __NOMBRE_H__
+#define __NOMBRE_H__
+
+#include <stddef.h>
+#include "matrix.h"
+
+// Lit en p une constante de la forme -?([0-9]*\.[0-9]+|[0-9]+\.?) et range
+// dans x sa valeur, arrondie exactement comme par strtod puis conversion
+// en E. Retourne le nombre de caractères lus, 0 s'il n'y a pas de
+// constante en p (x n'est alors pas modifié).
+size_t lire_nombre(const char * p, E * x);
+
+#endif
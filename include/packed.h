@@ -0,0 +1,65 @@
+#ifndef __PACKED_H__
+#define __PACKED_H__
+
+#include "matrix.h"
+
+// Taille des blocs diagonaux traités directement par les noyaux récursifs
+// (SYMM, TRMM, SYRK, Cholesky) : au-delà, les blocs hors diagonale passent
+// par GEMM
+#define PACKED_NB 64
+
+// Matrices carrées dont seul un triangle est stocké
+typedef enum {
+    PACK_SYMETRIQUE,
+    PACK_TRIANGULAIRE_INF,
+    PACK_TRIANGULAIRE_SUP
+} nature_packed;
+
+// Formats de stockage des n (n + 1) / 2 coefficients :
+// - PACK_INF : triangle inférieur ligne par ligne, (i, j) en
+//   i (i + 1) / 2 + j pour j <= i (symétrique ou triangulaire inférieure) ;
+// - PACK_SUP : triangle supérieur ligne par ligne, (i, j) en
+//   i n - i (i - 1) / 2 + j - i pour j >= i (symétrique ou triangulaire
+//   supérieure) ;
+// - PACK_RFP (rectangular full packed) : un triangle inférieur L (la
+//   matrice, sa partie inférieure ou sa transposée selon la nature) coupé
+//   en L11 (n1 = n / 2), L21 et L22 (n2 = n - n1), rangé dans un rectangle
+//   n2 x (2 n1 + 1) de pas ld = 2 n1 + 1 : L22 en bas à gauche des colonnes
+//   [0, n1], L11 transposée juste au-dessus (L11(i, j) en j ld + i + 1) et
+//   L21 dans les colonnes [n1 + 1, 2 n1]. Les trois blocs sont des
+//   matrices pleines avec un pas, que GEMM et TRSM traitent directement.
+typedef enum {
+    PACK_INF,
+    PACK_SUP,
+    PACK_RFP
+} format_packed;
+
+typedef struct packed {
+    nature_packed nature;
+    format_packed format;
+    unsigned int n;
+    E * val;
+} * Packed;
+
+Packed newPacked(unsigned int n, nature_packed nature, format_packed format);
+void deletePacked(Packed p);
+Packed new_packed_copy(Packed p);
+int packed_detecter(Matrix m, nature_packed * nature);
+Packed dense_to_packed(Matrix m, nature_packed nature, format_packed format);
+Matrix packed_to_dense(Packed p);
+Packed packed_convertir(Packed p, format_packed format);
+E packed_get(Packed p, unsigned int i, unsigned int j);
+void printPacked(Packed p);
+Packed packed_transpose(Packed p);
+Packed packed_mult_scalar(E k, Packed p);
+void packed_ajouter_diagonale(Packed p, E k);
+Packed packed_addition(Packed a, Packed b);
+Matrix packed_addition_dense(Packed a, Matrix b);
+Matrix packed_mult_dense(Packed p, Matrix b);
+Matrix dense_mult_packed(Matrix a, Packed p);
+Packed packed_syrk(Matrix a, int trans);
+Packed packed_cholesky(Packed p);
+E packed_det(Packed p);
+Matrix packed_resolution(Packed p, Matrix b);
+
+#endif
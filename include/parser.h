@@ -3,62 +3,93 @@
 
 #include "mpc.h"
 #include "matrix.h"
+#include "sparse.h"
+#include "structured.h"
+#include "implicit.h"
+#include "packed.h"
+#include "precond.h"
+#include "ast.h"
 
+// affectation rendue par l'évaluation, avant son entrée dans
+// l'environnement
 typedef struct s_assign {
-    char * symbol;
+    unsigned int symbole;
     struct s_expression * e;
-    struct s_assign * next;
 } * assign;
 
-// ligne d'une matrice
-typedef struct s_matrix_row {
-    unsigned int size;
-    float * row;
-} matrix_row;
-
-// structure de base permettant de générer ensuite une vraie matrice
-typedef struct s_matrix_raw {
-    unsigned int size;
-    struct s_matrix_row * raw;
-} matrix_raw;
+// Environnement : valeur de chaque variable, rangée à l'indice de son
+// symbole (voir interner), NULL si elle n'est pas définie. Une nouvelle
+// affectation remplace la valeur précédente, qui est libérée.
+typedef struct s_environnement {
+    unsigned int taille;
+    struct s_expression ** valeurs;
+} * Environnement;
 
 typedef struct s_expression {
     enum {
         UNKNOWN = 0,
         ERROR,
         MATRIX,
-        MATRIX_ROW,
-        MATRIX_RAW,
+        SPARSE,
+        STRUCTURED,
+        IMPLICIT,
+        PACKED,
+        PRECOND,
         SCALAR,
         ASSIGN,
         IDENT,
         CALL,
+        ARGS,
         NOTHING
     } type;
+    // 1 si la valeur appartient à l'environnement (lecture d'une
+    // variable) : elle n'est jamais libérée, et elle est copiée avant
+    // d'être modifiée
+    int emprunt;
     union {
         Matrix m;
-        matrix_row mr;
-        matrix_raw mra;
+        Sparse sp;
+        Structured st;
+        Implicit im;
+        Packed pk;
+        Precond pc;
         float s;
         assign a;
         char * str;
+        struct {
+            unsigned int size;
+            struct s_expression ** list;
+        } args;     // arguments d'un appel de fonction (au moins deux)
     } c;
 } * Expression;
 
+void afficher_expression(Expression e);
 void print_expression(Expression e);
 Expression new_expression();
 Expression new_expression_error(char * msg);
-mpc_val_t* val_to_expr(mpc_val_t* val);
-mpc_val_t* ident_to_expr(int n, mpc_val_t ** xs);
+Environnement newEnvironnement();
+void deleteEnvironnement(Environnement env);
+Expression env_chercher(Environnement env, unsigned int symbole);
+void env_definir(Environnement env, unsigned int symbole, Expression e);
+Expression evaluer(Node n, Environnement env);
+mpc_val_t* val_to_node(mpc_val_t* val);
+mpc_val_t* ident_to_node(mpc_val_t* val);
+mpc_val_t* call_to_node(int n, mpc_val_t ** xs);
+mpc_val_t *fold_sum_first(int n, mpc_val_t ** xs);
 mpc_val_t *fold_sum(int n, mpc_val_t ** xs);
+mpc_val_t *fold_prod_first(int n, mpc_val_t ** xs);
 mpc_val_t *fold_prod(int n, mpc_val_t ** xs);
 mpc_val_t *fold_assign(int n, mpc_val_t ** xs);
+mpc_val_t *fold_solve(int n, mpc_val_t ** xs);
 mpc_val_t *fold_mat_row_first(int n, mpc_val_t ** xs);
 mpc_val_t *fold_mat_row(int n, mpc_val_t ** xs);
 mpc_val_t *fold_mat_first(int n, mpc_val_t ** xs);
 mpc_val_t *fold_mat(int n, mpc_val_t ** xs);
 mpc_val_t *fold_value(int n, mpc_val_t ** xs);
+mpc_val_t *fold_args_first(int n, mpc_val_t ** xs);
+mpc_val_t *fold_args(int n, mpc_val_t ** xs);
 void catch_segfault(int signum);
+void run_command(char * line, mpc_parser_t * Input);
 void run_parser();
 
 #endif
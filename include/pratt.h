@@ -0,0 +1,13 @@
+#ifndef __PRATT_H__
+#define __PRATT_H__
+
+#include "ast.h"
+
+// Analyseur direct de la grammaire de la calculatrice (valeurs, + - * /,
+// appels, affectation, matrices [..;..] et A X = B), en une seule passe
+// et sans retour arrière : il ne construit que l'arbre rendu. Retourne
+// NULL si la ligne n'est pas reconnue ; l'analyseur mpc, plus lent, sert
+// alors à produire le message d'erreur.
+Node pratt_analyser(const char * ligne);
+
+#endif
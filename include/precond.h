@@ -0,0 +1,43 @@
+#ifndef __PRECOND_H__
+#define __PRECOND_H__
+
+#include <stddef.h>
+#include "sparse.h"
+
+typedef enum {
+    PRECOND_JACOBI,
+    PRECOND_ILU0,
+    PRECOND_IC0
+} type_precond;
+
+// Partie strictement triangulaire d'un facteur, au format CSR, en double
+typedef struct {
+    size_t nnz;
+    size_t * ptr;
+    unsigned int * col;
+    double * val;
+} facteur_creux;
+
+// Préconditionneur M ~ A d'un solveur itératif, calculé une fois pour
+// toutes et appliqué à chaque itération (z = M^-1 r) :
+//  - Jacobi : M = diag(A), seul diag est utilisé
+//  - ILU(0) : M = L U sur le motif de A, L unitaire (l) et U (u, diag)
+//  - IC(0) : M = L L^T sur le motif du triangle inférieur de A (l, diag)
+// diag contient les inverses des coefficients diagonaux de M, de U ou de L
+typedef struct precond {
+    type_precond type;
+    unsigned int n;
+    double * diag;
+    facteur_creux l;
+    facteur_creux u;
+} * Precond;
+
+Precond precond_jacobi(Sparse a);
+Precond precond_ilu0(Sparse a);
+Precond precond_ic0(Sparse a);
+void deletePrecond(Precond p);
+Precond new_precond_copy(Precond p);
+void printPrecond(Precond p);
+void appliquer_precond(Precond p, const double * r, double * z);
+
+#endif
@@ -0,0 +1,26 @@
+#ifndef __QR_H__
+#define __QR_H__
+
+#include "matrix.h"
+
+// Largeur des panneaux de la factorisation QR par blocs
+#define QR_NB 32
+
+// Factorisation A = QR par réflexions de Householder, stockée de façon
+// compacte : R sur et au-dessus de la diagonale de qr, les vecteurs de
+// Householder (premier coefficient 1, non stocké) en dessous.
+// Q = H_0 H_1 ... H_{k-1} avec H_j = I - tau[j] v_j v_j^T, k = min(m, n)
+typedef struct {
+    Matrix qr;
+    E * tau;
+} QR;
+
+QR decomposition_QR_en_place(Matrix m);
+QR decomposition_QR(Matrix m);
+void deleteQR(QR f);
+void appliquer_qt(QR f, Matrix b);
+Matrix QR_q(QR f);
+Matrix QR_r(QR f);
+Matrix resolution_QR(QR f, Matrix b);
+
+#endif
@@ -0,0 +1,8 @@
+#ifndef __SOLVE_H__
+#define __SOLVE_H__
+
+#include "matrix.h"
+
+Matrix resolution(Matrix a, Matrix b);
+
+#endif
@@ -0,0 +1,39 @@
+#ifndef __SPARSE_H__
+#define __SPARSE_H__
+
+#include <stddef.h>
+#include "matrix.h"
+
+// Une matrice saisie est stockée en creux si elle a au moins
+// SPARSE_TAILLE_MIN coefficients et au plus SPARSE_DENSITE_MAX de non nuls
+#define SPARSE_TAILLE_MIN 1024
+#define SPARSE_DENSITE_MAX 0.1
+
+// Matrice creuse au format CSR (compressed sparse row) : les coefficients
+// non nuls de la ligne i sont val[row_ptr[i] .. row_ptr[i+1][, dans les
+// colonnes col[...] rangées par ordre croissant
+typedef struct sparse {
+    unsigned int nb_rows;
+    unsigned int nb_columns;
+    size_t nnz;
+    size_t * row_ptr;
+    unsigned int * col;
+    E * val;
+} * Sparse;
+
+Sparse newSparse(unsigned int nb_rows, unsigned int nb_columns, size_t nnz);
+void deleteSparse(Sparse s);
+int sparse_preferable(unsigned int nb_rows, unsigned int nb_columns, size_t nnz);
+Sparse new_sparse_copy(Sparse s);
+Sparse dense_to_sparse(Matrix m);
+Matrix sparse_to_dense(Sparse s);
+void printSparse(Sparse s);
+Sparse sparse_transpose(Sparse s);
+Sparse sparse_mult_scalar(E k, Sparse s);
+Matrix sparse_mult_dense(Sparse a, Matrix b);
+Matrix dense_mult_sparse(Matrix a, Sparse b);
+Sparse sparse_multiplication(Sparse a, Sparse b);
+Sparse sparse_addition(Sparse a, Sparse b);
+Matrix sparse_addition_dense(Sparse a, Matrix b);
+
+#endif
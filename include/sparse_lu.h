@@ -0,0 +1,53 @@
+#ifndef __SPARSE_LU_H__
+#define __SPARSE_LU_H__
+
+#include <stddef.h>
+#include "matrix.h"
+#include "sparse.h"
+
+// Nombre de motifs dont l'analyse et la factorisation sont gardées en cache
+#define SPARSE_LU_CACHE 4
+
+// Pivotage partiel à seuil : le coefficient diagonal reste pivot s'il vaut
+// au moins SPARSE_LU_SEUIL_PIVOT fois le plus grand coefficient candidat
+#define SPARSE_LU_SEUIL_PIVOT 0.1
+
+// Analyse symbolique, qui ne dépend que du motif de A : ordre des colonnes
+// (degré minimum sur A + A^T) et copie du motif, pour reconnaître une
+// matrice de même structure
+typedef struct symbolique_lu {
+    unsigned int n;
+    unsigned int * q;           // q[k] : colonne de A éliminée à l'étape k
+    size_t nnz_a;
+    size_t * a_ptr;
+    unsigned int * a_col;
+    unsigned long signature;
+} * SymboliqueLU;
+
+// Factorisation P A Q = L U, par colonnes (CSC) et en double. Les indices
+// de ligne sont dans l'ordre des pivots : pinv[i] est l'étape à laquelle
+// la ligne i de A devient pivot. L est unitaire, sa diagonale en tête de
+// colonne ; les colonnes de U sont triées, le pivot en dernier.
+typedef struct sparse_lu {
+    SymboliqueLU s;
+    unsigned int * pinv;
+    size_t * l_ptr;
+    unsigned int * l_ind;
+    double * l_val;
+    size_t * u_ptr;
+    unsigned int * u_ind;
+    double * u_val;
+} * SparseLU;
+
+SymboliqueLU analyse_symbolique(Sparse a);
+void deleteSymboliqueLU(SymboliqueLU s);
+SparseLU factorisation_numerique(SymboliqueLU s, Sparse a);
+int refactorisation_numerique(SparseLU f, Sparse a);
+void deleteSparseLU(SparseLU f);
+Matrix resolution_sparse_LU(SparseLU f, Matrix b);
+Matrix resolution_creuse(Sparse a, Matrix b);
+
+// Libère le cache de resolution_creuse (à appeler avant de quitter)
+void sparse_lu_vider_cache(void);
+
+#endif
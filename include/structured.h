@@ -0,0 +1,56 @@
+#ifndef __STRUCTURED_H__
+#define __STRUCTURED_H__
+
+#include <stddef.h>
+#include "matrix.h"
+#include "sparse.h"
+
+// Une matrice saisie d'au moins SPARSE_TAILLE_MIN coefficients est stockée
+// en bande si elle est triangulaire et que sa bande n'occupe pas plus que
+// le triangle, ou si sa bande occupe au plus STRUCT_DENSITE_MAX de la
+// matrice (et est assez remplie pour battre CSR)
+#define STRUCT_DENSITE_MAX 0.5
+
+// Formes reconnues, déduites des largeurs de bande
+typedef enum {
+    STRUCT_DIAGONALE,
+    STRUCT_TRIANGULAIRE_INF,
+    STRUCT_TRIANGULAIRE_SUP,
+    STRUCT_TRIDIAGONALE,
+    STRUCT_BANDE
+} forme;
+
+// Matrice carrée n x n dont les coefficients non nuls vérifient
+// -kl <= j - i <= ku, stockée par lignes en bande : le coefficient (i, j)
+// est val[i * (kl + ku + 1) + j - i + kl], les positions hors de la
+// matrice valent 0. Diagonale (kl = ku = 0), tridiagonale (kl = ku = 1)
+// et triangulaires (kl = 0 ou ku = 0) sont des cas particuliers.
+typedef struct structured {
+    unsigned int n;
+    unsigned int kl;
+    unsigned int ku;
+    E * val;
+} * Structured;
+
+Structured newStructured(unsigned int n, unsigned int kl, unsigned int ku);
+void deleteStructured(Structured s);
+Structured new_structured_copy(Structured s);
+forme structured_forme(Structured s);
+int structured_preferable(unsigned int n, unsigned int kl, unsigned int ku, size_t nnz);
+void largeurs_bande(Matrix m, unsigned int * kl, unsigned int * ku);
+E structured_get(Structured s, unsigned int i, unsigned int j);
+Structured dense_to_structured(Matrix m, unsigned int kl, unsigned int ku);
+Matrix structured_to_dense(Structured s);
+Sparse structured_to_sparse(Structured s);
+void printStructured(Structured s);
+Structured structured_transpose(Structured s);
+Structured structured_mult_scalar(E k, Structured s);
+Matrix structured_mult_dense(Structured s, Matrix b);
+Matrix dense_mult_structured(Matrix a, Structured s);
+Structured structured_multiplication(Structured a, Structured b);
+Structured structured_addition(Structured a, Structured b);
+Matrix structured_addition_dense(Structured a, Matrix b);
+E structured_det(Structured s);
+Matrix structured_resolution(Structured s, Matrix b);
+
+#endif
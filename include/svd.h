@@ -0,0 +1,34 @@
+#ifndef __SVD_H__
+#define __SVD_H__
+
+#include "matrix.h"
+
+// Nombre maximal de balayages de Jacobi
+#define JACOBI_MAX_BALAYAGES 60
+
+// Nombre maximal d'itérations du mode tronqué, et nombre de vecteurs
+// supplémentaires itérés pour accélérer la convergence
+#define SVD_MAX_ITERATIONS 200
+#define SVD_SURECHANTILLON 8
+
+// Nombre d'itérations de puissance de la SVD aléatoire
+#define SVD_ITERATIONS_PUISSANCE 2
+
+// Décomposition A = U S V^T (forme réduite) : u est m x k, s le vecteur
+// colonne des k valeurs singulières décroissantes, v est n x k
+typedef struct {
+    Matrix u;
+    Matrix s;
+    Matrix v;
+} SVD;
+
+SVD decomposition_SVD(Matrix m, int vecteurs);
+SVD decomposition_SVD_tronquee(Matrix m, unsigned int k, int vecteurs);
+SVD decomposition_SVD_aleatoire(Matrix m, unsigned int k, unsigned int q, int vecteurs);
+Matrix recomposer_SVD(SVD f);
+void deleteSVD(SVD f);
+unsigned int rang(Matrix m);
+Matrix pseudo_inverse(Matrix m);
+E conditionnement(Matrix m);
+
+#endif
@@ -1,7 +1,16 @@
 #ifndef __SYSTEM_H__
 #define __SYSTEM_H__
 
+#include <stddef.h>
+
 // Affiche un message d'erreur
 void print_error(char * msg);
 
+// Allocations de nb éléments de taille octets (au moins un élément, pour
+// qu'un tableau vide reste un pointeur valide) : si la mémoire manque, le
+// programme s'arrête avec un message d'erreur
+void * allouer(size_t nb, size_t taille);
+void * allouer_zero(size_t nb, size_t taille);
+void * reallouer(void * p, size_t nb, size_t taille);
+
 #endif
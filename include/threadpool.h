@@ -0,0 +1,35 @@
+#ifndef __THREADPOOL_H__
+#define __THREADPOOL_H__
+
+#include <stddef.h>
+
+// Nombre minimal d'opérations flottantes avant de paralléliser un calcul :
+// en dessous, le coût de répartition dépasse le gain
+#define PARALLEL_SEUIL 65536
+
+// Traite les indices [debut, fin[ ; arg est partagé par toutes les tâches
+typedef void (*tache_f)(void * arg, size_t debut, size_t fin);
+
+// Réduction : retourne la contribution des indices [debut, fin[
+typedef double (*reduction_f)(void * arg, size_t debut, size_t fin);
+
+// Change le nombre de threads du pool (0 = nombre de coeurs)
+// À n'appeler que lorsqu'aucun calcul parallèle n'est en cours
+void pool_set_threads(unsigned int n);
+
+// Nombre de threads utilisés par le pool (y compris l'appelant)
+unsigned int pool_threads(void);
+
+// Arrête les threads du pool
+void pool_shutdown(void);
+
+// Exécute f sur [debut, fin[ découpé en morceaux d'au moins grain indices,
+// répartis entre les threads par vol de tâches. L'appelant participe au
+// calcul et ne rend la main qu'une fois tous les morceaux traités.
+// Si l'intervalle est plus petit que grain, tout est fait en série.
+void parallel_for(size_t debut, size_t fin, size_t grain, tache_f f, void * arg);
+
+// Comme parallel_for, mais somme les valeurs retournées par f
+double parallel_reduce(size_t debut, size_t fin, size_t grain, reduction_f f, void * arg);
+
+#endif
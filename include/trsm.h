@@ -0,0 +1,22 @@
+#ifndef __TRSM_H__
+#define __TRSM_H__
+
+#include "matrix.h"
+
+// Largeur des blocs diagonaux de la résolution triangulaire
+#define TRSM_NB 128
+
+// Partie de T utilisée
+typedef enum {
+    TRI_INF,    // triangulaire inférieure
+    TRI_SUP     // triangulaire supérieure
+} triangle;
+
+// Résout op(T) X = B en place (B est remplacée par X), où op(T) vaut T
+// ou sa transposée selon trans. T est de taille n x n (pas ldt), B de
+// taille n x m (pas ldb). Si unite vaut 1, la diagonale de T est
+// supposée valoir 1 et n'est pas lue.
+void trsm(triangle uplo, int trans, int unite, unsigned int n, unsigned int m,
+          const E * t, unsigned int ldt, E * b, unsigned int ldb);
+
+#endif
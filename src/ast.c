@@ -0,0 +1,175 @@
+#include <stdlib.h>
+#include <string.h>
+#include "system.h"
+#include "ast.h"
+
+// Noeud à nb fils, tous à NULL
+Node newNode(nature_noeud nature, unsigned int nb) {
+    Node n = allouer_zero(1, sizeof(struct s_node));
+    n->nature = nature;
+    n->nom = NULL;
+    n->symbole = 0;
+    n->s = 0;
+    n->m = NULL;
+    n->nb = nb;
+    n->fils = allouer_zero(nb, sizeof(Node));
+    return n;
+}
+
+Node newConstante(E s) {
+    Node n = newNode(NOEUD_CONSTANTE, 0);
+    n->s = s;
+    return n;
+}
+
+// Libère n et tous ses descendants
+void deleteNode(Node n) {
+    unsigned int i;
+
+    if (!n) return;
+    for (i = 0; i < n->nb; i++) deleteNode(n->fils[i]);
+    free(n->fils);
+    free(n->nom);
+    deleteMatrix(n->m);
+    free(n);
+}
+
+// Remplace n par la constante s
+static Node remplacer(Node n, E s) {
+    deleteNode(n);
+    return newConstante(s);
+}
+
+// Simplifie l'arbre avant l'évaluation : les opérations dont toutes les
+// opérandes sont des constantes sont calculées une fois pour toutes, dans
+// l'ordre où l'évaluation les ferait, et les sommes ou produits d'un seul
+// terme sont remplacés par ce terme
+Node simplifier(Node n) {
+    unsigned int i, constantes = 0;
+    Node f;
+    E s;
+
+    if (!n) return n;
+
+    for (i = 0; i < n->nb; i++) {
+        n->fils[i] = simplifier(n->fils[i]);
+        if (n->fils[i] && n->fils[i]->nature == NOEUD_CONSTANTE) constantes++;
+    }
+
+    switch (n->nature) {
+        case NOEUD_OPPOSE:
+            if (constantes) return remplacer(n, -n->fils[0]->s);
+            break;
+        case NOEUD_INVERSE:
+            if (constantes) return remplacer(n, 1 / n->fils[0]->s);
+            break;
+        case NOEUD_SOMME:
+        case NOEUD_PRODUIT:
+            if (n->nb == 1) {
+                f = n->fils[0];
+                n->nb = 0;
+                deleteNode(n);
+                return f;
+            }
+            if (constantes == n->nb) {
+                s = n->fils[0]->s;
+                for (i = 1; i < n->nb; i++) {
+                    if (n->nature == NOEUD_SOMME) s += n->fils[i]->s;
+                    else s *= n->fils[i]->s;
+                }
+                return remplacer(n, s);
+            }
+            break;
+        default:
+            break;
+    }
+
+    return n;
+}
+
+
+// Taille de départ de la table des symboles
+#define SYMBOLES_TAILLE 64
+
+// Noms de variables rencontrés à l'analyse, numérotés dans l'ordre
+// d'apparition, et table de hachage (adressage ouvert, sondage linéaire)
+// qui donne le numéro d'un nom. Les deux tableaux par numéro ont la taille
+// de la table, remplie au plus aux trois quarts.
+static struct {
+    unsigned int nb, taille;    // taille : puissance de deux
+    unsigned int * t;           // numéro + 1 du nom rangé, 0 si la case est libre
+    unsigned int * hash;
+    char ** noms;
+} symboles;
+
+// Hachage FNV-1a des n premiers caractères de nom
+static unsigned int hacher(const char * nom, size_t n) {
+    unsigned int h = 2166136261u;
+    size_t i;
+
+    for (i = 0; i < n; i++) h = (h ^ (unsigned char) nom[i]) * 16777619u;
+    return h;
+}
+
+// Case du nom (de longueur n), ou case libre où le ranger
+static unsigned int * symbole_case(const char * nom, size_t n, unsigned int h) {
+    unsigned int i = h & (symboles.taille - 1), s;
+
+    while ((s = symboles.t[i])
+           && (symboles.hash[s - 1] != h || strncmp(symboles.noms[s - 1], nom, n) || symboles.noms[s - 1][n])) {
+        i = (i + 1) & (symboles.taille - 1);
+    }
+    return symboles.t + i;
+}
+
+// Numéro du nom formé des n premiers caractères de nom, qui est ajouté à
+// la table s'il n'y est pas encore. La table est doublée quand elle est
+// remplie aux trois quarts.
+unsigned int interner(const char * nom, size_t n) {
+    unsigned int h = hacher(nom, n), i, * c;
+
+    if (!symboles.taille) {
+        symboles.taille = SYMBOLES_TAILLE;
+        symboles.t = allouer_zero(symboles.taille, sizeof(unsigned int));
+        symboles.hash = allouer(symboles.taille, sizeof(unsigned int));
+        symboles.noms = allouer(symboles.taille, sizeof(char *));
+    }
+
+    c = symbole_case(nom, n, h);
+    if (*c) return *c - 1;
+
+    if (4 * (symboles.nb + 1) > 3 * symboles.taille) {
+        free(symboles.t);
+        symboles.taille *= 2;
+        symboles.t = allouer_zero(symboles.taille, sizeof(unsigned int));
+        symboles.hash = reallouer(symboles.hash, symboles.taille, sizeof(unsigned int));
+        symboles.noms = reallouer(symboles.noms, symboles.taille, sizeof(char *));
+        for (i = 0; i < symboles.nb; i++) {
+            *symbole_case(symboles.noms[i], strlen(symboles.noms[i]), symboles.hash[i]) = i + 1;
+        }
+        c = symbole_case(nom, n, h);
+    }
+
+    i = symboles.nb++;
+    symboles.hash[i] = h;
+    symboles.noms[i] = allouer(n + 1, 1);
+    memcpy(symboles.noms[i], nom, n);
+    symboles.noms[i][n] = 0;
+    *c = i + 1;
+
+    return i;
+}
+
+const char * nom_symbole(unsigned int symbole) {
+    return symboles.noms[symbole];
+}
+
+void liberer_symboles(void) {
+    unsigned int i;
+
+    for (i = 0; i < symboles.nb; i++) free(symboles.noms[i]);
+    free(symboles.noms);
+    free(symboles.hash);
+    free(symboles.t);
+    memset(&symboles, 0, sizeof(symboles));
+}
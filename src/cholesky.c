@@ -0,0 +1,145 @@
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+#include "matrix.h"
+#include "gemm.h"
+#include "trsm.h"
+#include "threadpool.h"
+#include "cholesky.h"
+
+// Bloc L21 : résout X L11^T = A21 ligne par ligne
+typedef struct {
+    E * a;
+    unsigned int n;
+    unsigned int k0;
+    unsigned int k1;
+} args_cholesky;
+
+static void l21_morceau(void * arg, size_t debut, size_t fin) {
+    args_cholesky * c = arg;
+    unsigned int n = c->n, j, p;
+    E * lj, * xi, s;
+    size_t i;
+
+    for (i = debut; i < fin; i++) {
+        xi = c->a + i * n;
+        for (j = c->k0; j < c->k1; j++) {
+            lj = c->a + (size_t) j * n;
+            s = xi[j];
+            for (p = c->k0; p < j; p++) s -= xi[p] * lj[p];
+            xi[j] = s / lj[j];
+        }
+    }
+}
+
+// Factorise le bloc diagonal [k0, k1[ ; retourne 0 si un pivot n'est pas
+// strictement positif (matrice non définie positive)
+static int bloc_diagonal(E * a, unsigned int n, unsigned int k0, unsigned int k1) {
+    unsigned int i, j, p;
+    E * li, * lj, d;
+
+    for (j = k0; j < k1; j++) {
+        lj = a + (size_t) j * n;
+        if (!(lj[j] > 0)) return 0;
+        d = sqrtf(lj[j]);
+        lj[j] = d;
+        for (i = j + 1; i < k1; i++) a[(size_t) i * n + j] /= d;
+        for (i = j + 1; i < k1; i++) {
+            li = a + (size_t) i * n;
+            for (p = j + 1; p <= i; p++) li[p] -= li[j] * a[(size_t) p * n + j];
+        }
+    }
+
+    return 1;
+}
+
+// Factorisation de Cholesky A = L L^T par blocs (variante « right-looking »),
+// en place : seul le triangle inférieur de m est lu et remplacé par L, le
+// triangle supérieur strict est remis à zéro. Pour chaque bloc de colonnes,
+//   1. L11 = chol(A11)
+//   2. L21 = A21 L11^-T
+//   3. A22 -= L21 L21^T (triangle inférieur seulement, par GEMM)
+// Retourne 0 si m n'est pas définie positive (m est alors inutilisable).
+// prec : m carrée et symétrique
+int decomposition_cholesky_en_place(Matrix m) {
+    unsigned int n = m->nb_rows, k0, k1, j0, jw, i;
+    E * a = m->mat;
+    args_cholesky c;
+
+    c.a = a;
+    c.n = n;
+
+    for (k0 = 0; k0 < n; k0 = k1) {
+        k1 = n - k0 < CHOLESKY_NB ? n : k0 + CHOLESKY_NB;
+
+        if (!bloc_diagonal(a, n, k0, k1)) return 0;
+        if (k1 == n) break;
+
+        c.k0 = k0;
+        c.k1 = k1;
+        parallel_for(k1, n, PARALLEL_SEUIL / ((size_t) (k1 - k0) * (k1 - k0)) + 1, l21_morceau, &c);
+
+        for (j0 = k1; j0 < n; j0 += CHOLESKY_NB) {
+            jw = n - j0 < CHOLESKY_NB ? n - j0 : CHOLESKY_NB;
+            gemm_t(0, 1, n - j0, jw, k1 - k0,
+                   -1, a + (size_t) j0 * n + k0, n,
+                   a + (size_t) j0 * n + k0, n,
+                   1, a + (size_t) j0 * n + j0, n);
+        }
+    }
+
+    for (i = 0; i + 1 < n; i++) memset(a + (size_t) i * n + i + 1, 0, (n - i - 1) * sizeof(E));
+
+    return 1;
+}
+
+// Retourne le facteur L de m, ou NULL si m n'est pas définie positive
+// prec : m carrée et symétrique
+Matrix decomposition_cholesky(Matrix m) {
+    Matrix l = new_matrix_copy(m);
+
+    if (!decomposition_cholesky_en_place(l)) {
+        deleteMatrix(l);
+        return NULL;
+    }
+
+    return l;
+}
+
+// det(A) = produit des l_ii au carré
+E det_cholesky(Matrix l) {
+    unsigned int i, n = l->nb_rows;
+    double d = 1;
+
+    for (i = 0; i < n; i++) d *= l->mat[(size_t) i * n + i];
+
+    return d * d;
+}
+
+// log(det(A)) = 2 * somme des log(l_ii) (det(A) est positif)
+E log_det_cholesky(Matrix l) {
+    unsigned int i, n = l->nb_rows;
+    double s = 0;
+
+    for (i = 0; i < n; i++) s += log(l->mat[(size_t) i * n + i]);
+
+    return 2 * s;
+}
+
+// Résout A X = B : L Y = B puis L^T X = Y
+Matrix resolution_cholesky(Matrix l, Matrix b) {
+    unsigned int n = l->nb_rows, m = b->nb_columns;
+    Matrix x = new_matrix_copy(b);
+
+    trsm(TRI_INF, 0, 0, n, m, l->mat, n, x->mat, m);
+    trsm(TRI_INF, 1, 0, n, m, l->mat, n, x->mat, m);
+
+    return x;
+}
+
+Matrix inversion_cholesky(Matrix l) {
+    Matrix id = matrix_identite(l->nb_rows);
+    Matrix r = resolution_cholesky(l, id);
+    deleteMatrix(id);
+    return r;
+}
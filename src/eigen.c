@@ -0,0 +1,425 @@
+#include <float.h>
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+#include "system.h"
+#include "matrix.h"
+#include "threadpool.h"
+#include "eigen.h"
+
+#define A(i, j) a[(size_t) (i) * n + (j)]
+
+// Équilibrage (comme LAPACK dgebal, sans les permutations) : chaque
+// ligne et la colonne correspondante sont multipliées par une puissance
+// de 2 f et 1/f (donc sans erreur d'arrondi, et par similitude) jusqu'à
+// ce que leurs normes soient du même ordre. Cela réduit la norme de la
+// matrice et améliore la précision des valeurs propres.
+void equilibrage(double * a, unsigned int n) {
+    // bornes évitant tout dépassement de capacité des facteurs
+    const double petit = DBL_MIN / DBL_EPSILON, grand = 1 / petit;
+    unsigned int i, j;
+    double c, r, ca, ra, f, g, s;
+    int change = 1;
+
+    while (change) {
+        change = 0;
+        for (i = 0; i < n; i++) {
+            // normes euclidiennes de la colonne et de la ligne i,
+            // plus grands coefficients en valeur absolue
+            c = r = ca = ra = 0;
+            for (j = 0; j < n; j++) {
+                c += A(j, i) * A(j, i);
+                r += A(i, j) * A(i, j);
+                if (fabs(A(j, i)) > ca) ca = fabs(A(j, i));
+                if (fabs(A(i, j)) > ra) ra = fabs(A(i, j));
+            }
+            c = sqrt(c);
+            r = sqrt(r);
+            if (c == 0 || r == 0) continue;
+
+            s = c + r;
+            f = 1;
+            // colonne trop petite devant la ligne : on multiplie par 2
+            g = r / 2;
+            while (c < g && fmax(f, fmax(c, ca)) < grand && fmin(r, fmin(g, ra)) > petit) {
+                f *= 2;
+                c *= 2;
+                ca *= 2;
+                r /= 2;
+                g /= 2;
+                ra /= 2;
+            }
+            // colonne trop grande devant la ligne : on divise par 2
+            g = c / 2;
+            while (g >= r && fmax(r, ra) < grand && fmin(fmin(f, c), fmin(g, ca)) > petit) {
+                f /= 2;
+                c /= 2;
+                g /= 2;
+                ca /= 2;
+                r *= 2;
+                ra *= 2;
+            }
+
+            // on ne garde que les mises à l'échelle qui réduisent
+            // sensiblement la somme des normes
+            if (c + r >= 0.95 * s) continue;
+            change = 1;
+            g = 1 / f;
+            for (j = 0; j < n; j++) A(i, j) *= g;
+            for (j = 0; j < n; j++) A(j, i) *= f;
+        }
+    }
+}
+
+#undef A
+
+// Arguments des mises à jour de Householder réparties sur le pool
+typedef struct {
+    double * a;
+    unsigned int n;
+    unsigned int k;     // les lignes/colonnes [k, n[ sont concernées
+    const double * v;   // vecteur de Householder (indices [k, n[)
+    double * w;         // produit intermédiaire
+} args_householder;
+
+// w[j] = somme_i v[i] a[i][j] pour les colonnes [debut, fin[
+static void gauche_produit(void * arg, size_t debut, size_t fin) {
+    args_householder * h = arg;
+    unsigned int n = h->n, i;
+    size_t j;
+
+    for (j = debut; j < fin; j++) h->w[j] = 0;
+    for (i = h->k; i < n; i++) {
+        const double * ai = h->a + (size_t) i * n;
+        double vi = h->v[i];
+        for (j = debut; j < fin; j++) h->w[j] += vi * ai[j];
+    }
+}
+
+// a[i][j] -= 2 v[i] w[j] pour les lignes [debut, fin[
+static void gauche_maj(void * arg, size_t debut, size_t fin) {
+    args_householder * h = arg;
+    unsigned int n = h->n, j;
+    size_t i;
+
+    for (i = debut; i < fin; i++) {
+        double * ai = h->a + i * n;
+        double vi = 2 * h->v[i];
+        for (j = h->k - 1; j < n; j++) ai[j] -= vi * h->w[j];
+    }
+}
+
+// a[i][.] -= 2 (a[i][.] . v) v pour les lignes [debut, fin[
+static void droite_maj(void * arg, size_t debut, size_t fin) {
+    args_householder * h = arg;
+    unsigned int n = h->n, j;
+    size_t i;
+    double s;
+
+    for (i = debut; i < fin; i++) {
+        double * ai = h->a + i * n;
+        s = 0;
+        for (j = h->k; j < n; j++) s += ai[j] * h->v[j];
+        s *= 2;
+        for (j = h->k; j < n; j++) ai[j] -= s * h->v[j];
+    }
+}
+
+// Réduction à la forme de Hessenberg supérieure par réflexions de
+// Householder : pour chaque colonne k, une réflexion annule les éléments
+// sous la sous-diagonale, appliquée à gauche puis à droite (similitude)
+void hessenberg(double * a, unsigned int n) {
+    unsigned int i, k;
+    double alpha, norme, * v = allouer(n, sizeof(double)), * w = allouer(n, sizeof(double));
+    args_householder h;
+    size_t grain = PARALLEL_SEUIL / (4 * (size_t) (n ? n : 1)) + 1;
+
+    h.a = a;
+    h.n = n;
+    h.v = v;
+    h.w = w;
+
+    for (k = 0; k + 2 < n; k++) {
+        // x = a[k+1:n][k], v = x - alpha e1 normalisé
+        norme = 0;
+        for (i = k + 1; i < n; i++) norme += a[(size_t) i * n + k] * a[(size_t) i * n + k];
+        norme = sqrt(norme);
+        if (norme == 0) continue;
+        alpha = a[(size_t) (k + 1) * n + k] > 0 ? -norme : norme;
+        for (i = k + 1; i < n; i++) v[i] = a[(size_t) i * n + k];
+        v[k + 1] -= alpha;
+        norme = 0;
+        for (i = k + 1; i < n; i++) norme += v[i] * v[i];
+        norme = sqrt(norme);
+        if (norme == 0) continue;
+        for (i = k + 1; i < n; i++) v[i] /= norme;
+
+        // A = (I - 2 v v^T) A sur les lignes [k+1, n[ et colonnes [k, n[
+        h.k = k + 1;
+        parallel_for(k, n, grain, gauche_produit, &h);
+        parallel_for(k + 1, n, grain, gauche_maj, &h);
+
+        // A = A (I - 2 v v^T) sur les colonnes [k+1, n[
+        parallel_for(0, n, grain, droite_maj, &h);
+
+        // la colonne k est désormais alpha e1
+        a[(size_t) (k + 1) * n + k] = alpha;
+        for (i = k + 2; i < n; i++) a[(size_t) i * n + k] = 0;
+    }
+
+    free(v);
+    free(w);
+}
+
+#define H(i, j) h[(size_t) (i) * n + (j)]
+
+// Valeurs propres du bloc 2 x 2 [a b ; c d], rangées dans re et im
+static void valeurs_propres_2x2(double a, double b, double c, double d, double * re, double * im) {
+    double p = (a - d) / 2, bc = b * c, disc, z;
+
+    disc = p * p + bc;
+    if (disc >= 0) {
+        // deux valeurs réelles : d + z et d - bc / z, avec z du signe de p
+        // pour éviter une soustraction de nombres proches
+        z = p + (p >= 0 ? sqrt(disc) : -sqrt(disc));
+        re[0] = d + z;
+        re[1] = z != 0 ? d - bc / z : d;
+        im[0] = im[1] = 0;
+    } else {
+        // paire de valeurs conjuguées
+        re[0] = re[1] = d + p;
+        im[0] = sqrt(-disc);
+        im[1] = -im[0];
+    }
+}
+
+// Applique le réflecteur I - t v v^T (v[0] = 1, nr = 2 ou 3 composantes)
+// aux lignes k..k+nr-1 (colonnes [k, fin]) et aux colonnes k..k+nr-1
+// (lignes [l, min(k + 3, fin)]) de h
+static void reflecteur(double * h, unsigned int n, unsigned int l, unsigned int fin, unsigned int k,
+                       unsigned int nr, const double * v, double t) {
+    unsigned int i, j, imax = k + 3 < fin ? k + 3 : fin;
+    double s;
+
+    for (j = k; j <= fin; j++) {
+        s = H(k, j) + v[1] * H(k + 1, j);
+        if (nr == 3) s += v[2] * H(k + 2, j);
+        s *= t;
+        H(k, j) -= s;
+        H(k + 1, j) -= s * v[1];
+        if (nr == 3) H(k + 2, j) -= s * v[2];
+    }
+    for (i = l; i <= imax; i++) {
+        s = H(i, k) + v[1] * H(i, k + 1);
+        if (nr == 3) s += v[2] * H(i, k + 2);
+        s *= t;
+        H(i, k) -= s;
+        H(i, k + 1) -= s * v[1];
+        if (nr == 3) H(i, k + 2) -= s * v[2];
+    }
+}
+
+// Algorithme QR de Francis à double décalage implicite sur une matrice de
+// Hessenberg supérieure h (détruite), dans l'esprit de LAPACK dlahqr :
+// la fenêtre active [l, fin] est réduite jusqu'à isoler un bloc 1 x 1 ou
+// 2 x 2 en bas, dont on lit les valeurs propres. Chaque pas crée un
+// renflement à partir des deux décalages (valeurs propres du bloc 2 x 2
+// inférieur) et le chasse le long de la diagonale par des réflecteurs de
+// taille 3. Les valeurs propres sont rangées dans re et im. Retourne 0 si
+// l'algorithme n'a pas convergé.
+int qr_hessenberg(double * h, unsigned int n, double * re, double * im) {
+    const double ulp = DBL_EPSILON, petit = DBL_MIN * (n / ulp);
+    int fin, l, m, k, its, nr, converge;
+    double s, tst, ab, ba, aa, bb, h11, h12, h21, h22, tr, det, disc;
+    double r1, i1, r2, i2, hmm, v[3] = {0, 0, 0}, alpha, norme, beta, t;
+
+    for (fin = (int) n - 1; fin >= 0; fin = l - 1) {
+        converge = 0;
+        for (its = 0; its <= QR_MAX_ITERATIONS; its++) {
+            // recherche d'un sous-diagonal négligeable : H(l, l-1)
+            for (l = fin; l > 0; l--) {
+                if (fabs(H(l, l - 1)) <= petit) break;
+                tst = fabs(H(l - 1, l - 1)) + fabs(H(l, l));
+                if (tst == 0) {
+                    if (l >= 2) tst += fabs(H(l - 1, l - 2));
+                    if (l < fin) tst += fabs(H(l + 1, l));
+                }
+                if (fabs(H(l, l - 1)) <= ulp * tst) {
+                    // critère relatif plus fin (Ahues et Tisseur)
+                    ab = fmax(fabs(H(l, l - 1)), fabs(H(l - 1, l)));
+                    ba = fmin(fabs(H(l, l - 1)), fabs(H(l - 1, l)));
+                    aa = fmax(fabs(H(l, l)), fabs(H(l - 1, l - 1) - H(l, l)));
+                    bb = fmin(fabs(H(l, l)), fabs(H(l - 1, l - 1) - H(l, l)));
+                    s = aa + ab;
+                    if (ba * (ab / s) <= fmax(petit, ulp * (bb * (aa / s)))) break;
+                }
+            }
+            if (l > 0) H(l, l - 1) = 0;
+
+            // un bloc 1 x 1 ou 2 x 2 s'est détaché
+            if (l >= fin - 1) {
+                converge = 1;
+                break;
+            }
+
+            // deux décalages : valeurs propres du bloc 2 x 2 inférieur, ou
+            // décalages exceptionnels pour sortir d'un cycle
+            if (its && its % 10 == 0) {
+                if (its % 20) {
+                    s = fabs(H(fin, fin - 1)) + fabs(H(fin - 1, fin - 2));
+                    h11 = 0.75 * s + H(fin, fin);
+                } else {
+                    s = fabs(H(l + 1, l)) + fabs(H(l + 2, l + 1));
+                    h11 = 0.75 * s + H(l, l);
+                }
+                h12 = -0.4375 * s;
+                h21 = s;
+                h22 = h11;
+            } else {
+                h11 = H(fin - 1, fin - 1);
+                h21 = H(fin, fin - 1);
+                h12 = H(fin - 1, fin);
+                h22 = H(fin, fin);
+            }
+            s = fabs(h11) + fabs(h12) + fabs(h21) + fabs(h22);
+            r1 = i1 = r2 = i2 = 0;
+            if (s != 0) {
+                h11 /= s;
+                h21 /= s;
+                h12 /= s;
+                h22 /= s;
+                tr = (h11 + h22) / 2;
+                det = (h11 - tr) * (h22 - tr) - h12 * h21;
+                disc = sqrt(fabs(det));
+                if (det >= 0) {
+                    // décalages complexes conjugués
+                    r1 = r2 = tr * s;
+                    i1 = disc * s;
+                    i2 = -i1;
+                } else {
+                    // décalages réels : on prend deux fois le plus proche
+                    // de h22
+                    r1 = tr + disc;
+                    r2 = tr - disc;
+                    r1 = r2 = (fabs(r1 - h22) <= fabs(r2 - h22) ? r1 : r2) * s;
+                }
+            }
+
+            // recherche de deux sous-diagonaux consécutifs petits : le
+            // renflement peut démarrer en m au lieu de l
+            for (m = fin - 2; m >= l; m--) {
+                hmm = H(m, m);
+                s = fabs(hmm - r2) + fabs(i2) + fabs(H(m + 1, m));
+                h21 = H(m + 1, m) / s;
+                // première colonne de (H - r1 I)(H - r2 I), à un facteur près
+                v[0] = h21 * H(m, m + 1) + (hmm - r1) * ((hmm - r2) / s) - i1 * (i2 / s);
+                v[1] = h21 * (hmm + H(m + 1, m + 1) - r1 - r2);
+                v[2] = h21 * H(m + 2, m + 1);
+                s = fabs(v[0]) + fabs(v[1]) + fabs(v[2]);
+                v[0] /= s;
+                v[1] /= s;
+                v[2] /= s;
+                if (m == l) break;
+                if (fabs(H(m, m - 1)) * (fabs(v[1]) + fabs(v[2]))
+                    <= ulp * fabs(v[0]) * (fabs(H(m - 1, m - 1)) + fabs(hmm) + fabs(H(m + 1, m + 1))))
+                    break;
+            }
+
+            // pas QR double : chasse du renflement de m à fin
+            for (k = m; k < fin; k++) {
+                nr = fin - k + 1 < 3 ? fin - k + 1 : 3;
+                if (k > m) {
+                    v[0] = H(k, k - 1);
+                    v[1] = H(k + 1, k - 1);
+                    if (nr == 3) v[2] = H(k + 2, k - 1);
+                }
+                // réflecteur (I - t u u^T) x = beta e1, u = (1, v[1], v[2])
+                alpha = v[0];
+                norme = nr == 3 ? hypot(v[1], v[2]) : fabs(v[1]);
+                if (norme == 0) continue;
+                beta = hypot(alpha, norme);
+                if (alpha >= 0) beta = -beta;
+                t = (beta - alpha) / beta;
+                v[1] /= alpha - beta;
+                if (nr == 3) v[2] /= alpha - beta;
+                if (k > m) {
+                    H(k, k - 1) = beta;
+                    H(k + 1, k - 1) = 0;
+                    if (nr == 3) H(k + 2, k - 1) = 0;
+                } else if (m > l) {
+                    // équivaut à changer le signe de H(k, k-1), mais reste
+                    // correct quand v[1] et v[2] sont négligeables
+                    H(k, k - 1) *= 1 - t;
+                }
+                reflecteur(h, n, l, fin, k, nr, v, t);
+            }
+        }
+
+        if (!converge) return 0;
+        if (l == fin) {
+            re[fin] = H(fin, fin);
+            im[fin] = 0;
+        } else {
+            valeurs_propres_2x2(H(fin - 1, fin - 1), H(fin - 1, fin), H(fin, fin - 1), H(fin, fin),
+                                re + fin - 1, im + fin - 1);
+        }
+    }
+
+    return 1;
+}
+
+#undef H
+
+// Ordre décroissant des parties réelles, puis des parties imaginaires
+static int compare_complexes(const void * a, const void * b) {
+    const double * x = a, * y = b;
+    if (x[0] != y[0]) return x[0] < y[0] ? 1 : -1;
+    if (x[1] != y[1]) return x[1] < y[1] ? 1 : -1;
+    return 0;
+}
+
+// Valeurs propres d'une matrice carrée quelconque : équilibrage, réduction
+// de Hessenberg puis algorithme QR. Retourne un vecteur colonne si toutes
+// les valeurs propres sont réelles, sinon une matrice n x 2 (partie
+// réelle, partie imaginaire) ; NULL si l'algorithme ne converge pas.
+// Les matrices symétriques passent par valeurs_propres_symetrique.
+// prec : m carrée
+Matrix valeurs_propres(Matrix m) {
+    unsigned int n = m->nb_rows, i, complexes = 0;
+    double * h, * re, * im, * v;
+    Matrix r = NULL;
+
+    if (isSymetric(m)) return valeurs_propres_symetrique(m, NULL);
+
+    h = allouer((size_t) n * n, sizeof(double));
+    re = allouer(n, sizeof(double));
+    im = allouer(n, sizeof(double));
+
+    for (i = 0; i < n * n; i++) h[i] = m->mat[i];
+
+    equilibrage(h, n);
+    hessenberg(h, n);
+
+    if (qr_hessenberg(h, n, re, im)) {
+        v = allouer(2 * (size_t) n, sizeof(double));
+        for (i = 0; i < n; i++) {
+            v[2 * i] = re[i];
+            v[2 * i + 1] = im[i];
+            if (im[i] != 0) complexes = 1;
+        }
+        qsort(v, n, 2 * sizeof(double), compare_complexes);
+
+        r = newMatrix(n, complexes ? 2 : 1);
+        for (i = 0; i < n; i++) {
+            setElt(r, i, 0, v[2 * i]);
+            if (complexes) setElt(r, i, 1, v[2 * i + 1]);
+        }
+        free(v);
+    }
+
+    free(h);
+    free(re);
+    free(im);
+
+    return r;
+}
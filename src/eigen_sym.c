@@ -0,0 +1,674 @@
+#include <float.h>
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+#include "system.h"
+#include "matrix.h"
+#include "threadpool.h"
+#include "eigen.h"
+
+// Taille en dessous de laquelle diviser pour régner passe la main à QL
+#define DC_FEUILLE 32
+
+// Nombre maximal d'itérations pour une racine de l'équation séculaire
+#define SECULAIRE_MAX_ITERATIONS 500
+
+#define SIGNE(a, b) ((b) >= 0 ? fabs(a) : -fabs(a))
+
+
+// ---------------------------------------------------------------------
+// Produits de matrices en double précision (réduction et fusion)
+// ---------------------------------------------------------------------
+
+typedef struct {
+    const double * a;   // n x k
+    const double * b;   // k x m
+    double * c;         // n x m
+    unsigned int k;
+    unsigned int m;
+} args_produit;
+
+static void produit_morceau(void * arg, size_t debut, size_t fin) {
+    args_produit * p = arg;
+    unsigned int l, j;
+    size_t i;
+
+    for (i = debut; i < fin; i++) {
+        double * ci = p->c + i * p->m;
+        const double * ai = p->a + i * p->k;
+        memset(ci, 0, p->m * sizeof(double));
+        for (l = 0; l < p->k; l++) {
+            const double * bl = p->b + (size_t) l * p->m;
+            double x = ai[l];
+            if (x == 0) continue;
+            for (j = 0; j < p->m; j++) ci[j] += x * bl[j];
+        }
+    }
+}
+
+// C = A B avec A de taille n x k et B de taille k x m (lignes réparties)
+static void produit_double(unsigned int n, unsigned int k, unsigned int m,
+                           const double * a, const double * b, double * c) {
+    args_produit p = { a, b, c, k, m };
+    parallel_for(0, n, PARALLEL_SEUIL / (2 * (size_t) k * m + 1) + 1, produit_morceau, &p);
+}
+
+
+// ---------------------------------------------------------------------
+// Réduction tridiagonale
+// ---------------------------------------------------------------------
+
+typedef struct {
+    double * a;
+    unsigned int n;
+    unsigned int k;     // bloc [k, n[ concerné
+    const double * v;
+    double * p;
+} args_tridiag;
+
+// p[i] = 2 (A v)[i] pour les lignes [debut, fin[
+static void tridiag_produit(void * arg, size_t debut, size_t fin) {
+    args_tridiag * t = arg;
+    unsigned int n = t->n, j;
+    size_t i;
+    double s;
+
+    for (i = debut; i < fin; i++) {
+        const double * ai = t->a + i * n;
+        s = 0;
+        for (j = t->k; j < n; j++) s += ai[j] * t->v[j];
+        t->p[i] = 2 * s;
+    }
+}
+
+// A -= v q^T + q v^T pour les lignes [debut, fin[ (q est rangé dans p)
+static void tridiag_maj(void * arg, size_t debut, size_t fin) {
+    args_tridiag * t = arg;
+    unsigned int n = t->n, j;
+    size_t i;
+
+    for (i = debut; i < fin; i++) {
+        double * ai = t->a + i * n;
+        double vi = t->v[i], qi = t->p[i];
+        for (j = t->k; j < n; j++) ai[j] -= vi * t->p[j] + qi * t->v[j];
+    }
+}
+
+// Q[k:, k:] = (I - 2 v v^T) Q[k:, k:] : w = v^T Q puis Q -= 2 v w
+static void accumule_produit(void * arg, size_t debut, size_t fin) {
+    args_tridiag * t = arg;
+    unsigned int n = t->n, i;
+    size_t j;
+
+    for (j = debut; j < fin; j++) t->p[j] = 0;
+    for (i = t->k; i < n; i++) {
+        const double * qi = t->a + (size_t) i * n;
+        double vi = t->v[i];
+        for (j = debut; j < fin; j++) t->p[j] += vi * qi[j];
+    }
+}
+
+static void accumule_maj(void * arg, size_t debut, size_t fin) {
+    args_tridiag * t = arg;
+    unsigned int n = t->n, j;
+    size_t i;
+
+    for (i = debut; i < fin; i++) {
+        double * qi = t->a + i * n;
+        double vi = 2 * t->v[i];
+        for (j = t->k; j < n; j++) qi[j] -= vi * t->p[j];
+    }
+}
+
+// Réduit la matrice symétrique a (n x n) à la forme tridiagonale
+// T = Q^T A Q par réflexions de Householder : d reçoit la diagonale,
+// e la sous-diagonale (e[n-1] = 0). Si q n'est pas NULL, il reçoit Q.
+// Chaque réflexion est appliquée des deux côtés en une mise à jour
+// symétrique de rang 2, répartie par lignes sur le pool.
+static void tridiagonalisation(double * a, unsigned int n, double * d, double * e, double * q) {
+    unsigned int i, k;
+    double alpha, norme, kv, * v = allouer(n, sizeof(double)), * p = allouer(n, sizeof(double));
+    size_t grain = PARALLEL_SEUIL / (4 * (size_t) (n ? n : 1)) + 1;
+    args_tridiag t;
+
+    t.a = a;
+    t.n = n;
+    t.v = v;
+    t.p = p;
+
+    for (k = 0; k + 2 < n; k++) {
+        // v = x - alpha e1 normalisé, avec x = a[k+1:n][k]
+        norme = 0;
+        for (i = k + 1; i < n; i++) norme += a[(size_t) i * n + k] * a[(size_t) i * n + k];
+        norme = sqrt(norme);
+        alpha = a[(size_t) (k + 1) * n + k] > 0 ? -norme : norme;
+        e[k] = alpha;
+        for (i = 0; i <= k; i++) v[i] = 0;
+        for (i = k + 1; i < n; i++) v[i] = a[(size_t) i * n + k];
+        v[k + 1] -= alpha;
+        norme = 0;
+        for (i = k + 1; i < n; i++) norme += v[i] * v[i];
+        norme = sqrt(norme);
+        // v est conservé dans la colonne k pour reconstruire Q
+        for (i = k + 1; i < n; i++) {
+            v[i] = norme == 0 ? 0 : v[i] / norme;
+            a[(size_t) i * n + k] = v[i];
+        }
+        if (norme == 0) {
+            e[k] = a[(size_t) (k + 1) * n + k];
+            continue;
+        }
+
+        // p = 2 A v, q = p - (v^T p) v, A -= v q^T + q v^T
+        t.k = k + 1;
+        parallel_for(k + 1, n, grain, tridiag_produit, &t);
+        kv = 0;
+        for (i = k + 1; i < n; i++) kv += v[i] * p[i];
+        for (i = k + 1; i < n; i++) p[i] -= kv * v[i];
+        parallel_for(k + 1, n, grain, tridiag_maj, &t);
+    }
+
+    for (i = 0; i < n; i++) d[i] = a[(size_t) i * n + i];
+    if (n >= 2) e[n - 2] = a[(size_t) (n - 1) * n + n - 2];
+    if (n >= 1) e[n - 1] = 0;
+
+    if (q) {
+        // Q = H_0 H_1 ... H_{n-3}, accumulé de la dernière réflexion à la première
+        memset(q, 0, (size_t) n * n * sizeof(double));
+        for (i = 0; i < n; i++) q[(size_t) i * n + i] = 1;
+        t.a = q;
+        for (k = n >= 3 ? n - 2 : 0; k-- > 0; ) {
+            for (i = 0; i <= k; i++) v[i] = 0;
+            for (i = k + 1; i < n; i++) v[i] = a[(size_t) i * n + k];
+            t.k = k + 1;
+            parallel_for(k + 1, n, grain, accumule_produit, &t);
+            parallel_for(k + 1, n, grain, accumule_maj, &t);
+        }
+    }
+
+    free(v);
+    free(p);
+}
+
+
+// ---------------------------------------------------------------------
+// Matrice tridiagonale : QL implicite
+// ---------------------------------------------------------------------
+
+// Rotation de Givens (comme LAPACK dlartg) : renvoie r et choisit c, s
+// tels que c g + s f = r et -s g + c f = 0
+static double givens(double g, double f, double * c, double * s) {
+    double r;
+
+    if (f == 0) {
+        *c = 1;
+        *s = 0;
+        return g;
+    }
+    r = hypot(g, f);
+    *c = g / r;
+    *s = f / r;
+    return r;
+}
+
+// Rotation des colonnes i et i+1 de z (n x n) : elles deviennent
+// c z_i - s z_(i+1) et s z_i + c z_(i+1)
+static void rotation_colonnes(double * z, unsigned int n, unsigned int i, double c, double s) {
+    unsigned int k;
+    double x, y;
+
+    for (k = 0; k < n; k++) {
+        x = z[(size_t) k * n + i];
+        y = z[(size_t) k * n + i + 1];
+        z[(size_t) k * n + i] = c * x - s * y;
+        z[(size_t) k * n + i + 1] = s * x + c * y;
+    }
+}
+
+// Algorithme QL à décalage implicite sur la matrice tridiagonale (d, e)
+// (e[i] relie i et i+1, e[n-1] sert de tampon), dans l'esprit de LAPACK
+// dsteqr : on isole le bloc non réduit [l, m] qui commence en l. Un bloc
+// 1 x 1 est une valeur propre, un bloc 2 x 2 est diagonalisé par une
+// rotation de Jacobi ; sinon un balayage QL, décalé par la valeur propre
+// du coin supérieur 2 x 2 la plus proche de d[l], chasse le renflement de
+// m vers l par des rotations de Givens. Les valeurs propres remplacent d ;
+// si z n'est pas NULL (n x n, initialisée par l'appelant), les rotations
+// y sont accumulées. Retourne 0 en cas de non convergence.
+static int ql_implicite(double * d, double * e, unsigned int n, double * z) {
+    const double eps2 = DBL_EPSILON * DBL_EPSILON;
+    unsigned int l = 0, m, i, iter = 0;
+    double g, f, b, r, p, c, s, t, * rc = NULL, * rs = NULL;
+
+    if (!n) return 1;
+    e[n - 1] = 0;
+    if (z) {
+        rc = allouer(2 * (size_t) n, sizeof(double));
+        rs = rc + n;
+    }
+
+    while (l < n) {
+        // e[m] négligeable devant ses deux voisins diagonaux
+        for (m = l; m + 1 < n; m++) {
+            if (e[m] * e[m] <= eps2 * fabs(d[m]) * fabs(d[m + 1]) + DBL_MIN) {
+                e[m] = 0;
+                break;
+            }
+        }
+
+        if (m == l) {
+            l++;
+            iter = 0;
+            continue;
+        }
+
+        if (m == l + 1) {
+            // bloc 2 x 2 [d[l] e[l] ; e[l] d[l+1]] : rotation de Jacobi
+            t = (d[l + 1] - d[l]) / (2 * e[l]);
+            t = (t >= 0 ? 1 : -1) / (fabs(t) + hypot(t, 1));
+            c = 1 / hypot(t, 1);
+            s = t * c;
+            d[l] -= t * e[l];
+            d[l + 1] += t * e[l];
+            e[l] = 0;
+            if (z) rotation_colonnes(z, n, l, c, s);
+            l += 2;
+            iter = 0;
+            continue;
+        }
+
+        if (iter++ == QR_MAX_ITERATIONS) {
+            free(rc);
+            return 0;
+        }
+
+        // décalage de Wilkinson, écrit comme g = d[m] - décalage
+        p = d[l];
+        g = (d[l + 1] - p) / (2 * e[l]);
+        r = hypot(g, 1);
+        g = d[m] - p + e[l] / (g + (g >= 0 ? r : -r));
+
+        // balayage QL : p accumule la correction de la diagonale
+        c = s = 1;
+        p = 0;
+        for (i = m; i-- > l; ) {
+            f = s * e[i];
+            b = c * e[i];
+            r = givens(g, f, &c, &s);
+            if (i + 1 != m) e[i + 1] = r;
+            g = d[i + 1] - p;
+            r = (d[i] - g) * s + 2 * c * b;
+            p = s * r;
+            d[i + 1] = g + p;
+            g = c * r - b;
+            if (z) {
+                rc[i] = c;
+                rs[i] = s;
+            }
+        }
+        d[l] -= p;
+        e[l] = g;
+
+        // rotations appliquées à z dans l'ordre du balayage
+        if (z) {
+            for (i = m; i-- > l; ) rotation_colonnes(z, n, i, rc[i], rs[i]);
+        }
+    }
+
+    free(rc);
+    return 1;
+}
+
+
+// ---------------------------------------------------------------------
+// Matrice tridiagonale : diviser pour régner (Cuppen)
+// ---------------------------------------------------------------------
+
+typedef struct {
+    double cle;
+    unsigned int indice;
+} paire_tri;
+
+// Ordre croissant des clés, puis des indices (tri stable)
+static int compare_paires(const void * a, const void * b) {
+    const paire_tri * x = a, * y = b;
+    if (x->cle != y->cle) return x->cle < y->cle ? -1 : 1;
+    return x->indice < y->indice ? -1 : x->indice > y->indice;
+}
+
+// Trie les indices perm[0..n[ selon cle croissante
+static void tri_indices(unsigned int * perm, unsigned int n, const double * cle) {
+    paire_tri * t = allouer(n, sizeof(paire_tri));
+    unsigned int i;
+
+    for (i = 0; i < n; i++) {
+        t[i].cle = cle[perm[i]];
+        t[i].indice = perm[i];
+    }
+    qsort(t, n, sizeof(paire_tri), compare_paires);
+    for (i = 0; i < n; i++) perm[i] = t[i].indice;
+
+    free(t);
+}
+
+// Trie les valeurs propres d par ordre croissant, ainsi que les colonnes
+// correspondantes de q (n x n)
+static void trier_elements(unsigned int n, double * d, double * q) {
+    unsigned int i, j, * perm = allouer(n, sizeof(unsigned int));
+    double * ds = allouer(n, sizeof(double)), * qs = allouer((size_t) n * n, sizeof(double));
+
+    for (i = 0; i < n; i++) perm[i] = i;
+    tri_indices(perm, n, d);
+    for (i = 0; i < n; i++) {
+        ds[i] = d[perm[i]];
+        for (j = 0; j < n; j++) qs[(size_t) j * n + i] = q[(size_t) j * n + perm[i]];
+    }
+    memcpy(d, ds, n * sizeof(double));
+    memcpy(q, qs, (size_t) n * n * sizeof(double));
+
+    free(perm);
+    free(ds);
+    free(qs);
+}
+
+// Résout l'équation séculaire f(l) = 1 + rho somme z_j^2 / (d_j - l) = 0
+// pour sa racine i (d croissant, rho > 0). La racine est rendue sous la
+// forme d[*org] + *tau pour garder la précision près des pôles.
+static void racine_seculaire(unsigned int k, const double * d, const double * z, double rho,
+                             unsigned int i, unsigned int * org, double * tau) {
+    unsigned int j, it;
+    double lo, hi, t, f, fp, delta, nouveau, s;
+
+    if (i + 1 < k) {
+        // l'origine est le pôle le plus proche de la racine
+        t = (d[i + 1] - d[i]) / 2;
+        f = 1;
+        for (j = 0; j < k; j++) f += rho * z[j] * z[j] / ((d[j] - d[i]) - t);
+        if (f >= 0) {
+            *org = i;
+            lo = 0;
+            hi = t;
+        } else {
+            *org = i + 1;
+            lo = -t;
+            hi = 0;
+        }
+    } else {
+        s = 0;
+        for (j = 0; j < k; j++) s += z[j] * z[j];
+        *org = i;
+        lo = 0;
+        hi = rho * s;
+    }
+
+    // Newton protégé par dichotomie (f est croissante sur l'intervalle).
+    // tau doit être précis relativement à lui-même et pas seulement à
+    // d[*org] : c'est ce qui donne des vecteurs justes quand deux pôles
+    // sont très proches.
+    t = (lo + hi) / 2;
+    for (it = 0; it < SECULAIRE_MAX_ITERATIONS; it++) {
+        f = 1;
+        fp = 0;
+        for (j = 0; j < k; j++) {
+            delta = (d[j] - d[*org]) - t;
+            f += rho * z[j] * z[j] / delta;
+            fp += rho * z[j] * z[j] / (delta * delta);
+        }
+        if (f == 0) break;
+        if (f < 0) lo = t;
+        else hi = t;
+        if (hi - lo <= 2 * DBL_EPSILON * fmin(fabs(lo), fabs(hi))) break;
+        nouveau = t - f / fp;
+        if (fabs(nouveau - t) <= DBL_EPSILON * fabs(t)) {
+            t = nouveau;
+            break;
+        }
+        if (!(nouveau > lo && nouveau < hi)) nouveau = (lo + hi) / 2;
+        t = nouveau;
+    }
+
+    *tau = t;
+}
+
+// Fusion : valeurs et vecteurs propres de Q (D + rho z z^T) Q^T, où Q
+// (n x n) et D contiennent les éléments propres des deux sous-problèmes.
+// Les valeurs propres remplacent d (croissantes), les vecteurs q.
+static void fusion(unsigned int n, double * d, double * q, double rho, double * z) {
+    unsigned int i, j, k = 0, nd = 0, r, signe_neg = rho < 0;
+    unsigned int * perm = allouer(n, sizeof(unsigned int));
+    unsigned int * garde = allouer(n, sizeof(unsigned int));
+    unsigned int * deflate = allouer(n, sizeof(unsigned int));
+    unsigned int * org = allouer(n, sizeof(unsigned int));
+    double * ds = allouer(n, sizeof(double)), * zs = allouer(n, sizeof(double));
+    double * tau = allouer(n, sizeof(double));
+    double * dk = allouer(n, sizeof(double)), * zk = allouer(n, sizeof(double));
+    double * zh = allouer(n, sizeof(double));
+    double * qs = allouer((size_t) n * n, sizeof(double)), * u, * qk, * res;
+    double * lambda = allouer(n, sizeof(double));
+    double norme, tol, dmax = 0, c, s, t, x, p;
+
+    // on se ramène à rho > 0 : D + rho z z^T = -((-D) + |rho| z z^T)
+    if (signe_neg) {
+        for (i = 0; i < n; i++) d[i] = -d[i];
+        rho = -rho;
+    }
+
+    norme = 0;
+    for (i = 0; i < n; i++) norme += z[i] * z[i];
+    norme = sqrt(norme);
+    rho *= norme * norme;
+    for (i = 0; i < n; i++) z[i] /= norme;
+
+    for (i = 0; i < n; i++) perm[i] = i;
+    tri_indices(perm, n, d);
+    for (i = 0; i < n; i++) {
+        ds[i] = d[perm[i]];
+        zs[i] = z[perm[i]];
+        if (fabs(ds[i]) > dmax) dmax = fabs(ds[i]);
+        for (j = 0; j < n; j++) qs[(size_t) j * n + i] = q[(size_t) j * n + perm[i]];
+    }
+
+    // déflation : composantes de z négligeables ou valeurs propres égales
+    tol = 8 * DBL_EPSILON * (dmax > rho ? dmax : rho);
+    for (i = 0; i < n; i++) {
+        if (rho * fabs(zs[i]) <= tol) {
+            deflate[nd++] = i;
+            continue;
+        }
+        if (k > 0) {
+            j = garde[k - 1];
+            t = hypot(zs[j], zs[i]);
+            c = zs[i] / t;
+            s = zs[j] / t;
+            if (fabs((ds[i] - ds[j]) * c * s) <= tol) {
+                // rotation qui annule zs[j] : j devient une valeur propre
+                for (r = 0; r < n; r++) {
+                    x = qs[(size_t) r * n + j];
+                    p = qs[(size_t) r * n + i];
+                    qs[(size_t) r * n + j] = c * x - s * p;
+                    qs[(size_t) r * n + i] = s * x + c * p;
+                }
+                x = c * c * ds[j] + s * s * ds[i];
+                ds[i] = s * s * ds[j] + c * c * ds[i];
+                ds[j] = x;
+                zs[i] = t;
+                zs[j] = 0;
+                deflate[nd++] = j;
+                garde[k - 1] = i;
+                continue;
+            }
+        }
+        garde[k++] = i;
+    }
+
+    // équation séculaire sur les k valeurs non déflatées
+    tri_indices(garde, k, ds);
+    for (i = 0; i < k; i++) {
+        dk[i] = ds[garde[i]];
+        zk[i] = zs[garde[i]];
+    }
+    for (i = 0; i < k; i++) {
+        racine_seculaire(k, dk, zk, rho, i, &org[i], &tau[i]);
+        lambda[i] = dk[org[i]] + tau[i];
+    }
+
+    // z recalculé (Gu et Eisenstat) pour des vecteurs bien orthogonaux
+    for (i = 0; i < k; i++) {
+        p = 1;
+        for (j = 0; j < k; j++) {
+            p *= (dk[org[j]] - dk[i]) + tau[j];
+            if (j != i) p /= dk[j] - dk[i];
+        }
+        zh[i] = SIGNE(sqrt(fabs(p / rho)), zk[i]);
+    }
+
+    // vecteurs propres du problème de rang un (colonnes de u, k x k)
+    u = allouer((size_t) k * k, sizeof(double));
+    for (i = 0; i < k; i++) {
+        norme = 0;
+        for (j = 0; j < k; j++) {
+            x = zh[j] / ((dk[j] - dk[org[i]]) - tau[i]);
+            u[(size_t) j * k + i] = x;
+            norme += x * x;
+        }
+        norme = sqrt(norme);
+        for (j = 0; j < k; j++) u[(size_t) j * k + i] /= norme;
+    }
+
+    // vecteurs finaux : colonnes gardées de Q multipliées par u
+    qk = allouer((size_t) n * k, sizeof(double));
+    res = allouer((size_t) n * k, sizeof(double));
+    for (r = 0; r < n; r++) {
+        for (i = 0; i < k; i++) qk[(size_t) r * k + i] = qs[(size_t) r * n + garde[i]];
+    }
+    produit_double(n, k, k, qk, u, res);
+
+    // rassemblement : valeurs déflatées puis racines, triées ensuite
+    for (i = 0; i < nd; i++) {
+        d[i] = ds[deflate[i]];
+        for (r = 0; r < n; r++) q[(size_t) r * n + i] = qs[(size_t) r * n + deflate[i]];
+    }
+    for (i = 0; i < k; i++) {
+        d[nd + i] = lambda[i];
+        for (r = 0; r < n; r++) q[(size_t) r * n + nd + i] = res[(size_t) r * k + i];
+    }
+    if (signe_neg) {
+        for (i = 0; i < n; i++) d[i] = -d[i];
+    }
+    trier_elements(n, d, q);
+
+    free(perm); free(garde); free(deflate); free(org);
+    free(ds); free(zs); free(tau); free(dk); free(zk); free(zh);
+    free(qs); free(u); free(qk); free(res); free(lambda);
+}
+
+// Éléments propres de la matrice tridiagonale (d, e) : q (n x n) reçoit
+// les vecteurs propres, d les valeurs propres croissantes.
+// On coupe en deux, on résout chaque moitié récursivement, puis on
+// recolle les deux moitiés par une correction de rang un.
+static int diviser_pour_regner(unsigned int n, double * d, double * e, double * q) {
+    unsigned int m, i, n2;
+    double rho, * q1, * q2, * z;
+    int ok;
+
+    if (n <= DC_FEUILLE) {
+        memset(q, 0, (size_t) n * n * sizeof(double));
+        for (i = 0; i < n; i++) q[(size_t) i * n + i] = 1;
+        if (!ql_implicite(d, e, n, q)) return 0;
+        trier_elements(n, d, q);
+        return 1;
+    }
+
+    m = n / 2;
+    n2 = n - m;
+    rho = e[m - 1];
+    d[m - 1] -= rho;
+    d[m] -= rho;
+
+    q1 = allouer((size_t) m * m, sizeof(double));
+    q2 = allouer((size_t) n2 * n2, sizeof(double));
+    ok = diviser_pour_regner(m, d, e, q1) && diviser_pour_regner(n2, d + m, e + m, q2);
+
+    if (ok) {
+        z = allouer(n, sizeof(double));
+        memset(q, 0, (size_t) n * n * sizeof(double));
+        for (i = 0; i < m; i++) {
+            memcpy(q + (size_t) i * n, q1 + (size_t) i * m, m * sizeof(double));
+            z[i] = q1[(size_t) (m - 1) * m + i];
+        }
+        for (i = 0; i < n2; i++) {
+            memcpy(q + (size_t) (m + i) * n + m, q2 + (size_t) i * n2, n2 * sizeof(double));
+            z[m + i] = q2[i];
+        }
+        // sans couplage, il suffit de trier
+        if (rho != 0) fusion(n, d, q, rho, z);
+        else trier_elements(n, d, q);
+        free(z);
+    }
+
+    free(q1);
+    free(q2);
+    return ok;
+}
+
+
+// ---------------------------------------------------------------------
+// Interface
+// ---------------------------------------------------------------------
+
+// Valeurs propres (vecteur colonne décroissant) d'une matrice symétrique :
+// réduction tridiagonale puis QL implicite, ou diviser pour régner si les
+// vecteurs propres sont demandés. Dans ce cas *vecteurs reçoit une matrice
+// dont la colonne i est le vecteur propre de la valeur propre i.
+// Retourne NULL si l'algorithme ne converge pas.
+// prec : m carrée et symétrique
+Matrix valeurs_propres_symetrique(Matrix m, Matrix * vecteurs) {
+    unsigned int n = m->nb_rows, i, j;
+    double * a = allouer((size_t) n * n, sizeof(double)), * d = allouer(n, sizeof(double));
+    double * e = allouer(n, sizeof(double));
+    double * q = NULL, * z = NULL, * v = NULL;
+    Matrix r = NULL;
+    int ok;
+
+    for (i = 0; i < n * n; i++) a[i] = m->mat[i];
+
+    if (vecteurs) {
+        q = allouer((size_t) n * n, sizeof(double));
+        z = allouer((size_t) n * n, sizeof(double));
+        tridiagonalisation(a, n, d, e, q);
+        ok = diviser_pour_regner(n, d, e, z);
+    } else {
+        tridiagonalisation(a, n, d, e, NULL);
+        ok = ql_implicite(d, e, n, NULL);
+        if (ok) {
+            unsigned int * perm = allouer(n, sizeof(unsigned int));
+            for (i = 0; i < n; i++) perm[i] = i;
+            tri_indices(perm, n, d);
+            for (i = 0; i < n; i++) e[i] = d[perm[i]];
+            memcpy(d, e, n * sizeof(double));
+            free(perm);
+        }
+    }
+
+    if (ok) {
+        r = newMatrix(n, 1);
+        for (i = 0; i < n; i++) setElt(r, i, 0, d[n - 1 - i]);
+        if (vecteurs) {
+            // vecteurs de A = Q Z, colonnes remises dans l'ordre décroissant
+            v = allouer((size_t) n * n, sizeof(double));
+            produit_double(n, n, n, q, z, v);
+            *vecteurs = newMatrix(n, n);
+            for (i = 0; i < n; i++) {
+                for (j = 0; j < n; j++) setElt(*vecteurs, i, j, v[(size_t) i * n + n - 1 - j]);
+            }
+            free(v);
+        }
+    }
+
+    free(a);
+    free(d);
+    free(e);
+    free(q);
+    free(z);
+
+    return r;
+}
@@ -0,0 +1,305 @@
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+#include "system.h"
+#include "matrix.h"
+#include "gemm.h"
+#include "kernels.h"
+#include "threadpool.h"
+
+// Alloue un tampon aligné sur une ligne de cache pour l'empaquetage
+static E * gemm_alloc(size_t nb) {
+    void * p = NULL;
+    if (posix_memalign(&p, 64, nb * sizeof(E))) {
+        print_error("Cannot allocate memory for the GEMM buffers");
+        exit(EXIT_FAILURE);
+    }
+    return p;
+}
+
+// Tampon d'empaquetage propre à un thread, agrandi à la demande et
+// réutilisé d'un appel à l'autre (libéré à la fin du thread)
+typedef struct {
+    E * p;
+    size_t taille;
+    int occupe;     // déjà utilisé par un appel en cours sur ce thread
+} gemm_tampon;
+
+typedef struct {
+    gemm_tampon a, b;
+} gemm_tampons;
+
+static __thread gemm_tampons tampons;
+static pthread_key_t tampons_cle;
+static pthread_once_t tampons_once = PTHREAD_ONCE_INIT;
+
+static void tampons_liberer(void * arg) {
+    gemm_tampons * t = arg;
+    free(t->a.p);
+    free(t->b.p);
+    t->a.p = t->b.p = NULL;
+    t->a.taille = t->b.taille = 0;
+}
+
+static void tampons_init(void) {
+    pthread_key_create(&tampons_cle, tampons_liberer);
+}
+
+// Prend un tampon d'au moins nb éléments. Si le tampon du thread est
+// déjà pris (appel imbriqué exécuté pendant une attente du pool), un
+// tampon temporaire est alloué : tampon_rendre le libère.
+static E * tampon_prendre(gemm_tampon * t, size_t nb) {
+    if (t->occupe) return gemm_alloc(nb);
+    if (t->taille < nb) {
+        if (!t->p) {
+            pthread_once(&tampons_once, tampons_init);
+            pthread_setspecific(tampons_cle, &tampons);
+        }
+        free(t->p);
+        t->p = gemm_alloc(nb);
+        t->taille = nb;
+    }
+    t->occupe = 1;
+    return t->p;
+}
+
+static void tampon_rendre(gemm_tampon * t, E * p) {
+    if (p == t->p) t->occupe = 0;
+    else free(p);
+}
+
+// Empaquette un bloc mc x kc de A en panneaux de MR lignes.
+// Chaque panneau est stocké colonne par colonne (kc colonnes de MR
+// éléments) et complété par des zéros sur les bords.
+// Si trans vaut 1, a pointe sur le bloc transposé (kc x mc).
+static void pack_a(unsigned int mc, unsigned int kc, const E * a, unsigned int lda, int trans,
+                   E * ap, unsigned int MR) {
+    unsigned int i, ir, p, mr;
+
+    for (ir = 0; ir < mc; ir += MR) {
+        mr = mc - ir < MR ? mc - ir : MR;
+        for (p = 0; p < kc; p++) {
+            if (trans) {
+                const E * col = a + (size_t) p * lda + ir;
+                for (i = 0; i < mr; i++) ap[i] = col[i];
+            } else {
+                for (i = 0; i < mr; i++) ap[i] = a[(size_t) (ir + i) * lda + p];
+            }
+            for (; i < MR; i++) ap[i] = 0;
+            ap += MR;
+        }
+    }
+}
+
+// Empaquette un bloc kc x nc de B en panneaux de NR colonnes.
+// Chaque panneau est stocké ligne par ligne (kc lignes de NR
+// éléments) et complété par des zéros sur les bords.
+// Si trans vaut 1, b pointe sur le bloc transposé (nc x kc).
+static void pack_b(unsigned int kc, unsigned int nc, const E * b, unsigned int ldb, int trans,
+                   E * bp, unsigned int NR) {
+    unsigned int j, jr, p, nr;
+    const E * row;
+
+    for (jr = 0; jr < nc; jr += NR) {
+        nr = nc - jr < NR ? nc - jr : NR;
+        for (p = 0; p < kc; p++) {
+            if (trans) {
+                for (j = 0; j < nr; j++) bp[j] = b[(size_t) (jr + j) * ldb + p];
+                for (; j < NR; j++) bp[j] = 0;
+            } else {
+                row = b + (size_t) p * ldb + jr;
+                if (nr == NR) {
+                    memcpy(bp, row, NR * sizeof(E));
+                } else {
+                    for (j = 0; j < nr; j++) bp[j] = row[j];
+                    for (; j < NR; j++) bp[j] = 0;
+                }
+            }
+            bp += NR;
+        }
+    }
+}
+
+// Met C à l'échelle beta (utilisé quand k == 0 ou alpha == 0)
+static void scale_c(unsigned int m, unsigned int n, E beta, E * c, unsigned int ldc) {
+    unsigned int i, j;
+
+    for (i = 0; i < m; i++) {
+        E * ci = c + (size_t) i * ldc;
+        if (beta == 0) memset(ci, 0, n * sizeof(E));
+        else for (j = 0; j < n; j++) ci[j] *= beta;
+    }
+}
+
+// Produit direct pour les petites tailles, où l'empaquetage coûte plus
+// cher que le calcul : C = beta * C puis ajout de alpha * a(i, p) * B(p, :)
+static void gemm_direct(int transa, int transb, unsigned int m, unsigned int n, unsigned int k,
+                        E alpha, const E * a, unsigned int lda,
+                        const E * b, unsigned int ldb,
+                        E beta, E * c, unsigned int ldc) {
+    unsigned int i, j, p;
+    E aip;
+
+    for (i = 0; i < m; i++) {
+        E * ci = c + (size_t) i * ldc;
+        if (beta != 1) scale_c(1, n, beta, ci, ldc);
+        for (p = 0; p < k; p++) {
+            aip = alpha * (transa ? a[(size_t) p * lda + i] : a[(size_t) i * lda + p]);
+            if (transb) {
+                for (j = 0; j < n; j++) ci[j] += aip * b[(size_t) j * ldb + p];
+            } else {
+                const E * bp = b + (size_t) p * ldb;
+                for (j = 0; j < n; j++) ci[j] += aip * bp[j];
+            }
+        }
+    }
+}
+
+// Données partagées par les tâches d'un bloc (jc, pc)
+typedef struct {
+    const kernels_t * kr;
+    unsigned int m, nc, kc;
+    size_t taille_a;        // taille du tampon de A empaqueté
+    unsigned int nj;        // nombre de morceaux de colonnes par bloc de lignes
+    unsigned int jchunk;    // largeur d'un morceau de colonnes
+    E alpha, beta;
+    const E * a;            // A décalé à la colonne pc
+    unsigned int lda;
+    int transa;
+    const E * b;            // B décalé au bloc (pc, jc)
+    unsigned int ldb;
+    int transb;
+    E * bp;                 // B empaqueté
+    E * c;                  // C décalé à la colonne jc
+    unsigned int ldc;
+} gemm_bloc;
+
+// Empaquette les panneaux [debut, fin[ de B
+static void pack_b_taches(void * arg, size_t debut, size_t fin) {
+    gemm_bloc * g = arg;
+    unsigned int NR = g->kr->nr;
+    unsigned int j0 = debut * NR;
+    unsigned int j1 = fin * NR < g->nc ? fin * NR : g->nc;
+
+    pack_b(g->kc, j1 - j0, g->transb ? g->b + (size_t) j0 * g->ldb : g->b + j0, g->ldb, g->transb,
+           g->bp + (size_t) j0 * g->kc, NR);
+}
+
+// Calcule les tâches [debut, fin[ : la tâche t couvre le bloc de lignes
+// t / nj et le morceau de colonnes t % nj. Chaque tâche empaquette son
+// propre bloc de A dans le tampon de son thread.
+static void gemm_taches(void * arg, size_t debut, size_t fin) {
+    gemm_bloc * g = arg;
+    unsigned int MR = g->kr->mr, NR = g->kr->nr;
+    unsigned int ib, jb, ic, mc, j0, j1, jr, ir, dernier = (unsigned int) -1;
+    size_t t;
+    E * ap = tampon_prendre(&tampons.a, g->taille_a);
+
+    for (t = debut; t < fin; t++) {
+        ib = t / g->nj;
+        jb = t % g->nj;
+        ic = ib * GEMM_MC;
+        mc = g->m - ic < GEMM_MC ? g->m - ic : GEMM_MC;
+        if (ib != dernier) {
+            pack_a(mc, g->kc, g->transa ? g->a + ic : g->a + (size_t) ic * g->lda, g->lda, g->transa,
+                   ap, MR);
+            dernier = ib;
+        }
+        j0 = jb * g->jchunk;
+        j1 = j0 + g->jchunk < g->nc ? j0 + g->jchunk : g->nc;
+        for (jr = j0; jr < j1; jr += NR) {
+            for (ir = 0; ir < mc; ir += MR) {
+                g->kr->gemm_micro(g->kc, g->alpha, ap + (size_t) ir * g->kc, g->bp + (size_t) jr * g->kc,
+                                  g->beta, g->c + (size_t) (ic + ir) * g->ldc + jr, g->ldc,
+                                  mc - ir < MR ? mc - ir : MR,
+                                  j1 - jr < NR ? j1 - jr : NR);
+            }
+        }
+    }
+
+    tampon_rendre(&tampons.a, ap);
+}
+
+// Produit matriciel par blocs (schéma de Goto) :
+//   jc : bloc de NC colonnes de B et C  (L3)
+//   pc : bloc de KC lignes de B         (L3 -> B empaqueté)
+//   ic : bloc de MC lignes de A et C    (L2 -> A empaqueté)
+//   jr, ir : tuiles de registres traitées par le micro-noyau
+// Le micro-noyau et la taille de sa tuile viennent de kernels().
+// Pour chaque bloc (jc, pc), les blocs de lignes (découpés aussi en
+// colonnes quand il y en a trop peu pour occuper tous les threads) sont
+// répartis sur le pool de threads.
+// Les tampons d'empaquetage sont dimensionnés au problème et gardés par
+// chaque thread ; les tout petits produits sont calculés directement.
+void gemm_t(int transa, int transb, unsigned int m, unsigned int n, unsigned int k,
+            E alpha, const E * a, unsigned int lda,
+            const E * b, unsigned int ldb,
+            E beta, E * c, unsigned int ldc) {
+    const kernels_t * kr = kernels();
+    unsigned int MR = kr->mr, NR = kr->nr;
+    unsigned int jc, pc, nb_ic, nb_panneaux, threads, mc, nc, kc;
+    size_t nb_taches, grain;
+    gemm_bloc g;
+
+    if (!m || !n) return;
+    if (!k || alpha == 0) {
+        scale_c(m, n, beta, c, ldc);
+        return;
+    }
+    if ((double) m * n * k <= GEMM_DIRECT) {
+        gemm_direct(transa, transb, m, n, k, alpha, a, lda, b, ldb, beta, c, ldc);
+        return;
+    }
+
+    threads = (double) m * n * k < PARALLEL_SEUIL ? 1 : pool_threads();
+
+    g.kr = kr;
+    g.m = m;
+    g.alpha = alpha;
+    g.lda = lda;
+    g.transa = transa;
+    g.ldb = ldb;
+    g.transb = transb;
+    g.ldc = ldc;
+    // plus grands blocs effectivement utilisés, arrondis à la tuile
+    mc = m < GEMM_MC ? m : GEMM_MC;
+    nc = n < GEMM_NC ? n : GEMM_NC;
+    kc = k < GEMM_KC ? k : GEMM_KC;
+    g.taille_a = (size_t) (mc + MR - 1) / MR * MR * kc;
+    g.bp = tampon_prendre(&tampons.b, (size_t) (nc + NR - 1) / NR * NR * kc);
+
+    nb_ic = (m + GEMM_MC - 1) / GEMM_MC;
+
+    for (jc = 0; jc < n; jc += GEMM_NC) {
+        g.nc = n - jc < GEMM_NC ? n - jc : GEMM_NC;
+        g.c = c + jc;
+        nb_panneaux = (g.nc + NR - 1) / NR;
+
+        // assez de morceaux pour occuper tous les threads
+        g.nj = nb_ic >= 2 * threads ? 1 : (2 * threads + nb_ic - 1) / nb_ic;
+        if (g.nj > nb_panneaux) g.nj = nb_panneaux;
+        g.jchunk = (nb_panneaux + g.nj - 1) / g.nj * NR;
+        g.nj = (g.nc + g.jchunk - 1) / g.jchunk;
+        nb_taches = (size_t) nb_ic * g.nj;
+        grain = threads == 1 ? nb_taches : 1;
+
+        for (pc = 0; pc < k; pc += GEMM_KC) {
+            g.kc = k - pc < GEMM_KC ? k - pc : GEMM_KC;
+            // beta n'est appliqué qu'au premier bloc de k, ensuite on accumule
+            g.beta = pc == 0 ? beta : 1;
+            g.a = transa ? a + (size_t) pc * lda : a + pc;
+            g.b = transb ? b + (size_t) jc * ldb + pc : b + (size_t) pc * ldb + jc;
+            parallel_for(0, nb_panneaux, threads == 1 ? nb_panneaux : 8, pack_b_taches, &g);
+            parallel_for(0, nb_taches, grain, gemm_taches, &g);
+        }
+    }
+
+    tampon_rendre(&tampons.b, g.bp);
+}
+
+void gemm(unsigned int m, unsigned int n, unsigned int k,
+          E alpha, const E * a, unsigned int lda,
+          const E * b, unsigned int ldb,
+          E beta, E * c, unsigned int ldc) {
+    gemm_t(0, 0, m, n, k, alpha, a, lda, b, ldb, beta, c, ldc);
+}
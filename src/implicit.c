@@ -0,0 +1,226 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "system.h"
+#include "matrix.h"
+#include "sparse.h"
+#include "implicit.h"
+
+static Implicit newImplicit(nature_implicite nature, unsigned int nb_rows, unsigned int nb_columns, E alpha) {
+    Implicit m = allouer(1, sizeof(struct implicit));
+    m->nature = nature;
+    m->nb_rows = nb_rows;
+    m->nb_columns = nb_columns;
+    m->alpha = alpha;
+    m->perm = NULL;
+    return m;
+}
+
+Implicit newNulle(unsigned int nb_rows, unsigned int nb_columns) {
+    return newImplicit(IMPLICITE_NULLE, nb_rows, nb_columns, 0);
+}
+
+Implicit newIdentite(unsigned int n, E alpha) {
+    return newImplicit(IMPLICITE_IDENTITE, n, n, alpha);
+}
+
+// perm (n entiers) appartient ensuite à la matrice
+Implicit newPermutation(unsigned int n, unsigned int * perm, E alpha) {
+    Implicit m = newImplicit(IMPLICITE_PERMUTATION, n, n, alpha);
+    m->perm = perm;
+    return m;
+}
+
+void deleteImplicit(Implicit m) {
+    if (!m) return;
+    free(m->perm);
+    free(m);
+}
+
+Implicit new_implicit_copy(Implicit m) {
+    Implicit r = newImplicit(m->nature, m->nb_rows, m->nb_columns, m->alpha);
+    if (m->perm) {
+        r->perm = allouer(m->nb_rows, sizeof(unsigned int));
+        memcpy(r->perm, m->perm, (size_t) m->nb_rows * sizeof(unsigned int));
+    }
+    return r;
+}
+
+// Les petites matrices sont affichées comme les matrices denses, les
+// grandes par leur nature et leurs dimensions
+void printImplicit(Implicit m) {
+    Matrix d;
+
+    if (!m) {
+        print_error("No matrix to print");
+        return;
+    }
+
+    if ((size_t) m->nb_rows * m->nb_columns <= AFFICHAGE_MAX) {
+        d = implicit_to_dense(m);
+        printMatrix(d);
+        deleteMatrix(d);
+        return;
+    }
+
+    if (m->nature == IMPLICITE_NULLE) printf("Matrice nulle %u x %u\n", m->nb_rows, m->nb_columns);
+    else {
+        printf("Matrice %s %u x %u", m->nature == IMPLICITE_IDENTITE ? "identité" : "de permutation",
+               m->nb_rows, m->nb_columns);
+        if (m->alpha != 1) printf(", multipliée par %f", m->alpha);
+        printf("\n");
+    }
+}
+
+Matrix implicit_to_dense(Implicit m) {
+    Matrix d = newMatrix(m->nb_rows, m->nb_columns);
+    unsigned int i;
+
+    if (m->nature == IMPLICITE_NULLE) return d;
+    for (i = 0; i < m->nb_rows; i++) {
+        setElt(d, i, m->perm ? m->perm[i] : i, m->alpha);
+    }
+
+    return d;
+}
+
+// Au plus un coefficient par ligne : CSR en O(n)
+Sparse implicit_to_sparse(Implicit m) {
+    size_t nnz = implicit_nnz(m);
+    Sparse s = newSparse(m->nb_rows, m->nb_columns, nnz);
+    unsigned int i;
+
+    for (i = 0; i < m->nb_rows; i++) {
+        if (nnz) {
+            s->col[i] = m->perm ? m->perm[i] : i;
+            s->val[i] = m->alpha;
+        }
+        s->row_ptr[i + 1] = nnz ? i + 1 : 0;
+    }
+
+    return s;
+}
+
+size_t implicit_nnz(Implicit m) {
+    return m->nature == IMPLICITE_NULLE || m->alpha == 0 ? 0 : m->nb_rows;
+}
+
+// La transposée d'une permutation est la permutation inverse
+Implicit implicit_transpose(Implicit m) {
+    Implicit t = newImplicit(m->nature, m->nb_columns, m->nb_rows, m->alpha);
+    unsigned int i;
+
+    if (m->perm) {
+        t->perm = allouer(m->nb_rows, sizeof(unsigned int));
+        for (i = 0; i < m->nb_rows; i++) t->perm[m->perm[i]] = i;
+    }
+
+    return t;
+}
+
+// (alpha P)^-1 = P^T / alpha. Retourne NULL si m n'est pas inversible.
+Implicit implicit_inverse(Implicit m) {
+    Implicit r;
+
+    if (m->nature == IMPLICITE_NULLE || m->alpha == 0) return NULL;
+
+    r = implicit_transpose(m);
+    r->alpha = 1 / m->alpha;
+
+    return r;
+}
+
+// Produit de deux matrices implicites, qui reste implicite. Retourne NULL
+// si les dimensions ne correspondent pas.
+Implicit implicit_multiplication(Implicit a, Implicit b) {
+    Implicit r;
+    unsigned int i;
+
+    if (a->nb_columns != b->nb_rows) return NULL;
+
+    if (a->nature == IMPLICITE_NULLE || b->nature == IMPLICITE_NULLE) return newNulle(a->nb_rows, b->nb_columns);
+
+    if (a->nature == IMPLICITE_IDENTITE) r = new_implicit_copy(b);
+    else if (b->nature == IMPLICITE_IDENTITE) r = new_implicit_copy(a);
+    else {
+        // la ligne i de P Q A est la ligne perm_q[perm_p[i]] de A
+        r = newPermutation(a->nb_rows, allouer(a->nb_rows, sizeof(unsigned int)), 1);
+        for (i = 0; i < a->nb_rows; i++) r->perm[i] = b->perm[a->perm[i]];
+    }
+    r->alpha = a->alpha * b->alpha;
+
+    return r;
+}
+
+// A B, A étant implicite : recopie (mise à l'échelle) ou permutation des
+// lignes de B, sans produit matriciel. Retourne NULL si les dimensions ne
+// correspondent pas.
+Matrix implicit_mult_dense(Implicit a, Matrix b) {
+    unsigned int i, p = b->nb_columns;
+    size_t k;
+    Matrix c;
+
+    if (a->nb_columns != b->nb_rows) return NULL;
+
+    c = newMatrix(a->nb_rows, p);
+    if (a->nature == IMPLICITE_NULLE) return c;
+
+    for (i = 0; i < a->nb_rows; i++) {
+        memcpy(c->mat + (size_t) i * p, b->mat + (size_t) (a->perm ? a->perm[i] : i) * p, p * sizeof(E));
+    }
+    if (a->alpha != 1) {
+        for (k = 0; k < (size_t) a->nb_rows * p; k++) c->mat[k] *= a->alpha;
+    }
+
+    return c;
+}
+
+// A B, B étant implicite : la colonne k de A devient la colonne perm[k]
+// du produit. Retourne NULL si les dimensions ne correspondent pas.
+Matrix dense_mult_implicit(Matrix a, Implicit b) {
+    unsigned int r, k, n = b->nb_columns;
+    const E * ar;
+    E * cr;
+    Matrix c;
+
+    if (a->nb_columns != b->nb_rows) return NULL;
+
+    c = newMatrix(a->nb_rows, n);
+    if (b->nature == IMPLICITE_NULLE) return c;
+
+    for (r = 0; r < a->nb_rows; r++) {
+        ar = a->mat + (size_t) r * a->nb_columns;
+        cr = c->mat + (size_t) r * n;
+        for (k = 0; k < n; k++) cr[b->perm ? b->perm[k] : k] = b->alpha * ar[k];
+    }
+
+    return c;
+}
+
+// det(alpha P) = signe(P) alpha^n, le signe se lisant sur le nombre de
+// cycles de la permutation. prec : m doit être carrée.
+E implicit_det(Implicit m) {
+    unsigned int i, j, n = m->nb_rows;
+    double d = 1;
+    char * vu;
+
+    if (n == 0 || m->nature == IMPLICITE_NULLE) return 0;
+
+    for (i = 0; i < n; i++) d *= m->alpha;
+
+    if (m->perm) {
+        // chaque cycle de longueur l compte pour l - 1 transpositions
+        vu = allouer(n, sizeof(char));
+        memset(vu, 0, n);
+        for (i = 0; i < n; i++) {
+            if (vu[i]) continue;
+            for (j = m->perm[i], vu[i] = 1; j != i; j = m->perm[j]) {
+                vu[j] = 1;
+                d = -d;
+            }
+        }
+        free(vu);
+    }
+
+    return d;
+}
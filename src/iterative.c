@@ -0,0 +1,354 @@
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+#include "system.h"
+#include "matrix.h"
+#include "sparse.h"
+#include "threadpool.h"
+#include "precond.h"
+#include "iterative.h"
+
+unsigned int operateur_taille(operateur a) {
+    return a.dense ? a.dense->nb_rows : a.creuse->nb_rows;
+}
+
+
+// ---------------------------------------------------------------------
+// Noyaux parallèles : produit par l'opérateur, produit scalaire, combinaisons
+// ---------------------------------------------------------------------
+
+typedef struct {
+    operateur a;
+    const double * x;
+    double * y;
+} args_produit;
+
+// y = A x pour les lignes [debut, fin[ (GEMV ou SpMV)
+static void produit_morceau(void * arg, size_t debut, size_t fin) {
+    args_produit * p = arg;
+    unsigned int j, n;
+    size_t i, k;
+    double s;
+
+    if (p->a.dense) {
+        n = p->a.dense->nb_columns;
+        for (i = debut; i < fin; i++) {
+            const E * ai = p->a.dense->mat + i * n;
+            s = 0;
+            for (j = 0; j < n; j++) s += ai[j] * p->x[j];
+            p->y[i] = s;
+        }
+    } else {
+        Sparse c = p->a.creuse;
+        for (i = debut; i < fin; i++) {
+            s = 0;
+            for (k = c->row_ptr[i]; k < c->row_ptr[i + 1]; k++) s += c->val[k] * p->x[c->col[k]];
+            p->y[i] = s;
+        }
+    }
+}
+
+static void produit_operateur(operateur a, const double * x, double * y) {
+    unsigned int n = operateur_taille(a);
+    size_t travail = a.dense ? (size_t) n * n : a.creuse->nnz;
+    args_produit p = { a, x, y };
+
+    parallel_for(0, n, PARALLEL_SEUIL / (travail / (n ? n : 1) + 1) + 1, produit_morceau, &p);
+}
+
+typedef struct {
+    const double * x;
+    const double * y;
+    double * z;
+    double a;
+    double b;
+} args_vecteurs;
+
+static double scalaire_morceau(void * arg, size_t debut, size_t fin) {
+    args_vecteurs * v = arg;
+    double s = 0;
+    size_t i;
+
+    for (i = debut; i < fin; i++) s += v->x[i] * v->y[i];
+
+    return s;
+}
+
+// x . y (réduction déterministe)
+static double produit_scalaire(unsigned int n, const double * x, const double * y) {
+    args_vecteurs v = { x, y, NULL, 0, 0 };
+    return parallel_reduce(0, n, PARALLEL_SEUIL, scalaire_morceau, &v);
+}
+
+static double norme2(unsigned int n, const double * x) {
+    return sqrt(produit_scalaire(n, x, x));
+}
+
+static void combinaison_morceau(void * arg, size_t debut, size_t fin) {
+    args_vecteurs * v = arg;
+    size_t i;
+
+    for (i = debut; i < fin; i++) v->z[i] = v->a * v->x[i] + v->b * v->y[i];
+}
+
+// z = a x + b y (z peut être x ou y)
+static void combinaison(unsigned int n, double a, const double * x, double b, const double * y, double * z) {
+    args_vecteurs v = { x, y, z, a, b };
+    parallel_for(0, n, PARALLEL_SEUIL, combinaison_morceau, &v);
+}
+
+// Copie b (vecteur colonne) en double
+static double * vers_double(Matrix b) {
+    unsigned int i, n = b->nb_rows;
+    double * v = allouer(n, sizeof(double));
+    for (i = 0; i < n; i++) v[i] = b->mat[i];
+    return v;
+}
+
+static Matrix vers_matrice(unsigned int n, const double * x) {
+    unsigned int i;
+    Matrix m = newMatrix(n, 1);
+    for (i = 0; i < n; i++) m->mat[i] = x[i];
+    return m;
+}
+
+// z = M^-1 r, ou z = r sans préconditionneur
+static void preconditionner(Precond m, unsigned int n, const double * r, double * z) {
+    if (m) appliquer_precond(m, r, z);
+    else if (z != r) memcpy(z, r, n * sizeof(double));
+}
+
+static void remplir_bilan(bilan_iteratif * bilan, unsigned int it, double residu, double tol) {
+    if (!bilan) return;
+    bilan->iterations = it;
+    bilan->residu = residu;
+    bilan->converge = residu <= tol;
+}
+
+
+// ---------------------------------------------------------------------
+// Solveurs
+// ---------------------------------------------------------------------
+
+// Gradient conjugué préconditionné, pour A (et M) symétrique définie
+// positive. Part de x = 0 et s'arrête quand ||r|| <= tol ||b|| ou après
+// max_iter itérations. m vaut NULL pour le gradient conjugué simple.
+// prec : A carrée, b vecteur colonne de même taille
+Matrix gradient_conjugue(operateur a, Matrix b, Precond m, double tol, unsigned int max_iter,
+                         bilan_iteratif * bilan) {
+    unsigned int n = operateur_taille(a), it = 0;
+    double * x = allouer(n, sizeof(double)), * r = vers_double(b), * p = allouer(n, sizeof(double));
+    double * q = allouer(n, sizeof(double));
+    double * z = m ? allouer(n, sizeof(double)) : r;
+    double nb, rr, rz, rz_nouveau, alpha, pq;
+    Matrix res;
+
+    memset(x, 0, n * sizeof(double));
+    preconditionner(m, n, r, z);
+    memcpy(p, z, n * sizeof(double));
+    rr = produit_scalaire(n, r, r);
+    rz = produit_scalaire(n, r, z);
+    nb = sqrt(rr);
+
+    while (nb > 0 && sqrt(rr) > tol * nb && it < max_iter) {
+        produit_operateur(a, p, q);
+        pq = produit_scalaire(n, p, q);
+        if (pq == 0 || rz == 0) break;
+        alpha = rz / pq;
+        combinaison(n, 1, x, alpha, p, x);
+        combinaison(n, 1, r, -alpha, q, r);
+        preconditionner(m, n, r, z);
+        rr = produit_scalaire(n, r, r);
+        rz_nouveau = m ? produit_scalaire(n, r, z) : rr;
+        combinaison(n, 1, z, rz_nouveau / rz, p, p);
+        rz = rz_nouveau;
+        it++;
+    }
+
+    remplir_bilan(bilan, it, nb > 0 ? sqrt(rr) / nb : 0, tol);
+    res = vers_matrice(n, x);
+
+    free(x);
+    free(r);
+    free(p);
+    free(q);
+    if (m) free(z);
+
+    return res;
+}
+
+// BiCGSTAB (van der Vorst) préconditionné à droite, pour A quelconque.
+// Part de x = 0 ; m vaut NULL sans préconditionneur.
+// prec : A carrée, b vecteur colonne de même taille
+Matrix bicgstab(operateur a, Matrix b, Precond m, double tol, unsigned int max_iter, bilan_iteratif * bilan) {
+    unsigned int n = operateur_taille(a), it = 0;
+    double * x = allouer(n, sizeof(double)), * r = vers_double(b), * r0 = allouer(n, sizeof(double));
+    double * p = allouer(n, sizeof(double)), * v = allouer(n, sizeof(double));
+    double * s = allouer(n, sizeof(double)), * t = allouer(n, sizeof(double));
+    double * ph = m ? allouer(n, sizeof(double)) : p, * sh = m ? allouer(n, sizeof(double)) : s;
+    double nb, residu, rho = 1, rho_nouveau, alpha = 1, omega = 1, beta, tt;
+    Matrix res;
+
+    memset(x, 0, n * sizeof(double));
+    memset(p, 0, n * sizeof(double));
+    memset(v, 0, n * sizeof(double));
+    memcpy(r0, r, n * sizeof(double));
+    nb = residu = norme2(n, r);
+
+    while (nb > 0 && residu > tol * nb && it < max_iter) {
+        rho_nouveau = produit_scalaire(n, r0, r);
+        if (rho_nouveau == 0 || omega == 0) break;     // rupture
+        beta = rho_nouveau / rho * alpha / omega;
+        rho = rho_nouveau;
+
+        // p = r + beta (p - omega v)
+        combinaison(n, 1, p, -omega, v, p);
+        combinaison(n, 1, r, beta, p, p);
+        preconditionner(m, n, p, ph);
+        produit_operateur(a, ph, v);
+        alpha = rho / produit_scalaire(n, r0, v);
+        combinaison(n, 1, r, -alpha, v, s);
+        it++;
+
+        residu = norme2(n, s);
+        if (residu <= tol * nb) {
+            combinaison(n, 1, x, alpha, ph, x);
+            break;
+        }
+
+        preconditionner(m, n, s, sh);
+        produit_operateur(a, sh, t);
+        tt = produit_scalaire(n, t, t);
+        omega = tt == 0 ? 0 : produit_scalaire(n, t, s) / tt;
+        combinaison(n, 1, x, alpha, ph, x);
+        combinaison(n, 1, x, omega, sh, x);
+        combinaison(n, 1, s, -omega, t, r);
+        residu = norme2(n, r);
+    }
+
+    remplir_bilan(bilan, it, nb > 0 ? residu / nb : 0, tol);
+    res = vers_matrice(n, x);
+
+    free(x);
+    free(r);
+    free(r0);
+    free(p);
+    free(v);
+    free(s);
+    free(t);
+    if (m) {
+        free(ph);
+        free(sh);
+    }
+
+    return res;
+}
+
+// GMRES redémarré tous les redemarrage pas, pour A quelconque. La base de
+// Krylov est orthonormalisée par Gram-Schmidt modifié et la matrice de
+// Hessenberg triangularisée au fil de l'eau par rotations de Givens, ce
+// qui donne le résidu sans calculer x. Le préconditionnement est à droite
+// (A M^-1 u = b, x = M^-1 u), le résidu est donc celui du système
+// d'origine. Part de x = 0 ; p vaut NULL sans préconditionneur.
+// prec : A carrée, b vecteur colonne de même taille
+Matrix gmres(operateur a, Matrix b, Precond p, double tol, unsigned int max_iter, unsigned int redemarrage,
+             bilan_iteratif * bilan) {
+    unsigned int n = operateur_taille(a), m = redemarrage ? redemarrage : 1, it = 0, i, j, k;
+    double * x = allouer(n, sizeof(double)), * bd = vers_double(b), * w = allouer(n, sizeof(double));
+    double * z = p ? allouer(n, sizeof(double)) : NULL;
+    double * v = allouer((size_t) (m + 1) * n, sizeof(double));
+    double * h = allouer((size_t) (m + 1) * m, sizeof(double)), * g = allouer(m + 1, sizeof(double));
+    double * c = allouer(m, sizeof(double)), * s = allouer(m, sizeof(double));
+    double * y = allouer(m, sizeof(double));
+    double nb, beta, residu, t;
+    Matrix res;
+
+    memset(x, 0, n * sizeof(double));
+    nb = residu = norme2(n, bd);
+
+    while (nb > 0 && residu > tol * nb && it < max_iter) {
+        // r = b - A x, v_0 = r / ||r||
+        produit_operateur(a, x, w);
+        combinaison(n, 1, bd, -1, w, w);
+        beta = norme2(n, w);
+        if (beta == 0) {
+            residu = 0;
+            break;
+        }
+        combinaison(n, 1 / beta, w, 0, w, v);
+        memset(g, 0, (m + 1) * sizeof(double));
+        g[0] = beta;
+
+        for (j = 0; j < m && it < max_iter; ) {
+            double * vj1 = v + (size_t) (j + 1) * n;
+            if (p) {
+                appliquer_precond(p, v + (size_t) j * n, z);
+                produit_operateur(a, z, vj1);
+            } else {
+                produit_operateur(a, v + (size_t) j * n, vj1);
+            }
+            for (i = 0; i <= j; i++) {
+                h[i * m + j] = produit_scalaire(n, vj1, v + (size_t) i * n);
+                combinaison(n, 1, vj1, -h[i * m + j], v + (size_t) i * n, vj1);
+            }
+            h[(j + 1) * m + j] = norme2(n, vj1);
+            if (h[(j + 1) * m + j] != 0) combinaison(n, 1 / h[(j + 1) * m + j], vj1, 0, vj1, vj1);
+
+            // rotations précédentes, puis celle qui annule h[j+1][j]
+            for (i = 0; i < j; i++) {
+                t = c[i] * h[i * m + j] + s[i] * h[(i + 1) * m + j];
+                h[(i + 1) * m + j] = -s[i] * h[i * m + j] + c[i] * h[(i + 1) * m + j];
+                h[i * m + j] = t;
+            }
+            t = hypot(h[j * m + j], h[(j + 1) * m + j]);
+            c[j] = t == 0 ? 1 : h[j * m + j] / t;
+            s[j] = t == 0 ? 0 : h[(j + 1) * m + j] / t;
+            h[j * m + j] = t;
+            h[(j + 1) * m + j] = 0;
+            g[j + 1] = -s[j] * g[j];
+            g[j] = c[j] * g[j];
+
+            j++;
+            it++;
+            residu = fabs(g[j]);
+            if (residu <= tol * nb || t == 0) break;
+        }
+
+        // H y = g (triangulaire supérieure j x j), puis x += M^-1 V y
+        for (k = j; k-- > 0; ) {
+            t = g[k];
+            for (i = k + 1; i < j; i++) t -= h[k * m + i] * y[i];
+            y[k] = h[k * m + k] == 0 ? 0 : t / h[k * m + k];
+        }
+        if (p) {
+            memset(w, 0, n * sizeof(double));
+            for (k = 0; k < j; k++) combinaison(n, 1, w, y[k], v + (size_t) k * n, w);
+            appliquer_precond(p, w, z);
+            combinaison(n, 1, x, 1, z, x);
+        } else {
+            for (k = 0; k < j; k++) combinaison(n, 1, x, y[k], v + (size_t) k * n, x);
+        }
+
+        // résidu réel, pour ne pas dépendre des erreurs d'arrondi de g
+        produit_operateur(a, x, w);
+        combinaison(n, 1, bd, -1, w, w);
+        residu = norme2(n, w);
+        if (j == 0) break;
+    }
+
+    remplir_bilan(bilan, it, nb > 0 ? residu / nb : 0, tol);
+    res = vers_matrice(n, x);
+
+    free(x);
+    free(bd);
+    free(w);
+    free(v);
+    free(h);
+    free(g);
+    free(c);
+    free(s);
+    free(y);
+    free(z);
+
+    return res;
+}
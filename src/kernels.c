@@ -0,0 +1,550 @@
+#include <stdlib.h>
+#include <string.h>
+#include "matrix.h"
+#include "kernels.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+#define KERNELS_X86
+#include <cpuid.h>
+#include <immintrin.h>
+#endif
+
+// Taille des blocs utilisés pour la transposition (tient dans le cache L1)
+#define TRANSPOSE_BLOC 64
+
+
+// ---------------------------------------------------------------------
+// Fonctions communes
+// ---------------------------------------------------------------------
+
+// La copie contiguë est déjà vectorisée (et choisie à l'exécution) par
+// la libc, on s'appuie donc sur memcpy pour tous les jeux d'instructions
+static void copy_all(size_t n, const E * x, E * y) {
+    if (x != y) memcpy(y, x, n * sizeof(E));
+}
+
+// Écrit une tuile de l'accumulateur (pas ld_acc) dans C, seulement les
+// mr x nr premiers éléments : sert pour les tuiles incomplètes des bords
+static void store_tile(const E * acc, unsigned int ld_acc, unsigned int mr, unsigned int nr,
+                       E alpha, E beta, E * c, unsigned int ldc) {
+    unsigned int i, j;
+
+    for (i = 0; i < mr; i++) {
+        E * ci = c + (size_t) i * ldc;
+        const E * ai = acc + (size_t) i * ld_acc;
+        if (beta == 0) {
+            for (j = 0; j < nr; j++) ci[j] = alpha * ai[j];
+        } else {
+            for (j = 0; j < nr; j++) ci[j] = beta * ci[j] + alpha * ai[j];
+        }
+    }
+}
+
+// Transposition scalaire d'un bloc [i0, i1[ x [j0, j1[
+static void transpose_bloc_scalar(unsigned int i0, unsigned int i1,
+                                  unsigned int j0, unsigned int j1,
+                                  const E * a, unsigned int lda, E * b, unsigned int ldb) {
+    unsigned int i, j;
+
+    for (i = i0; i < i1; i++) {
+        for (j = j0; j < j1; j++) {
+            b[(size_t) j * ldb + i] = a[(size_t) i * lda + j];
+        }
+    }
+}
+
+
+// ---------------------------------------------------------------------
+// Version scalaire (portable)
+// ---------------------------------------------------------------------
+
+#define SCALAR_MR 6
+#define SCALAR_NR 16
+
+static void add_scalar(size_t n, const E * x, const E * y, E * z) {
+    size_t i;
+    for (i = 0; i < n; i++) z[i] = x[i] + y[i];
+}
+
+static void scale_scalar(size_t n, E s, const E * x, E * y) {
+    size_t i;
+    for (i = 0; i < n; i++) y[i] = s * x[i];
+}
+
+static void transpose_scalar(unsigned int rows, unsigned int cols,
+                             const E * a, unsigned int lda, E * b, unsigned int ldb) {
+    unsigned int i, j;
+
+    for (i = 0; i < rows; i += TRANSPOSE_BLOC) {
+        for (j = 0; j < cols; j += TRANSPOSE_BLOC) {
+            transpose_bloc_scalar(i, rows - i < TRANSPOSE_BLOC ? rows : i + TRANSPOSE_BLOC,
+                                  j, cols - j < TRANSPOSE_BLOC ? cols : j + TRANSPOSE_BLOC,
+                                  a, lda, b, ldb);
+        }
+    }
+}
+
+static void gemm_micro_scalar(unsigned int kc, E alpha, const E * ap, const E * bp,
+                              E beta, E * c, unsigned int ldc,
+                              unsigned int mr, unsigned int nr) {
+    E acc[SCALAR_MR][SCALAR_NR];
+    unsigned int i, j, p;
+
+    memset(acc, 0, sizeof(acc));
+
+    for (p = 0; p < kc; p++) {
+        for (i = 0; i < SCALAR_MR; i++) {
+            E ai = ap[i];
+            for (j = 0; j < SCALAR_NR; j++) acc[i][j] += ai * bp[j];
+        }
+        ap += SCALAR_MR;
+        bp += SCALAR_NR;
+    }
+
+    store_tile(&acc[0][0], SCALAR_NR, mr, nr, alpha, beta, c, ldc);
+}
+
+static const kernels_t kernels_scalar = {
+    "scalar", SCALAR_MR, SCALAR_NR,
+    add_scalar, scale_scalar, copy_all, transpose_scalar, gemm_micro_scalar
+};
+
+
+#ifdef KERNELS_X86
+
+// ---------------------------------------------------------------------
+// SSE2 (4 flottants par registre)
+// ---------------------------------------------------------------------
+
+#define SSE2_MR 4
+#define SSE2_NR 8
+
+__attribute__((target("sse2")))
+static void add_sse2(size_t n, const E * x, const E * y, E * z) {
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        _mm_storeu_ps(z + i, _mm_add_ps(_mm_loadu_ps(x + i), _mm_loadu_ps(y + i)));
+    }
+    for (; i < n; i++) z[i] = x[i] + y[i];
+}
+
+__attribute__((target("sse2")))
+static void scale_sse2(size_t n, E s, const E * x, E * y) {
+    size_t i = 0;
+    __m128 vs = _mm_set1_ps(s);
+    for (; i + 4 <= n; i += 4) {
+        _mm_storeu_ps(y + i, _mm_mul_ps(vs, _mm_loadu_ps(x + i)));
+    }
+    for (; i < n; i++) y[i] = s * x[i];
+}
+
+__attribute__((target("sse2")))
+static void transpose_sse2(unsigned int rows, unsigned int cols,
+                           const E * a, unsigned int lda, E * b, unsigned int ldb) {
+    unsigned int i0, j0, i, j, i1, j1;
+    __m128 r0, r1, r2, r3;
+
+    for (i0 = 0; i0 < rows; i0 += TRANSPOSE_BLOC) {
+        i1 = rows - i0 < TRANSPOSE_BLOC ? rows : i0 + TRANSPOSE_BLOC;
+        for (j0 = 0; j0 < cols; j0 += TRANSPOSE_BLOC) {
+            j1 = cols - j0 < TRANSPOSE_BLOC ? cols : j0 + TRANSPOSE_BLOC;
+            for (i = i0; i + 4 <= i1; i += 4) {
+                for (j = j0; j + 4 <= j1; j += 4) {
+                    r0 = _mm_loadu_ps(a + (size_t) (i + 0) * lda + j);
+                    r1 = _mm_loadu_ps(a + (size_t) (i + 1) * lda + j);
+                    r2 = _mm_loadu_ps(a + (size_t) (i + 2) * lda + j);
+                    r3 = _mm_loadu_ps(a + (size_t) (i + 3) * lda + j);
+                    _MM_TRANSPOSE4_PS(r0, r1, r2, r3);
+                    _mm_storeu_ps(b + (size_t) (j + 0) * ldb + i, r0);
+                    _mm_storeu_ps(b + (size_t) (j + 1) * ldb + i, r1);
+                    _mm_storeu_ps(b + (size_t) (j + 2) * ldb + i, r2);
+                    _mm_storeu_ps(b + (size_t) (j + 3) * ldb + i, r3);
+                }
+                transpose_bloc_scalar(i, i + 4, j, j1, a, lda, b, ldb);
+            }
+            transpose_bloc_scalar(i, i1, j0, j1, a, lda, b, ldb);
+        }
+    }
+}
+
+__attribute__((target("sse2")))
+static void gemm_micro_sse2(unsigned int kc, E alpha, const E * ap, const E * bp,
+                            E beta, E * c, unsigned int ldc,
+                            unsigned int mr, unsigned int nr) {
+    __m128 c00 = _mm_setzero_ps(), c01 = _mm_setzero_ps();
+    __m128 c10 = _mm_setzero_ps(), c11 = _mm_setzero_ps();
+    __m128 c20 = _mm_setzero_ps(), c21 = _mm_setzero_ps();
+    __m128 c30 = _mm_setzero_ps(), c31 = _mm_setzero_ps();
+    __m128 b0, b1, av;
+    unsigned int p, i;
+
+    for (p = 0; p < kc; p++) {
+        b0 = _mm_loadu_ps(bp);
+        b1 = _mm_loadu_ps(bp + 4);
+        av = _mm_set1_ps(ap[0]);
+        c00 = _mm_add_ps(c00, _mm_mul_ps(av, b0)); c01 = _mm_add_ps(c01, _mm_mul_ps(av, b1));
+        av = _mm_set1_ps(ap[1]);
+        c10 = _mm_add_ps(c10, _mm_mul_ps(av, b0)); c11 = _mm_add_ps(c11, _mm_mul_ps(av, b1));
+        av = _mm_set1_ps(ap[2]);
+        c20 = _mm_add_ps(c20, _mm_mul_ps(av, b0)); c21 = _mm_add_ps(c21, _mm_mul_ps(av, b1));
+        av = _mm_set1_ps(ap[3]);
+        c30 = _mm_add_ps(c30, _mm_mul_ps(av, b0)); c31 = _mm_add_ps(c31, _mm_mul_ps(av, b1));
+        ap += SSE2_MR;
+        bp += SSE2_NR;
+    }
+
+    __m128 acc[SSE2_MR][2] = { { c00, c01 }, { c10, c11 }, { c20, c21 }, { c30, c31 } };
+
+    if (mr == SSE2_MR && nr == SSE2_NR) {
+        __m128 va = _mm_set1_ps(alpha), vb = _mm_set1_ps(beta);
+        for (i = 0; i < SSE2_MR; i++) {
+            E * ci = c + (size_t) i * ldc;
+            if (beta == 0) {
+                _mm_storeu_ps(ci,     _mm_mul_ps(va, acc[i][0]));
+                _mm_storeu_ps(ci + 4, _mm_mul_ps(va, acc[i][1]));
+            } else {
+                _mm_storeu_ps(ci,     _mm_add_ps(_mm_mul_ps(vb, _mm_loadu_ps(ci)),     _mm_mul_ps(va, acc[i][0])));
+                _mm_storeu_ps(ci + 4, _mm_add_ps(_mm_mul_ps(vb, _mm_loadu_ps(ci + 4)), _mm_mul_ps(va, acc[i][1])));
+            }
+        }
+    } else {
+        E tmp[SSE2_MR * SSE2_NR];
+        for (i = 0; i < SSE2_MR; i++) {
+            _mm_storeu_ps(tmp + i * SSE2_NR,     acc[i][0]);
+            _mm_storeu_ps(tmp + i * SSE2_NR + 4, acc[i][1]);
+        }
+        store_tile(tmp, SSE2_NR, mr, nr, alpha, beta, c, ldc);
+    }
+}
+
+static const kernels_t kernels_sse2 = {
+    "sse2", SSE2_MR, SSE2_NR,
+    add_sse2, scale_sse2, copy_all, transpose_sse2, gemm_micro_sse2
+};
+
+
+// ---------------------------------------------------------------------
+// AVX2 + FMA (8 flottants par registre)
+// ---------------------------------------------------------------------
+
+#define AVX2_MR 6
+#define AVX2_NR 16
+
+__attribute__((target("avx2")))
+static void add_avx2(size_t n, const E * x, const E * y, E * z) {
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        _mm256_storeu_ps(z + i, _mm256_add_ps(_mm256_loadu_ps(x + i), _mm256_loadu_ps(y + i)));
+    }
+    for (; i < n; i++) z[i] = x[i] + y[i];
+}
+
+__attribute__((target("avx2")))
+static void scale_avx2(size_t n, E s, const E * x, E * y) {
+    size_t i = 0;
+    __m256 vs = _mm256_set1_ps(s);
+    for (; i + 8 <= n; i += 8) {
+        _mm256_storeu_ps(y + i, _mm256_mul_ps(vs, _mm256_loadu_ps(x + i)));
+    }
+    for (; i < n; i++) y[i] = s * x[i];
+}
+
+// Transpose un bloc 8x8 dans les registres
+__attribute__((target("avx2")))
+static inline void transpose8x8_avx2(const E * a, unsigned int lda, E * b, unsigned int ldb) {
+    __m256 r0, r1, r2, r3, r4, r5, r6, r7;
+    __m256 t0, t1, t2, t3, t4, t5, t6, t7;
+
+    r0 = _mm256_loadu_ps(a + (size_t) 0 * lda);
+    r1 = _mm256_loadu_ps(a + (size_t) 1 * lda);
+    r2 = _mm256_loadu_ps(a + (size_t) 2 * lda);
+    r3 = _mm256_loadu_ps(a + (size_t) 3 * lda);
+    r4 = _mm256_loadu_ps(a + (size_t) 4 * lda);
+    r5 = _mm256_loadu_ps(a + (size_t) 5 * lda);
+    r6 = _mm256_loadu_ps(a + (size_t) 6 * lda);
+    r7 = _mm256_loadu_ps(a + (size_t) 7 * lda);
+
+    t0 = _mm256_unpacklo_ps(r0, r1);
+    t1 = _mm256_unpackhi_ps(r0, r1);
+    t2 = _mm256_unpacklo_ps(r2, r3);
+    t3 = _mm256_unpackhi_ps(r2, r3);
+    t4 = _mm256_unpacklo_ps(r4, r5);
+    t5 = _mm256_unpackhi_ps(r4, r5);
+    t6 = _mm256_unpacklo_ps(r6, r7);
+    t7 = _mm256_unpackhi_ps(r6, r7);
+
+    r0 = _mm256_shuffle_ps(t0, t2, _MM_SHUFFLE(1, 0, 1, 0));
+    r1 = _mm256_shuffle_ps(t0, t2, _MM_SHUFFLE(3, 2, 3, 2));
+    r2 = _mm256_shuffle_ps(t1, t3, _MM_SHUFFLE(1, 0, 1, 0));
+    r3 = _mm256_shuffle_ps(t1, t3, _MM_SHUFFLE(3, 2, 3, 2));
+    r4 = _mm256_shuffle_ps(t4, t6, _MM_SHUFFLE(1, 0, 1, 0));
+    r5 = _mm256_shuffle_ps(t4, t6, _MM_SHUFFLE(3, 2, 3, 2));
+    r6 = _mm256_shuffle_ps(t5, t7, _MM_SHUFFLE(1, 0, 1, 0));
+    r7 = _mm256_shuffle_ps(t5, t7, _MM_SHUFFLE(3, 2, 3, 2));
+
+    _mm256_storeu_ps(b + (size_t) 0 * ldb, _mm256_permute2f128_ps(r0, r4, 0x20));
+    _mm256_storeu_ps(b + (size_t) 1 * ldb, _mm256_permute2f128_ps(r1, r5, 0x20));
+    _mm256_storeu_ps(b + (size_t) 2 * ldb, _mm256_permute2f128_ps(r2, r6, 0x20));
+    _mm256_storeu_ps(b + (size_t) 3 * ldb, _mm256_permute2f128_ps(r3, r7, 0x20));
+    _mm256_storeu_ps(b + (size_t) 4 * ldb, _mm256_permute2f128_ps(r0, r4, 0x31));
+    _mm256_storeu_ps(b + (size_t) 5 * ldb, _mm256_permute2f128_ps(r1, r5, 0x31));
+    _mm256_storeu_ps(b + (size_t) 6 * ldb, _mm256_permute2f128_ps(r2, r6, 0x31));
+    _mm256_storeu_ps(b + (size_t) 7 * ldb, _mm256_permute2f128_ps(r3, r7, 0x31));
+}
+
+__attribute__((target("avx2")))
+static void transpose_avx2(unsigned int rows, unsigned int cols,
+                           const E * a, unsigned int lda, E * b, unsigned int ldb) {
+    unsigned int i0, j0, i, j, i1, j1;
+
+    for (i0 = 0; i0 < rows; i0 += TRANSPOSE_BLOC) {
+        i1 = rows - i0 < TRANSPOSE_BLOC ? rows : i0 + TRANSPOSE_BLOC;
+        for (j0 = 0; j0 < cols; j0 += TRANSPOSE_BLOC) {
+            j1 = cols - j0 < TRANSPOSE_BLOC ? cols : j0 + TRANSPOSE_BLOC;
+            for (i = i0; i + 8 <= i1; i += 8) {
+                for (j = j0; j + 8 <= j1; j += 8) {
+                    transpose8x8_avx2(a + (size_t) i * lda + j, lda, b + (size_t) j * ldb + i, ldb);
+                }
+                transpose_bloc_scalar(i, i + 8, j, j1, a, lda, b, ldb);
+            }
+            transpose_bloc_scalar(i, i1, j0, j1, a, lda, b, ldb);
+        }
+    }
+}
+
+#define AVX2_FMA_ROW(r, c0, c1) \
+    av = _mm256_broadcast_ss(ap + r); \
+    c0 = _mm256_fmadd_ps(av, b0, c0); \
+    c1 = _mm256_fmadd_ps(av, b1, c1);
+
+__attribute__((target("avx2,fma")))
+static void gemm_micro_avx2(unsigned int kc, E alpha, const E * ap, const E * bp,
+                            E beta, E * c, unsigned int ldc,
+                            unsigned int mr, unsigned int nr) {
+    __m256 c00 = _mm256_setzero_ps(), c01 = _mm256_setzero_ps();
+    __m256 c10 = _mm256_setzero_ps(), c11 = _mm256_setzero_ps();
+    __m256 c20 = _mm256_setzero_ps(), c21 = _mm256_setzero_ps();
+    __m256 c30 = _mm256_setzero_ps(), c31 = _mm256_setzero_ps();
+    __m256 c40 = _mm256_setzero_ps(), c41 = _mm256_setzero_ps();
+    __m256 c50 = _mm256_setzero_ps(), c51 = _mm256_setzero_ps();
+    __m256 b0, b1, av;
+    unsigned int p, i;
+
+    for (p = 0; p < kc; p++) {
+        b0 = _mm256_loadu_ps(bp);
+        b1 = _mm256_loadu_ps(bp + 8);
+        AVX2_FMA_ROW(0, c00, c01)
+        AVX2_FMA_ROW(1, c10, c11)
+        AVX2_FMA_ROW(2, c20, c21)
+        AVX2_FMA_ROW(3, c30, c31)
+        AVX2_FMA_ROW(4, c40, c41)
+        AVX2_FMA_ROW(5, c50, c51)
+        ap += AVX2_MR;
+        bp += AVX2_NR;
+    }
+
+    __m256 acc[AVX2_MR][2] = {
+        { c00, c01 }, { c10, c11 }, { c20, c21 },
+        { c30, c31 }, { c40, c41 }, { c50, c51 }
+    };
+
+    if (mr == AVX2_MR && nr == AVX2_NR) {
+        __m256 va = _mm256_set1_ps(alpha), vb = _mm256_set1_ps(beta);
+        for (i = 0; i < AVX2_MR; i++) {
+            E * ci = c + (size_t) i * ldc;
+            if (beta == 0) {
+                _mm256_storeu_ps(ci,     _mm256_mul_ps(va, acc[i][0]));
+                _mm256_storeu_ps(ci + 8, _mm256_mul_ps(va, acc[i][1]));
+            } else {
+                _mm256_storeu_ps(ci,     _mm256_fmadd_ps(va, acc[i][0], _mm256_mul_ps(vb, _mm256_loadu_ps(ci))));
+                _mm256_storeu_ps(ci + 8, _mm256_fmadd_ps(va, acc[i][1], _mm256_mul_ps(vb, _mm256_loadu_ps(ci + 8))));
+            }
+        }
+    } else {
+        E tmp[AVX2_MR * AVX2_NR];
+        for (i = 0; i < AVX2_MR; i++) {
+            _mm256_storeu_ps(tmp + i * AVX2_NR,     acc[i][0]);
+            _mm256_storeu_ps(tmp + i * AVX2_NR + 8, acc[i][1]);
+        }
+        store_tile(tmp, AVX2_NR, mr, nr, alpha, beta, c, ldc);
+    }
+}
+
+static const kernels_t kernels_avx2 = {
+    "avx2", AVX2_MR, AVX2_NR,
+    add_avx2, scale_avx2, copy_all, transpose_avx2, gemm_micro_avx2
+};
+
+
+// ---------------------------------------------------------------------
+// AVX-512 (16 flottants par registre)
+// ---------------------------------------------------------------------
+
+#define AVX512_MR 6
+#define AVX512_NR 32
+
+__attribute__((target("avx512f")))
+static void add_avx512(size_t n, const E * x, const E * y, E * z) {
+    size_t i = 0;
+    for (; i + 16 <= n; i += 16) {
+        _mm512_storeu_ps(z + i, _mm512_add_ps(_mm512_loadu_ps(x + i), _mm512_loadu_ps(y + i)));
+    }
+    if (i < n) {
+        __mmask16 k = (__mmask16) ((1u << (n - i)) - 1);
+        _mm512_mask_storeu_ps(z + i, k, _mm512_add_ps(_mm512_maskz_loadu_ps(k, x + i),
+                                                      _mm512_maskz_loadu_ps(k, y + i)));
+    }
+}
+
+__attribute__((target("avx512f")))
+static void scale_avx512(size_t n, E s, const E * x, E * y) {
+    size_t i = 0;
+    __m512 vs = _mm512_set1_ps(s);
+    for (; i + 16 <= n; i += 16) {
+        _mm512_storeu_ps(y + i, _mm512_mul_ps(vs, _mm512_loadu_ps(x + i)));
+    }
+    if (i < n) {
+        __mmask16 k = (__mmask16) ((1u << (n - i)) - 1);
+        _mm512_mask_storeu_ps(y + i, k, _mm512_mul_ps(vs, _mm512_maskz_loadu_ps(k, x + i)));
+    }
+}
+
+#define AVX512_FMA_ROW(r, c0, c1) \
+    av = _mm512_set1_ps(ap[r]); \
+    c0 = _mm512_fmadd_ps(av, b0, c0); \
+    c1 = _mm512_fmadd_ps(av, b1, c1);
+
+__attribute__((target("avx512f")))
+static void gemm_micro_avx512(unsigned int kc, E alpha, const E * ap, const E * bp,
+                              E beta, E * c, unsigned int ldc,
+                              unsigned int mr, unsigned int nr) {
+    __m512 c00 = _mm512_setzero_ps(), c01 = _mm512_setzero_ps();
+    __m512 c10 = _mm512_setzero_ps(), c11 = _mm512_setzero_ps();
+    __m512 c20 = _mm512_setzero_ps(), c21 = _mm512_setzero_ps();
+    __m512 c30 = _mm512_setzero_ps(), c31 = _mm512_setzero_ps();
+    __m512 c40 = _mm512_setzero_ps(), c41 = _mm512_setzero_ps();
+    __m512 c50 = _mm512_setzero_ps(), c51 = _mm512_setzero_ps();
+    __m512 b0, b1, av;
+    unsigned int p, i;
+
+    for (p = 0; p < kc; p++) {
+        b0 = _mm512_loadu_ps(bp);
+        b1 = _mm512_loadu_ps(bp + 16);
+        AVX512_FMA_ROW(0, c00, c01)
+        AVX512_FMA_ROW(1, c10, c11)
+        AVX512_FMA_ROW(2, c20, c21)
+        AVX512_FMA_ROW(3, c30, c31)
+        AVX512_FMA_ROW(4, c40, c41)
+        AVX512_FMA_ROW(5, c50, c51)
+        ap += AVX512_MR;
+        bp += AVX512_NR;
+    }
+
+    __m512 acc[AVX512_MR][2] = {
+        { c00, c01 }, { c10, c11 }, { c20, c21 },
+        { c30, c31 }, { c40, c41 }, { c50, c51 }
+    };
+
+    if (mr == AVX512_MR && nr == AVX512_NR) {
+        __m512 va = _mm512_set1_ps(alpha), vb = _mm512_set1_ps(beta);
+        for (i = 0; i < AVX512_MR; i++) {
+            E * ci = c + (size_t) i * ldc;
+            if (beta == 0) {
+                _mm512_storeu_ps(ci,      _mm512_mul_ps(va, acc[i][0]));
+                _mm512_storeu_ps(ci + 16, _mm512_mul_ps(va, acc[i][1]));
+            } else {
+                _mm512_storeu_ps(ci,      _mm512_fmadd_ps(va, acc[i][0], _mm512_mul_ps(vb, _mm512_loadu_ps(ci))));
+                _mm512_storeu_ps(ci + 16, _mm512_fmadd_ps(va, acc[i][1], _mm512_mul_ps(vb, _mm512_loadu_ps(ci + 16))));
+            }
+        }
+    } else {
+        E tmp[AVX512_MR * AVX512_NR];
+        for (i = 0; i < AVX512_MR; i++) {
+            _mm512_storeu_ps(tmp + i * AVX512_NR,      acc[i][0]);
+            _mm512_storeu_ps(tmp + i * AVX512_NR + 16, acc[i][1]);
+        }
+        store_tile(tmp, AVX512_NR, mr, nr, alpha, beta, c, ldc);
+    }
+}
+
+// La transposition 8x8 AVX2 est déjà limitée par la mémoire, on la garde
+static const kernels_t kernels_avx512 = {
+    "avx512", AVX512_MR, AVX512_NR,
+    add_avx512, scale_avx512, copy_all, transpose_avx2, gemm_micro_avx512
+};
+
+
+// ---------------------------------------------------------------------
+// Détection du jeu d'instructions
+// ---------------------------------------------------------------------
+
+// Registre XCR0 : états des registres sauvegardés par le système
+static unsigned long long read_xcr0(void) {
+    unsigned int eax, edx;
+    __asm__ volatile ("xgetbv" : "=a" (eax), "=d" (edx) : "c" (0));
+    return ((unsigned long long) edx << 32) | eax;
+}
+
+// Retourne les meilleurs noyaux supportés à la fois par le processeur
+// et par le système (qui doit sauvegarder les registres étendus)
+static const kernels_t * detect_kernels(void) {
+    unsigned int eax, ebx, ecx, edx, ecx1, edx1;
+    unsigned long long xcr0 = 0;
+    int avx_os = 0, avx512_os = 0;
+
+    if (!__get_cpuid(1, &eax, &ebx, &ecx1, &edx1)) return &kernels_scalar;
+
+    if (ecx1 & bit_OSXSAVE) {
+        xcr0 = read_xcr0();
+        avx_os = (xcr0 & 0x6) == 0x6;         // XMM et YMM
+        avx512_os = (xcr0 & 0xE6) == 0xE6;    // + opmask, ZMM
+    }
+
+    if (__get_cpuid_count(7, 0, &eax, &ebx, &ecx, &edx)) {
+        if (avx512_os && (ebx & bit_AVX512F) && (ebx & bit_AVX2) && (ecx1 & bit_FMA)) {
+            return &kernels_avx512;
+        }
+        if (avx_os && (ebx & bit_AVX2) && (ecx1 & bit_FMA) && (ecx1 & bit_AVX)) {
+            return &kernels_avx2;
+        }
+    }
+
+    if (edx1 & bit_SSE2) return &kernels_sse2;
+
+    return &kernels_scalar;
+}
+
+#else
+
+static const kernels_t * detect_kernels(void) {
+    return &kernels_scalar;
+}
+
+#endif
+
+
+// Choix des noyaux : la détection peut être bridée par MATRIX_ISA
+// (on ne monte jamais au-dessus de ce que le processeur supporte)
+static const kernels_t * choose_kernels(void) {
+    const kernels_t * best = detect_kernels();
+    const char * isa = getenv("MATRIX_ISA");
+
+    if (!isa) return best;
+    if (!strcmp(isa, "scalar")) return &kernels_scalar;
+#ifdef KERNELS_X86
+    if (!strcmp(isa, "sse2") && best != &kernels_scalar) return &kernels_sse2;
+    if (!strcmp(isa, "avx2") && (best == &kernels_avx2 || best == &kernels_avx512)) return &kernels_avx2;
+#endif
+    return best;
+}
+
+const kernels_t * kernels(void) {
+    static const kernels_t * k = NULL;
+    const kernels_t * r = __atomic_load_n(&k, __ATOMIC_ACQUIRE);
+
+    if (!r) {
+        r = choose_kernels();
+        __atomic_store_n(&k, r, __ATOMIC_RELEASE);
+    }
+    return r;
+}
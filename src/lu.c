@@ -0,0 +1,272 @@
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+#include "system.h"
+#include "matrix.h"
+#include "threadpool.h"
+#include "gemm.h"
+#include "trsm.h"
+#include "cholesky.h"
+#include "lu.h"
+
+// Largeur des panneaux de la factorisation par blocs
+#define LU_NB 128
+
+// Arguments partagés par les morceaux de la factorisation
+typedef struct {
+    E * a;
+    unsigned int n;
+    unsigned int k;     // colonne du pivot (panneau) ou début du bloc (TRSM)
+    unsigned int fin;   // fin du panneau : colonnes [k, fin[
+} args_lu;
+
+// Panneau : élimine la colonne k des lignes [debut, fin[, en ne mettant
+// à jour que les colonnes du panneau (le reste est fait par GEMM)
+static void panneau_morceau(void * arg, size_t debut, size_t fin) {
+    args_lu * a = arg;
+    unsigned int n = a->n, j, k = a->k;
+    E * pivot = a->a + (size_t) k * n;
+    E q;
+    size_t i;
+
+    for (i = debut; i < fin; i++) {
+        E * ligne = a->a + i * n;
+        q = ligne[k] /= pivot[k];
+        for (j = k + 1; j < a->fin; j++) ligne[j] -= q * pivot[j];
+    }
+}
+
+// Bloc U12 : résout L11 U12 = A12 (L11 triangulaire inférieure unité)
+// sur les colonnes [debut, fin[ des lignes du panneau
+static void trsm_morceau(void * arg, size_t debut, size_t fin) {
+    args_lu * a = arg;
+    unsigned int n = a->n, i, p;
+    E * li, * lp, l;
+    size_t j;
+
+    for (i = a->k + 1; i < a->fin; i++) {
+        li = a->a + (size_t) i * n;
+        for (p = a->k; p < i; p++) {
+            l = li[p];
+            if (l == 0) continue;
+            lp = a->a + (size_t) p * n;
+            for (j = debut; j < fin; j++) li[j] -= l * lp[j];
+        }
+    }
+}
+
+// Échange deux lignes de longueur n
+static void echanger_lignes(E * a, E * b, unsigned int n) {
+    unsigned int j;
+    E tmp;
+
+    for (j = 0; j < n; j++) {
+        tmp = a[j];
+        a[j] = b[j];
+        b[j] = tmp;
+    }
+}
+
+// Factorisation LU par blocs, en place (variante « right-looking ») :
+// pour chaque panneau de LU_NB colonnes,
+//   1. factorisation du panneau avec pivot partiel (lignes entières échangées)
+//   2. U12 = L11^-1 A12
+//   3. mise à jour du reste A22 -= L21 U12 avec GEMM
+// La matrice m est réutilisée pour stocker L et U : prec : m carrée
+LU decomposition_LU_en_place(Matrix m) {
+    unsigned int n = m->nb_rows, i, k, k0, k1, p;
+    E max, v;
+    LU f;
+    args_lu a;
+
+    f.lu = m;
+    f.piv = allouer(n, sizeof(unsigned int));
+    f.signe = 1;
+    f.singuliere = 0;
+    a.a = m->mat;
+    a.n = n;
+
+    for (k0 = 0; k0 < n; k0 = k1) {
+        k1 = n - k0 < LU_NB ? n : k0 + LU_NB;
+
+        // 1. panneau [k0, k1[
+        a.fin = k1;
+        for (k = k0; k < k1; k++) {
+            // recherche du pivot de plus grande valeur absolue
+            p = k;
+            max = fabsf(a.a[(size_t) k * n + k]);
+            for (i = k + 1; i < n; i++) {
+                v = fabsf(a.a[(size_t) i * n + k]);
+                if (v > max) {
+                    max = v;
+                    p = i;
+                }
+            }
+            f.piv[k] = p;
+            if (p != k) {
+                echanger_lignes(a.a + (size_t) k * n, a.a + (size_t) p * n, n);
+                f.signe = -f.signe;
+            }
+            if (max == 0) {
+                f.singuliere = 1;
+                continue;
+            }
+            a.k = k;
+            parallel_for(k + 1, n, PARALLEL_SEUIL / (2 * (k1 - k)) + 1, panneau_morceau, &a);
+        }
+
+        if (k1 == n) break;
+
+        // 2. U12 = L11^-1 A12
+        a.k = k0;
+        parallel_for(k1, n, PARALLEL_SEUIL / ((k1 - k0) * (k1 - k0)) + 1, trsm_morceau, &a);
+
+        // 3. A22 -= L21 U12
+        gemm(n - k1, n - k1, k1 - k0,
+             -1, a.a + (size_t) k1 * n + k0, n,
+             a.a + (size_t) k0 * n + k1, n,
+             1, a.a + (size_t) k1 * n + k1, n);
+    }
+
+    return f;
+}
+
+// Factorisation LU avec pivot partiel d'une copie de m
+// prec : m doit être carrée
+LU decomposition_LU(Matrix m) {
+    return decomposition_LU_en_place(new_matrix_copy(m));
+}
+
+void deleteLU(LU f) {
+    deleteMatrix(f.lu);
+    free(f.piv);
+}
+
+// Déterminant : produit de la diagonale de U (accumulé en double)
+E det_LU(LU f) {
+    unsigned int i, n = f.lu->nb_rows;
+    double d = f.signe;
+
+    if (f.singuliere) return 0;
+    for (i = 0; i < n; i++) d *= f.lu->mat[(size_t) i * n + i];
+
+    return d;
+}
+
+// Logarithme de la valeur absolue du déterminant : ne déborde pas même
+// quand le déterminant dépasse la plage des flottants.
+// signe reçoit le signe du déterminant (-1, 0 ou 1).
+// prec : m doit être carrée
+E log_det(Matrix m, int * signe) {
+    LU f;
+    Matrix l;
+    unsigned int i, n = m->nb_rows;
+    double somme = 0;
+    E u;
+
+    if (isSymetric(m) && (l = decomposition_cholesky(m))) {
+        *signe = 1;
+        somme = log_det_cholesky(l);
+        deleteMatrix(l);
+        return somme;
+    }
+
+    f = decomposition_LU(m);
+
+    *signe = f.signe;
+    for (i = 0; i < n && *signe; i++) {
+        u = f.lu->mat[(size_t) i * n + i];
+        if (u == 0) *signe = 0;
+        else {
+            if (u < 0) *signe = -*signe;
+            somme += log(fabs(u));
+        }
+    }
+    deleteLU(f);
+
+    return *signe ? somme : -INFINITY;
+}
+
+// Résout A X = B à partir de la factorisation de A : permutation des
+// lignes de B puis deux résolutions triangulaires par blocs
+// prec : f non singulière, b a autant de lignes que A
+Matrix resolution_LU(LU f, Matrix b) {
+    unsigned int n = f.lu->nb_rows, m = b->nb_columns, k;
+    Matrix x = new_matrix_copy(b);
+
+    for (k = 0; k < n; k++) {
+        if (f.piv[k] != k) echanger_lignes(x->mat + (size_t) k * m, x->mat + (size_t) f.piv[k] * m, m);
+    }
+
+    // L Y = P B puis U X = Y
+    trsm(TRI_INF, 0, 1, n, m, f.lu->mat, n, x->mat, m);
+    trsm(TRI_SUP, 0, 0, n, m, f.lu->mat, n, x->mat, m);
+
+    return x;
+}
+
+// Inverse à partir de la factorisation (NULL si la matrice est singulière)
+Matrix inversion_LU(LU f) {
+    Matrix id, r;
+
+    if (f.singuliere) return NULL;
+
+    id = matrix_identite(f.lu->nb_rows);
+    r = resolution_LU(f, id);
+    deleteMatrix(id);
+
+    return r;
+}
+
+// Permutation de PA = LU : la ligne i de PA est la ligne perm[i] de A
+unsigned int * LU_permutation(LU f) {
+    unsigned int n = f.lu->nb_rows, i, k, tmp;
+    unsigned int * perm = allouer(n, sizeof(unsigned int));
+
+
+    for (i = 0; i < n; i++) perm[i] = i;
+    for (k = 0; k < n; k++) {
+        tmp = perm[k];
+        perm[k] = perm[f.piv[k]];
+        perm[f.piv[k]] = tmp;
+    }
+
+    return perm;
+}
+
+// Matrice de permutation P telle que PA = LU
+Matrix LU_p(LU f) {
+    unsigned int n = f.lu->nb_rows, i;
+    unsigned int * perm = LU_permutation(f);
+    Matrix p = newMatrix(n, n);
+
+    for (i = 0; i < n; i++) setElt(p, i, perm[i], 1);
+
+    free(perm);
+    return p;
+}
+
+// Facteur L (triangulaire inférieur, diagonale unité)
+Matrix LU_l(LU f) {
+    unsigned int n = f.lu->nb_rows, i;
+    Matrix l = newMatrix(n, n);
+
+    for (i = 0; i < n; i++) {
+        memcpy(l->mat + (size_t) i * n, f.lu->mat + (size_t) i * n, i * sizeof(E));
+        setElt(l, i, i, 1);
+    }
+
+    return l;
+}
+
+// Facteur U (triangulaire supérieur)
+Matrix LU_u(LU f) {
+    unsigned int n = f.lu->nb_rows, i;
+    Matrix u = newMatrix(n, n);
+
+    for (i = 0; i < n; i++) {
+        memcpy(u->mat + (size_t) i * n + i, f.lu->mat + (size_t) i * n + i, (n - i) * sizeof(E));
+    }
+
+    return u;
+}
@@ -5,6 +5,12 @@
 #include <unistd.h>
 #include "system.h"
 #include "matrix.h"
+#include "gemm.h"
+#include "kernels.h"
+#include "threadpool.h"
+#include "lu.h"
+#include "cholesky.h"
+#include "qr.h"
 
 
 // Permet de générer une nouvelle matrice
@@ -27,6 +33,16 @@ Matrix newMatrix_tab(unsigned int nb_rows, unsigned int nb_columns, E * tab) {
     return m;
 }
 
+// Permet de générer une matrice qui prend possession du tableau tab,
+// sans le copier
+Matrix newMatrix_buffer(unsigned int nb_rows, unsigned int nb_columns, E * tab) {
+    Matrix m = allouer(1, sizeof(struct matrix));
+    m->nb_rows = nb_rows;
+    m->nb_columns = nb_columns;
+    m->mat = tab;
+    return m;
+}
+
 // Permet de récupérer un élément d'une matrice
 E getElt(Matrix m, unsigned int row, unsigned int column) {
     return m->mat[m->nb_columns*row + column];
@@ -44,14 +60,42 @@ void deleteMatrix(Matrix m) {
     free(m);
 }
 
+// Arguments des opérations élément par élément découpées sur le pool
+typedef struct {
+    const E * x;
+    const E * y;
+    E * z;
+    E s;
+    unsigned int lx;    // pas de x (transposition)
+    unsigned int lz;    // pas de z (transposition)
+    unsigned int nb;    // colonnes de x (transposition)
+} args_elt;
+
+static void copy_morceau(void * arg, size_t debut, size_t fin) {
+    args_elt * a = arg;
+    kernels()->copy(fin - debut, a->x + debut, a->z + debut);
+}
+
+static void addition_morceau(void * arg, size_t debut, size_t fin) {
+    args_elt * a = arg;
+    kernels()->add(fin - debut, a->x + debut, a->y + debut, a->z + debut);
+}
+
+static void scale_morceau(void * arg, size_t debut, size_t fin) {
+    args_elt * a = arg;
+    kernels()->scale(fin - debut, a->s, a->x + debut, a->z + debut);
+}
+
+// Transpose les lignes [debut, fin[ de x
+static void transpose_morceau(void * arg, size_t debut, size_t fin) {
+    args_elt * a = arg;
+    kernels()->transpose(fin - debut, a->nb, a->x + debut * a->lx, a->lx, a->z + debut, a->lz);
+}
+
 // pre-cond : dest et source de même dimensions
 void copy_matrix(Matrix source, Matrix dest) {
-    unsigned int i, j;
-    for (i = 0; i < source->nb_rows; i++) {
-        for (j = 0; j < source->nb_columns; j++) {
-            setElt(dest, i, j, getElt(source, i, j));
-        }
-    }
+    args_elt a = { source->mat, NULL, dest->mat, 0, 0, 0, 0 };
+    parallel_for(0, (size_t) source->nb_rows * source->nb_columns, PARALLEL_SEUIL, copy_morceau, &a);
 }
 
 // Copie le contenu d'une matrice
@@ -82,16 +126,23 @@ int isTriangulaire(Matrix m) {
     return 1;
 }
 
-// Teste si une matrice est symétrique
+// Teste si une matrice est symétrique : on ne parcourt que le triangle
+// supérieur, par blocs pour que les lectures en colonne restent en cache,
+// et on s'arrête à la première différence
 int isSymetric(Matrix m) {
-    unsigned int i, j, n = 0;
+    unsigned int i0, j0, i, j, i1, j1, n = m->nb_rows;
+    const unsigned int bloc = 64;
+
     if (!isSquare(m)) return 0;
-    for (i = 0; i < m->nb_rows; i++) {
-        for (j = 0; j < m->nb_columns; j++) {
-            if (getElt(m, i, j) != getElt(m, j, i)) {
-                return 0;
+    for (i0 = 0; i0 < n; i0 += bloc) {
+        i1 = n - i0 < bloc ? n : i0 + bloc;
+        for (j0 = i0; j0 < n; j0 += bloc) {
+            j1 = n - j0 < bloc ? n : j0 + bloc;
+            for (i = i0; i < i1; i++) {
+                for (j = (j0 > i + 1 ? j0 : i + 1); j < j1; j++) {
+                    if (m->mat[(size_t) i * n + j] != m->mat[(size_t) j * n + i]) return 0;
+                }
             }
-            n++;
         }
     }
     return 1;
@@ -100,15 +151,11 @@ int isSymetric(Matrix m) {
 // Retourne la transposée de la matrice
 Matrix transpose(Matrix m) {
 
-    unsigned int i, j;
-
     Matrix r = newMatrix(m->nb_columns, m->nb_rows);
+    args_elt a = { m->mat, NULL, r->mat, 0, m->nb_columns, r->nb_columns, m->nb_columns };
 
-    for (i = 0; i < m->nb_rows; i++) {
-        for (j = 0; j < m->nb_columns; j++) {
-            setElt(r, j, i, getElt(m, i, j));
-        }
-    }
+    // morceaux de lignes multiples de 64 pour garder les blocs du noyau
+    parallel_for(0, m->nb_rows, (PARALLEL_SEUIL / (m->nb_columns + 1) + 63) & ~63u, transpose_morceau, &a);
 
     return r;
 }
@@ -150,47 +197,47 @@ Matrix matrix_identite(unsigned int n) {
 // == pré-condition : m1 et m2 doivent être de même dimension
 Matrix addition(Matrix m1, Matrix m2) {
     Matrix m = newMatrix(m1->nb_rows, m1->nb_columns);
-    unsigned int i, j;
+    args_elt a = { m1->mat, m2->mat, m->mat, 0, 0, 0, 0 };
 
-    for (i = 0; i < m->nb_rows; i++) {
-        for (j = 0; j < m->nb_columns; j++) {
-            setElt(m, i, j, getElt(m1, i, j) + getElt(m2, i, j));
-        }
-    }
+    parallel_for(0, (size_t) m->nb_rows * m->nb_columns, PARALLEL_SEUIL, addition_morceau, &a);
 
     return m;
 }
 
+static double carres_morceau(void * arg, size_t debut, size_t fin) {
+    const E * x = arg;
+    double somme = 0;
+    size_t i;
+    for (i = debut; i < fin; i++) somme += (double) x[i] * x[i];
+    return somme;
+}
+
+// Norme de Frobenius (racine de la somme des carrés des éléments)
+E norme(Matrix m) {
+    return sqrt(parallel_reduce(0, (size_t) m->nb_rows * m->nb_columns, PARALLEL_SEUIL, carres_morceau, m->mat));
+}
+
 // Multiplie une matrice par un scalaire
 Matrix mult_scalar(E s, Matrix m) {
     Matrix r = newMatrix(m->nb_rows, m->nb_columns);
-    unsigned int i;
+    args_elt a = { m->mat, NULL, r->mat, s, 0, 0, 0 };
 
-    copy_matrix(m, r);
-    for (i = 0; i < m->nb_rows * m->nb_columns; i++) {
-        r->mat[i] *= s;
-    }
+    parallel_for(0, (size_t) m->nb_rows * m->nb_columns, PARALLEL_SEUIL, scale_morceau, &a);
 
     return r;
 }
 
 // Permet d'effectuer la multiplicaton de deux matrices
+// (délègue au noyau GEMM par blocs, voir gemm.c)
 Matrix multiplication(Matrix a, Matrix b) {
     if (a->nb_columns != b->nb_rows) return NULL;
 
     Matrix r = newMatrix(a->nb_rows, b->nb_columns);
-    unsigned int i, j, k;
-    E val;
 
-    for (i = 0; i < r->nb_rows; i++) {
-        for (j = 0; j < r->nb_columns; j++) {
-            val = 0;
-            for (k = 0; k < a->nb_columns; k++) {
-                val += getElt(b, k, j) * getElt(a, i, k);
-            }
-            setElt(r, i, j, val);
-        }
-    }
+    gemm(a->nb_rows, b->nb_columns, a->nb_columns,
+         1, a->mat, a->nb_columns,
+         b->mat, b->nb_columns,
+         0, r->mat, r->nb_columns);
 
     return r;
 }
@@ -215,10 +262,11 @@ Matrix extraction(Matrix m, unsigned int row, unsigned int column) {
     return r;
 }
 
-// déterminant avec les comatrices
+// déterminant par factorisation LU (O(n^3))
 E det(Matrix m) {
-    unsigned int i;
-    E somme = 0;
+    LU f;
+    Matrix l;
+    E d;
 
     if (!isSquare(m)) {
         fprintf(stderr, "La matrice n'est pas carrée\n");
@@ -233,31 +281,43 @@ E det(Matrix m) {
         return getElt(m, 0, 0) * getElt(m, 1, 1) - (getElt(m, 0, 1) * getElt(m, 1, 0));
     }
 
-    for (i = 0; i < m->nb_rows; i++) {
-        somme += (i%2 == 0 ? 1 : -1) * getElt(m, 0, i) * (det(extraction(m, 0, i)));
+    // matrice symétrique définie positive : Cholesky (deux fois moins cher)
+    if (isSymetric(m) && (l = decomposition_cholesky(m))) {
+        d = det_cholesky(l);
+        deleteMatrix(l);
+        return d;
     }
 
-    return somme;
+    f = decomposition_LU(m);
+    d = det_LU(f);
+    deleteLU(f);
+
+    return d;
 }
 
-// Inversion avec les comatrices
+// Inverse d'une matrice symétrique définie positive par Cholesky
+// (NULL si la matrice n'est pas symétrique ou pas définie positive)
+static Matrix inversion_spd(Matrix m) {
+    Matrix l, inverse;
+
+    if (!isSymetric(m) || !(l = decomposition_cholesky(m))) return NULL;
+    inverse = inversion_cholesky(l);
+    deleteMatrix(l);
+
+    return inverse;
+}
+
+// Inversion par factorisation (Cholesky si possible, sinon LU)
+// (NULL si la matrice n'est pas inversible)
 Matrix inversion(Matrix m) {
-    int i, j;
+    LU f;
+    Matrix inverse = inversion_spd(m);
 
-    if (!det(m)) return NULL;
+    if (inverse) return inverse;
 
-    Matrix inverse = newMatrix(m->nb_rows, m->nb_columns);
-    for (i = 0; i < (int) m->nb_rows; i++) {
-        for (j = 0; j < (int) m->nb_columns; j++) {
-            if ((i + j) % 2 == 0) {
-                setElt(inverse, i, j, det(extraction(m, i, j)));
-            } else {
-                setElt(inverse, i, j, -det(extraction(m, i, j)));
-            }
-        }
-    }
-    inverse = transpose(inverse);
-    inverse = mult_scalar((1/det(m)), inverse);
+    f = decomposition_LU(m);
+    inverse = inversion_LU(f);
+    deleteLU(f);
     return inverse;
 }
 
@@ -332,9 +392,7 @@ E m_determinant(Matrix m) {
     unsigned int i;
     E determinant = 1;
 
-    if (!isTriangulaire(m)) {
-        triangulariser(m);
-    }
+    if (!isTriangulaire(m)) return det(m);
 
     for (i = 0; i < m->nb_rows; i++) {
         determinant *= getElt(m, i, i);
@@ -343,92 +401,90 @@ E m_determinant(Matrix m) {
     return determinant;
 }
 
-// inversion d'une matrice par l'algorithme de Gauss
+// Étape d'élimination de Gauss-Jordan sur les lignes [debut, fin[
+typedef struct {
+    Matrix tmp1;
+    Matrix tmp2;
+    unsigned int h;
+} args_gauss;
+
+static void gauss_morceau(void * arg, size_t debut, size_t fin) {
+    args_gauss * g = arg;
+    unsigned int n = g->tmp1->nb_columns, l;
+    E * pivot1 = g->tmp1->mat + (size_t) g->h * n;
+    E * pivot2 = g->tmp2->mat + (size_t) g->h * n;
+    E coefficient;
+    size_t k;
+
+    for (k = debut; k < fin; k++) {
+        if (k == g->h) continue;
+        E * ligne1 = g->tmp1->mat + k * n;
+        E * ligne2 = g->tmp2->mat + k * n;
+        coefficient = ligne1[g->h];
+        for (l = 0; l < n; l++) {
+            ligne1[l] -= coefficient * pivot1[l];
+            ligne2[l] -= coefficient * pivot2[l];
+        }
+    }
+}
+
+// inversion d'une matrice par l'algorithme de Gauss, avec pivot partiel
+// (par Cholesky si la matrice est symétrique définie positive)
+// (NULL si la matrice n'est pas inversible)
 Matrix inversion_gauss(Matrix m) {
-    unsigned int i, j, k, l, h;
-    int a = 0;
-    E diagonale = 0, coefficient = 0;
-    Matrix tmp1 = newMatrix(m->nb_rows, m->nb_columns);
+    unsigned int i, j, h, p;
+    E diagonale, max, v;
+    Matrix tmp1 = inversion_spd(m);
+    if (tmp1) return tmp1;
+    tmp1 = newMatrix(m->nb_rows, m->nb_columns);
     copy_matrix(m, tmp1);
     Matrix tmp2 = matrix_identite(m->nb_rows);
+    args_gauss g = { tmp1, tmp2, 0 };
 
     for (h = 0; h < m->nb_rows; h++) {
-        diagonale = getElt(tmp1, h, h);
-        a = 0;
-        while (abs(diagonale) < 0.0000000000000001) { // à cause de la précision des flottants
-            a++;
-            for (i = 0; i < m->nb_rows; i++) {
-                setElt (tmp1, h, i, getElt(tmp1, h, i) + getElt(tmp1, h + a, i));
-                setElt (tmp2, h, i, getElt(tmp2, h, i) + getElt(tmp2, h + a, i));
+        // pivot : le plus grand coefficient de la colonne h, sous la diagonale
+        p = h;
+        max = fabsf(getElt(tmp1, h, h));
+        for (i = h + 1; i < m->nb_rows; i++) {
+            v = fabsf(getElt(tmp1, i, h));
+            if (v > max) {
+                max = v;
+                p = i;
             }
-            diagonale = getElt(tmp1, h, h);
+        }
+        if (max == 0) {
+            deleteMatrix(tmp1);
+            deleteMatrix(tmp2);
+            return NULL;
+        }
+        if (p != h) {
+            permuter_ligne(tmp1, h, p);
+            permuter_ligne(tmp2, h, p);
         }
 
+        diagonale = getElt(tmp1, h, h);
         for (j = 0; j < m->nb_rows; j++) {
             setElt(tmp1, h, j, getElt(tmp1, h, j) / diagonale);
             setElt(tmp2, h, j, getElt(tmp2, h, j) / diagonale);
         }
 
-        for (k = 0; k < m->nb_rows; k++) {
-            coefficient = getElt(tmp1, k, h);
-            if (k != h) {
-                for (l = 0; l < m->nb_rows; l++) {
-                    setElt(tmp1, k, l, getElt(tmp1, k, l) - coefficient * getElt(tmp1, h, l));
-                    setElt(tmp2, k, l, getElt(tmp2, k, l) - coefficient * getElt(tmp2, h, l));
-                }
-            }
-        }
+        g.h = h;
+        parallel_for(0, m->nb_rows, PARALLEL_SEUIL / (4 * m->nb_rows) + 1, gauss_morceau, &g);
     }
+    deleteMatrix(tmp1);
     return tmp2;
 }
 
-// Décomposition PLU
+// Décomposition PLU : construit les trois facteurs denses
+// (m n'est pas modifiée)
 PLU decomposition_PLU(Matrix m) {
-    unsigned int i, j, k, l;
-    E p = 0, q = 0, tmp = 0;
-
+    LU f = decomposition_LU(m);
     PLU M;
-    Matrix P = matrix_identite(m->nb_rows);
-    Matrix L = matrix_identite(m->nb_rows);
-    Matrix U = m;
-
-    for (k = 0; k < U->nb_rows; k++) {
-        p = getElt(U, k, k);
-        l = k;
-        for (i = k; i < U->nb_rows; i++) {
-            if (abs(getElt(U, i, k)) > p) {
-                p = getElt(U, i, k);
-                l = i;
-            }
-        }
-        if (l != k) {
-            for (j = 0; j < U->nb_rows; j++) {
-                tmp = getElt(U, k, j);
-                setElt(U, k, j, getElt(U, l, j));
-                setElt(U, l, j, tmp);
-                if (j < k) {
-                    tmp = getElt(L, k, j);
-                    setElt(L, k, j, getElt(L, l, j));
-                    setElt(L, l, j, tmp);
-                }
-                tmp = getElt(P, k, j);
-                setElt(P, k, j, getElt(P, l, j));
-                setElt(P, l, j, tmp);
-            }
-        }
-        for (i = k + 1; i < U->nb_rows; i++) {
-            q = getElt(U, i, k);
-            setElt(U, i, k, 0);
-            setElt(L, i, k, (q / p));
-            for (j = k + 1; j < U->nb_rows; j++) {
-                setElt(U, i, j, getElt(U, i, j) - getElt(U, k, j) * (q / p));
-            }
-        }
-    }
 
-    M.P = P;
-    M.L = L;
-    M.U = U;
+    M.P = LU_p(f);
+    M.L = LU_l(f);
+    M.U = LU_u(f);
+    deleteLU(f);
 
     return M;
 }
@@ -442,47 +498,47 @@ void m_PLU(Matrix m) {
     printMatrix(p.L);
     printf("Matrice U :\n");
     printMatrix(p.U);
+    deleteMatrix(p.P);
+    deleteMatrix(p.L);
+    deleteMatrix(p.U);
 }
 
 // Retourne le P de PLU
 Matrix m_PLU_p(Matrix m) {
-    PLU p = decomposition_PLU(m);
-    return p.P;
+    LU f = decomposition_LU(m);
+    Matrix p = LU_p(f);
+    deleteLU(f);
+    return p;
 }
 
 // Retourne le L de PLU
 Matrix m_PLU_l(Matrix m) {
-    PLU p = decomposition_PLU(m);
-    return p.L;
+    LU f = decomposition_LU(m);
+    Matrix l = LU_l(f);
+    deleteLU(f);
+    return l;
 }
 
 // Retourne le U de PLU
 Matrix m_PLU_u(Matrix m) {
-    PLU p = decomposition_PLU(m);
-    return p.U;
-}
-
-// prec : matrice carrée de taille 2x2
-void valeurs_propres(Matrix m) {
-    E b, c, delta, val1, val2;
-
-    if (m->nb_rows == 2 && m->nb_columns == 2) {
-        b = -(getElt(m,0,0) + getElt(m,1,1));
-        c = m_determinant(m);
-        delta = b*b - 4*c;
-        if (delta < 0) {
-            fprintf(stderr, "Les valeurs propres ne sont pas réelles\n");
-            return;
-        } else if (delta == 0) {
-            val1 = -(b/2);
-            val2 = val1;
-        } else {
-            val1 = (-b- sqrtf(delta))/2;
-            val2 = (-b+ sqrtf(delta))/2;
-        }
-    }
+    LU f = decomposition_LU(m);
+    Matrix u = LU_u(f);
+    deleteLU(f);
+    return u;
+}
 
-    printf("Valeurs propres :\n");
-    printf("   %f\n", val1);
-    printf("   %f\n", val2);
+// Retourne le Q de QR
+Matrix m_QR_q(Matrix m) {
+    QR f = decomposition_QR(m);
+    Matrix q = QR_q(f);
+    deleteQR(f);
+    return q;
+}
+
+// Retourne le R de QR
+Matrix m_QR_r(Matrix m) {
+    QR f = decomposition_QR(m);
+    Matrix r = QR_r(f);
+    deleteQR(f);
+    return r;
 }
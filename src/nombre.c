@@ -0,0 +1,109 @@
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include "system.h"
+#include "nombre.h"
+
+// Puissances de dix représentées exactement par un double
+static const double puissances[] = {
+    1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+    1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+};
+
+#define NB_PUISSANCES (sizeof(puissances) / sizeof(double))
+
+// Au-delà de 19 chiffres, la mantisse ne tient plus dans 64 bits
+#define CHIFFRES_MAX 19
+
+// Les entiers jusqu'à 2^53 sont représentés exactement par un double
+#define MANTISSE_MAX (UINT64_C(1) << 53)
+
+static int chiffre(char c) {
+    return c >= '0' && c <= '9';
+}
+
+static size_t chiffres(const char * p) {
+    size_t n = 0;
+
+    while (chiffre(p[n])) n++;
+    return n;
+}
+
+// w suivi des n chiffres en p. Les chiffres sont convertis huit par huit
+// dans un entier de 64 bits (SWAR) : leur nombre est déjà connu, on ne lit
+// donc jamais au-delà de la constante.
+static uint64_t accumuler(uint64_t w, const char * p, size_t n) {
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+    uint64_t v;
+
+    for (; n >= 8; n -= 8, p += 8) {
+        memcpy(&v, p, 8);
+        v -= UINT64_C(0x3030303030303030);
+        v = v * 10 + (v >> 8);
+        v = ((v & UINT64_C(0x000000FF000000FF)) * UINT64_C(0x000F424000000064)
+            + ((v >> 16) & UINT64_C(0x000000FF000000FF)) * UINT64_C(0x0000271000000001)) >> 32;
+        w = w * 100000000 + (uint32_t) v;
+    }
+#endif
+    for (; n; n--, p++) w = w * 10 + (*p - '0');
+    return w;
+}
+
+// Conversion par strtod des n caractères en p, pour les constantes trop
+// longues ou trop précises pour le calcul exact
+static double convertir_strtod(const char * p, size_t n) {
+    char texte[64];
+    char * t = n < sizeof(texte) ? texte : allouer(n + 1, 1);
+    double d;
+
+    memcpy(t, p, n);
+    t[n] = 0;
+    d = strtod(t, NULL);
+    if (t != texte) free(t);
+    return d;
+}
+
+size_t lire_nombre(const char * p, E * x) {
+    const char * q = p;
+    const char * entiers, * decimales = q;
+    size_t ne, nd = 0, echelle;
+    uint64_t w;
+    double d;
+    int negatif = *q == '-';
+
+    if (negatif) q++;
+    entiers = q;
+    ne = chiffres(q);
+    q += ne;
+    if (*q == '.' && chiffre(q[1])) {
+        decimales = q + 1;
+        nd = chiffres(decimales);
+        q = decimales + nd;
+    } else if (!ne) return 0;
+    else if (*q == '.') q++;
+
+    // la valeur est w / 10^echelle, où w s'écrit avec les chiffres de la
+    // partie entière puis ceux de la partie décimale, sans les zéros de tête
+    echelle = nd;
+    while (ne && *entiers == '0') {
+        entiers++;
+        ne--;
+    }
+    if (!ne) {
+        while (nd && *decimales == '0') {
+            decimales++;
+            nd--;
+        }
+    }
+
+    // w et 10^echelle sont exacts en double : leur quotient est alors
+    // correctement arrondi, comme le résultat de strtod
+    if (ne + nd <= CHIFFRES_MAX && echelle < NB_PUISSANCES
+            && (w = accumuler(accumuler(0, entiers, ne), decimales, nd)) <= MANTISSE_MAX) {
+        d = (double) w / puissances[echelle];
+        if (negatif) d = -d;
+    } else d = convertir_strtod(p, q - p);
+
+    *x = d;
+    return q - p;
+}
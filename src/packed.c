@@ -0,0 +1,712 @@
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "system.h"
+#include "matrix.h"
+#include "gemm.h"
+#include "trsm.h"
+#include "threadpool.h"
+#include "solve.h"
+#include "packed.h"
+
+static size_t taille_packed(unsigned int n) {
+    return (size_t) n * (n + 1) / 2;
+}
+
+Packed newPacked(unsigned int n, nature_packed nature, format_packed format) {
+    Packed p = allouer(1, sizeof(struct packed));
+    p->nature = nature;
+    p->format = format;
+    p->n = n;
+    p->val = allouer(taille_packed(n), sizeof(E));
+    memset(p->val, 0, taille_packed(n) * sizeof(E));
+    return p;
+}
+
+void deletePacked(Packed p) {
+    if (!p) return;
+    free(p->val);
+    free(p);
+}
+
+Packed new_packed_copy(Packed p) {
+    Packed r = newPacked(p->n, p->nature, p->format);
+    memcpy(r->val, p->val, taille_packed(p->n) * sizeof(E));
+    return r;
+}
+
+// Vaut 1 si le format peut stocker une matrice de cette nature
+static int compatible(nature_packed nature, format_packed format) {
+    return nature == PACK_SYMETRIQUE || format == PACK_RFP
+           || (nature == PACK_TRIANGULAIRE_INF) == (format == PACK_INF);
+}
+
+// Adresse du coefficient (i, j) du triangle stocké (j <= i, sauf en
+// PACK_SUP où j >= i)
+static E * stocke(Packed p, unsigned int i, unsigned int j) {
+    unsigned int n1 = p->n / 2, ld = 2 * n1 + 1;
+
+    switch (p->format) {
+        case PACK_INF:
+            return p->val + (size_t) i * (i + 1) / 2 + j;
+        case PACK_SUP:
+            return p->val + (size_t) i * p->n - (size_t) i * (i - 1) / 2 + j - i;
+        default:
+            if (i < n1) return p->val + (size_t) j * ld + i + 1;
+            if (j < n1) return p->val + (size_t) (i - n1) * ld + n1 + 1 + j;
+            return p->val + (size_t) (i - n1) * ld + j - n1;
+    }
+}
+
+// Ramène (i, j) dans le triangle stocké. Retourne 0 si le coefficient est
+// un zéro de structure.
+static int ramener(Packed p, unsigned int * i, unsigned int * j) {
+    unsigned int t;
+
+    // en RFP, une triangulaire supérieure est stockée par sa transposée
+    if (p->format == PACK_RFP && p->nature == PACK_TRIANGULAIRE_SUP) {
+        t = *i;
+        *i = *j;
+        *j = t;
+    }
+    if (p->format == PACK_SUP ? *i > *j : *i < *j) {
+        if (p->nature != PACK_SYMETRIQUE) return 0;
+        t = *i;
+        *i = *j;
+        *j = t;
+    }
+    return 1;
+}
+
+// Vaut 1 si (i, j) est l'un des coefficients stockés de la matrice (pour
+// une matrice symétrique, le triangle du format)
+static int dans_triangle(Packed p, unsigned int i, unsigned int j) {
+    if (p->nature == PACK_TRIANGULAIRE_INF) return j <= i;
+    if (p->nature == PACK_TRIANGULAIRE_SUP) return j >= i;
+    return p->format == PACK_SUP ? j >= i : j <= i;
+}
+
+E packed_get(Packed p, unsigned int i, unsigned int j) {
+    return ramener(p, &i, &j) ? *stocke(p, i, j) : 0;
+}
+
+// Remplit r avec les coefficients de src (ou de sa transposée)
+static void remplir(Packed r, Packed src, int transposer) {
+    unsigned int i, j, si, sj;
+
+    for (i = 0; i < r->n; i++) {
+        for (j = 0; j < r->n; j++) {
+            if (!dans_triangle(r, i, j)) continue;
+            si = i;
+            sj = j;
+            ramener(r, &si, &sj);
+            *stocke(r, si, sj) = transposer ? packed_get(src, j, i) : packed_get(src, i, j);
+        }
+    }
+}
+
+// Teste si une matrice dense est triangulaire inférieure
+static int triangulaire_inferieure(Matrix m) {
+    unsigned int i, j;
+
+    for (i = 0; i < m->nb_rows; i++) {
+        for (j = i + 1; j < m->nb_columns; j++) {
+            if (m->mat[(size_t) i * m->nb_columns + j] != 0) return 0;
+        }
+    }
+    return 1;
+}
+
+// Nature d'une matrice dense carrée : symétrique, triangulaire supérieure
+// ou inférieure. Retourne 0 si elle n'est d'aucune de ces natures.
+int packed_detecter(Matrix m, nature_packed * nature) {
+    if (!isSquare(m)) return 0;
+    if (isSymetric(m)) *nature = PACK_SYMETRIQUE;
+    else if (isTriangulaire(m)) *nature = PACK_TRIANGULAIRE_SUP;
+    else if (triangulaire_inferieure(m)) *nature = PACK_TRIANGULAIRE_INF;
+    else return 0;
+    return 1;
+}
+
+// Garde le triangle de m (carrée) correspondant à la nature. Retourne NULL
+// si le format ne peut pas stocker cette nature.
+Packed dense_to_packed(Matrix m, nature_packed nature, format_packed format) {
+    unsigned int i, j, si, sj, n = m->nb_rows;
+    Packed p;
+
+    if (!compatible(nature, format)) return NULL;
+
+    p = newPacked(n, nature, format);
+    for (i = 0; i < n; i++) {
+        for (j = 0; j < n; j++) {
+            if (!dans_triangle(p, i, j)) continue;
+            si = i;
+            sj = j;
+            ramener(p, &si, &sj);
+            *stocke(p, si, sj) = m->mat[(size_t) i * n + j];
+        }
+    }
+
+    return p;
+}
+
+Matrix packed_to_dense(Packed p) {
+    unsigned int i, j, n = p->n;
+    Matrix m = newMatrix(n, n);
+
+    for (i = 0; i < n; i++) {
+        for (j = 0; j < n; j++) m->mat[(size_t) i * n + j] = packed_get(p, i, j);
+    }
+
+    return m;
+}
+
+// Même matrice dans un autre format. Retourne NULL si le format ne peut
+// pas stocker cette nature.
+Packed packed_convertir(Packed p, format_packed format) {
+    Packed r;
+
+    if (!compatible(p->nature, format)) return NULL;
+    if (format == p->format) return new_packed_copy(p);
+
+    r = newPacked(p->n, p->nature, format);
+    remplir(r, p, 0);
+
+    return r;
+}
+
+// Les petites matrices sont affichées comme les matrices denses, les
+// grandes par leur nature et leur format
+void printPacked(Packed p) {
+    Matrix m;
+    const char * format;
+
+    if (!p) {
+        print_error("No matrix to print");
+        return;
+    }
+
+    if ((size_t) p->n * p->n <= AFFICHAGE_MAX) {
+        m = packed_to_dense(p);
+        printMatrix(m);
+        deleteMatrix(m);
+        return;
+    }
+
+    format = p->format == PACK_RFP ? "RFP" : p->format == PACK_INF ? "triangle inférieur" : "triangle supérieur";
+    if (p->nature == PACK_SYMETRIQUE) printf("Matrice symétrique");
+    else if (p->nature == PACK_TRIANGULAIRE_INF) printf("Matrice triangulaire inférieure");
+    else printf("Matrice triangulaire supérieure");
+    printf(" %u x %u, stockage compact (%s)\n", p->n, p->n, format);
+}
+
+// En RFP la transposée d'une triangulaire garde les mêmes coefficients ;
+// en PACK_INF / PACK_SUP elle change de format
+Packed packed_transpose(Packed p) {
+    Packed r;
+
+    if (p->nature == PACK_SYMETRIQUE) return new_packed_copy(p);
+
+    if (p->format == PACK_RFP) {
+        r = new_packed_copy(p);
+        r->nature = p->nature == PACK_TRIANGULAIRE_INF ? PACK_TRIANGULAIRE_SUP : PACK_TRIANGULAIRE_INF;
+        return r;
+    }
+
+    r = newPacked(p->n, p->nature == PACK_TRIANGULAIRE_INF ? PACK_TRIANGULAIRE_SUP : PACK_TRIANGULAIRE_INF,
+                  p->format == PACK_INF ? PACK_SUP : PACK_INF);
+    remplir(r, p, 1);
+
+    return r;
+}
+
+Packed packed_mult_scalar(E k, Packed p) {
+    Packed r = new_packed_copy(p);
+    size_t i;
+
+    for (i = 0; i < taille_packed(p->n); i++) r->val[i] *= k;
+
+    return r;
+}
+
+// A + k I, en place
+void packed_ajouter_diagonale(Packed p, E k) {
+    unsigned int i;
+
+    for (i = 0; i < p->n; i++) *stocke(p, i, i) += k;
+}
+
+// A + B pour deux matrices de même nature (au format de A). Retourne NULL
+// si les dimensions ou les natures diffèrent.
+Packed packed_addition(Packed a, Packed b) {
+    Packed r, t;
+    size_t i;
+
+    if (a->n != b->n || a->nature != b->nature) return NULL;
+
+    r = new_packed_copy(a);
+    t = b->format == a->format ? b : packed_convertir(b, a->format);
+    for (i = 0; i < taille_packed(a->n); i++) r->val[i] += t->val[i];
+    if (t != b) deletePacked(t);
+
+    return r;
+}
+
+// A + B, dense. Retourne NULL si les dimensions ne correspondent pas.
+Matrix packed_addition_dense(Packed a, Matrix b) {
+    unsigned int i, j, n = a->n;
+    Matrix c;
+
+    if (b->nb_rows != n || b->nb_columns != n) return NULL;
+
+    c = new_matrix_copy(b);
+    for (i = 0; i < n; i++) {
+        for (j = 0; j < n; j++) c->mat[(size_t) i * n + j] += packed_get(a, i, j);
+    }
+
+    return c;
+}
+
+
+// ---------------------------------------------------------------------
+// Noyaux récursifs sur un triangle stocké dans une matrice pleine de pas
+// ld : les blocs diagonaux de plus de PACKED_NB lignes sont coupés en
+// deux, les blocs hors diagonale passent par GEMM
+// ---------------------------------------------------------------------
+
+// TRMM : C = op(T) B, T triangulaire n x n dont seule la partie uplo est
+// lue, B et C de taille n x m
+static void trmm_rec(triangle uplo, int trans, unsigned int n, unsigned int m,
+                     const E * t, unsigned int ldt, const E * b, unsigned int ldb, E * c, unsigned int ldc) {
+    unsigned int n1, n2, i, k;
+    int inf = (uplo == TRI_INF) != (trans != 0);
+    E bloc[PACKED_NB * PACKED_NB];
+
+    if (!n || !m) return;
+
+    // petit bloc : op(T) complétée par des zéros, puis GEMM
+    if (n <= PACKED_NB) {
+        for (i = 0; i < n; i++) {
+            for (k = 0; k < n; k++) {
+                bloc[i * n + k] = (inf ? k > i : k < i) ? 0 : trans ? t[(size_t) k * ldt + i] : t[(size_t) i * ldt + k];
+            }
+        }
+        gemm(n, m, n, 1, bloc, n, b, ldb, 0, c, ldc);
+        return;
+    }
+
+    n1 = n / 2;
+    n2 = n - n1;
+    trmm_rec(uplo, trans, n1, m, t, ldt, b, ldb, c, ldc);
+    trmm_rec(uplo, trans, n2, m, t + (size_t) n1 * ldt + n1, ldt, b + (size_t) n1 * ldb, ldb, c + (size_t) n1 * ldc, ldc);
+    if (inf) {
+        // C2 += op(T)21 B1
+        gemm_t(trans, 0, n2, m, n1, 1, trans ? t + n1 : t + (size_t) n1 * ldt, ldt,
+               b, ldb, 1, c + (size_t) n1 * ldc, ldc);
+    } else {
+        // C1 += op(T)12 B2
+        gemm_t(trans, 0, n1, m, n2, 1, trans ? t + (size_t) n1 * ldt : t + n1, ldt,
+               b + (size_t) n1 * ldb, ldb, 1, c, ldc);
+    }
+}
+
+// SYMM : C = S B, S symétrique n x n dont seule la partie uplo est lue, B
+// et C de taille n x m
+static void symm_rec(triangle uplo, unsigned int n, unsigned int m,
+                     const E * t, unsigned int ldt, const E * b, unsigned int ldb, E * c, unsigned int ldc) {
+    unsigned int n1, n2, i, k;
+    const E * s21;
+    E bloc[PACKED_NB * PACKED_NB];
+
+    if (!n || !m) return;
+
+    // petit bloc : S complétée par symétrie, puis GEMM
+    if (n <= PACKED_NB) {
+        for (i = 0; i < n; i++) {
+            for (k = 0; k < n; k++) {
+                bloc[i * n + k] = (uplo == TRI_INF) == (k <= i) ? t[(size_t) i * ldt + k] : t[(size_t) k * ldt + i];
+            }
+        }
+        gemm(n, m, n, 1, bloc, n, b, ldb, 0, c, ldc);
+        return;
+    }
+
+    n1 = n / 2;
+    n2 = n - n1;
+    symm_rec(uplo, n1, m, t, ldt, b, ldb, c, ldc);
+    symm_rec(uplo, n2, m, t + (size_t) n1 * ldt + n1, ldt, b + (size_t) n1 * ldb, ldb, c + (size_t) n1 * ldc, ldc);
+
+    // C1 += S21^T B2, C2 += S21 B1 (S21 est lue dans le triangle stocké)
+    s21 = uplo == TRI_INF ? t + (size_t) n1 * ldt : t + n1;
+    gemm_t(uplo == TRI_INF, 0, n1, m, n2, 1, s21, ldt, b + (size_t) n1 * ldb, ldb, 1, c, ldc);
+    gemm_t(uplo != TRI_INF, 0, n2, m, n1, 1, s21, ldt, b, ldb, 1, c + (size_t) n1 * ldc, ldc);
+}
+
+// SYRK : partie uplo de C = alpha op(A) op(A)^T + beta C, op(A) de taille
+// n x k (A ou sa transposée selon trans). L'autre triangle de C n'est pas
+// touché.
+static void syrk_rec(triangle uplo, unsigned int n, unsigned int k, E alpha,
+                     const E * a, unsigned int lda, int trans, E beta, E * c, unsigned int ldc) {
+    unsigned int n1, n2, i, j;
+    const E * a2;
+    E bloc[PACKED_NB * PACKED_NB], * cij;
+
+    if (!n) return;
+
+    // petit bloc : produit complet par GEMM, dont on ne garde que le
+    // triangle
+    if (n <= PACKED_NB) {
+        gemm_t(trans, !trans, n, n, k, alpha, a, lda, a, lda, 0, bloc, n);
+        for (i = 0; i < n; i++) {
+            for (j = uplo == TRI_INF ? 0 : i; j <= (uplo == TRI_INF ? i : n - 1); j++) {
+                cij = c + (size_t) i * ldc + j;
+                *cij = bloc[i * n + j] + (beta != 0 ? beta * *cij : 0);
+            }
+        }
+        return;
+    }
+
+    n1 = n / 2;
+    n2 = n - n1;
+    a2 = trans ? a + n1 : a + (size_t) n1 * lda;
+    syrk_rec(uplo, n1, k, alpha, a, lda, trans, beta, c, ldc);
+    syrk_rec(uplo, n2, k, alpha, a2, lda, trans, beta, c + (size_t) n1 * ldc + n1, ldc);
+    if (uplo == TRI_INF) gemm_t(trans, !trans, n2, n1, k, alpha, a2, lda, a, lda, beta, c + (size_t) n1 * ldc, ldc);
+    else gemm_t(trans, !trans, n1, n2, k, alpha, a, lda, a2, lda, beta, c + n1, ldc);
+}
+
+// Substitution d'un bloc diagonal pour les lignes [debut, fin[ de B
+typedef struct {
+    const E * t;
+    unsigned int ldt;
+    int trans;
+    unsigned int n;
+    E * b;
+    unsigned int ldb;
+} args_droite;
+
+static void droite_morceau(void * arg, size_t debut, size_t fin) {
+    args_droite * a = arg;
+    unsigned int j, k;
+    size_t r;
+    double s;
+    E * br;
+
+    for (r = debut; r < fin; r++) {
+        br = a->b + r * a->ldb;
+        for (j = 0; j < a->n; j++) {
+            s = br[j];
+            for (k = 0; k < j; k++) s -= (double) br[k] * (a->trans ? a->t[(size_t) j * a->ldt + k] : a->t[(size_t) k * a->ldt + j]);
+            br[j] = s / a->t[(size_t) j * a->ldt + j];
+        }
+    }
+}
+
+// Résout X op(T) = B en place (B, de taille m x n, est remplacée par X),
+// op(T) étant triangulaire supérieure : T est supérieure si trans vaut 0,
+// inférieure sinon
+static void trsm_droite(int trans, unsigned int n, unsigned int m,
+                        const E * t, unsigned int ldt, E * b, unsigned int ldb) {
+    unsigned int n1, n2;
+    args_droite a;
+
+    if (!n || !m) return;
+
+    if (n <= PACKED_NB) {
+        a.t = t;
+        a.ldt = ldt;
+        a.trans = trans;
+        a.n = n;
+        a.b = b;
+        a.ldb = ldb;
+        parallel_for(0, m, PARALLEL_SEUIL / ((size_t) n * n) + 1, droite_morceau, &a);
+        return;
+    }
+
+    n1 = n / 2;
+    n2 = n - n1;
+    trsm_droite(trans, n1, m, t, ldt, b, ldb);
+    // B2 -= X1 op(T)12
+    gemm_t(0, trans, m, n2, n1, -1, b, ldb, trans ? t + (size_t) n1 * ldt : t + n1, ldt, 1, b + n1, ldb);
+    trsm_droite(trans, n2, m, t + (size_t) n1 * ldt + n1, ldt, b + n1, ldb);
+}
+
+// Cholesky récursive en place de la partie uplo : S = L L^T (inférieure)
+// ou S = U^T U (supérieure). Retourne 0 si S n'est pas définie positive.
+static int chol_rec(triangle uplo, unsigned int n, E * t, unsigned int ld) {
+    unsigned int n1, n2, i, j, k;
+    double d, s;
+    int inf = uplo == TRI_INF;
+
+    if (n <= PACKED_NB) {
+        // L(i, j) est en t[i ld + j] (inférieure) ou en t[j ld + i] (U = L^T)
+        size_t pl = inf ? ld : 1, pc = inf ? 1 : ld;
+        for (j = 0; j < n; j++) {
+            d = t[j * pl + j * pc];
+            for (k = 0; k < j; k++) d -= (double) t[j * pl + k * pc] * t[j * pl + k * pc];
+            if (d <= 0) return 0;
+            d = sqrt(d);
+            t[j * pl + j * pc] = d;
+            for (i = j + 1; i < n; i++) {
+                s = t[i * pl + j * pc];
+                for (k = 0; k < j; k++) s -= (double) t[i * pl + k * pc] * t[j * pl + k * pc];
+                t[i * pl + j * pc] = s / d;
+            }
+        }
+        return 1;
+    }
+
+    n1 = n / 2;
+    n2 = n - n1;
+    if (!chol_rec(uplo, n1, t, ld)) return 0;
+    if (inf) {
+        // L21 L11^T = S21, puis S22 -= L21 L21^T
+        trsm_droite(1, n1, n2, t, ld, t + (size_t) n1 * ld, ld);
+        syrk_rec(TRI_INF, n2, n1, -1, t + (size_t) n1 * ld, ld, 0, 1, t + (size_t) n1 * ld + n1, ld);
+    } else {
+        // U11^T U12 = S12, puis S22 -= U12^T U12
+        trsm(TRI_SUP, 1, 0, n1, n2, t, ld, t + n1, ld);
+        syrk_rec(TRI_SUP, n2, n1, -1, t + n1, ld, 1, 1, t + (size_t) n1 * ld + n1, ld);
+    }
+    return chol_rec(uplo, n2, t + (size_t) n1 * ld + n1, ld);
+}
+
+
+// ---------------------------------------------------------------------
+// Format RFP : L11 est lue comme U1 = L11^T (triangle supérieur à
+// partir de val + 1), L22 comme triangle inférieur à partir de val et L21
+// comme matrice pleine à partir de val + n1 + 1, toutes de pas ld
+// ---------------------------------------------------------------------
+
+typedef struct {
+    unsigned int n1;
+    unsigned int n2;
+    unsigned int ld;
+    E * u1;
+    E * l21;
+    E * l22;
+} blocs_rfp;
+
+static blocs_rfp blocs(Packed p) {
+    blocs_rfp r;
+
+    r.n1 = p->n / 2;
+    r.n2 = p->n - r.n1;
+    r.ld = 2 * r.n1 + 1;
+    r.u1 = p->val + 1;
+    r.l21 = p->val + r.n1 + 1;
+    r.l22 = p->val;
+
+    return r;
+}
+
+// C = A B, A au format RFP
+static void rfp_mult_dense(Packed p, Matrix b, Matrix c) {
+    blocs_rfp r = blocs(p);
+    unsigned int m = b->nb_columns;
+    const E * b1 = b->mat, * b2 = b->mat + (size_t) r.n1 * m;
+    E * c1 = c->mat, * c2 = c->mat + (size_t) r.n1 * m;
+
+    switch (p->nature) {
+        case PACK_SYMETRIQUE:
+            symm_rec(TRI_SUP, r.n1, m, r.u1, r.ld, b1, m, c1, m);
+            symm_rec(TRI_INF, r.n2, m, r.l22, r.ld, b2, m, c2, m);
+            gemm_t(1, 0, r.n1, m, r.n2, 1, r.l21, r.ld, b2, m, 1, c1, m);
+            gemm_t(0, 0, r.n2, m, r.n1, 1, r.l21, r.ld, b1, m, 1, c2, m);
+            break;
+        case PACK_TRIANGULAIRE_INF:
+            trmm_rec(TRI_SUP, 1, r.n1, m, r.u1, r.ld, b1, m, c1, m);
+            trmm_rec(TRI_INF, 0, r.n2, m, r.l22, r.ld, b2, m, c2, m);
+            gemm_t(0, 0, r.n2, m, r.n1, 1, r.l21, r.ld, b1, m, 1, c2, m);
+            break;
+        case PACK_TRIANGULAIRE_SUP:
+            trmm_rec(TRI_SUP, 0, r.n1, m, r.u1, r.ld, b1, m, c1, m);
+            gemm_t(1, 0, r.n1, m, r.n2, 1, r.l21, r.ld, b2, m, 1, c1, m);
+            trmm_rec(TRI_INF, 1, r.n2, m, r.l22, r.ld, b2, m, c2, m);
+            break;
+    }
+}
+
+// Résout L X = B (inferieure) ou L^T X = B en place, L étant le triangle
+// stocké au format RFP
+static void rfp_resoudre(Packed p, int inferieure, Matrix x) {
+    blocs_rfp r = blocs(p);
+    unsigned int m = x->nb_columns;
+    E * x1 = x->mat, * x2 = x->mat + (size_t) r.n1 * m;
+
+    if (inferieure) {
+        trsm(TRI_SUP, 1, 0, r.n1, m, r.u1, r.ld, x1, m);
+        gemm_t(0, 0, r.n2, m, r.n1, -1, r.l21, r.ld, x1, m, 1, x2, m);
+        trsm(TRI_INF, 0, 0, r.n2, m, r.l22, r.ld, x2, m);
+    } else {
+        trsm(TRI_INF, 1, 0, r.n2, m, r.l22, r.ld, x2, m);
+        gemm_t(1, 0, r.n1, m, r.n2, -1, r.l21, r.ld, x2, m, 1, x1, m);
+        trsm(TRI_SUP, 0, 0, r.n1, m, r.u1, r.ld, x1, m);
+    }
+}
+
+typedef struct {
+    Packed p;
+    Matrix b;
+    Matrix c;
+} args_packed;
+
+// Lignes [debut, fin[ de C = A B pour les formats PACK_INF et PACK_SUP
+static void lignes_morceau(void * arg, size_t debut, size_t fin) {
+    args_packed * a = arg;
+    unsigned int j, k, n = a->p->n, m = a->b->nb_columns;
+    size_t i;
+    const E * bj;
+    E aij, * ci;
+
+    for (i = debut; i < fin; i++) {
+        ci = a->c->mat + i * m;
+        for (j = 0; j < n; j++) {
+            aij = packed_get(a->p, i, j);
+            if (aij == 0) continue;
+            bj = a->b->mat + (size_t) j * m;
+            for (k = 0; k < m; k++) ci[k] += aij * bj[k];
+        }
+    }
+}
+
+// A B : SYMM ou TRMM par blocs en RFP, produit ligne par ligne pour les
+// deux autres formats. Retourne NULL si les dimensions ne correspondent
+// pas.
+Matrix packed_mult_dense(Packed p, Matrix b) {
+    args_packed a;
+
+    if (b->nb_rows != p->n) return NULL;
+
+    a.p = p;
+    a.b = b;
+    a.c = newMatrix(p->n, b->nb_columns);
+    if (p->format == PACK_RFP) rfp_mult_dense(p, b, a.c);
+    else parallel_for(0, p->n, PARALLEL_SEUIL / ((size_t) p->n * b->nb_columns + 1) + 1, lignes_morceau, &a);
+
+    return a.c;
+}
+
+// B A = (A^T B^T)^T. Retourne NULL si les dimensions ne correspondent pas.
+Matrix dense_mult_packed(Matrix b, Packed p) {
+    Matrix bt, r, c;
+    Packed pt;
+
+    if (b->nb_columns != p->n) return NULL;
+
+    bt = transpose(b);
+    pt = packed_transpose(p);
+    r = packed_mult_dense(pt, bt);
+    c = transpose(r);
+    deleteMatrix(bt);
+    deleteMatrix(r);
+    deletePacked(pt);
+
+    return c;
+}
+
+// SYRK : A A^T (trans = 0) ou A^T A (trans = 1), symétrique, au format RFP
+Packed packed_syrk(Matrix a, int trans) {
+    unsigned int n = trans ? a->nb_columns : a->nb_rows, k = trans ? a->nb_rows : a->nb_columns;
+    unsigned int lda = a->nb_columns;
+    Packed p = newPacked(n, PACK_SYMETRIQUE, PACK_RFP);
+    blocs_rfp r = blocs(p);
+    const E * a2 = trans ? a->mat + r.n1 : a->mat + (size_t) r.n1 * lda;
+
+    syrk_rec(TRI_SUP, r.n1, k, 1, a->mat, lda, trans, 0, r.u1, r.ld);
+    syrk_rec(TRI_INF, r.n2, k, 1, a2, lda, trans, 0, r.l22, r.ld);
+    gemm_t(trans, !trans, r.n2, r.n1, k, 1, a2, lda, a->mat, lda, 0, r.l21, r.ld);
+
+    return p;
+}
+
+// Cholesky au format RFP (comme pftrf de LAPACK) : retourne le facteur L
+// de S = L L^T, triangulaire inférieur en RFP, ou NULL si S n'est pas
+// symétrique définie positive
+Packed packed_cholesky(Packed p) {
+    Packed l;
+    blocs_rfp r;
+
+    if (p->nature != PACK_SYMETRIQUE) return NULL;
+
+    l = packed_convertir(p, PACK_RFP);
+    r = blocs(l);
+    if (!chol_rec(TRI_SUP, r.n1, r.u1, r.ld)) {
+        deletePacked(l);
+        return NULL;
+    }
+    // L21 U1 = S21, S22 -= L21 L21^T
+    trsm_droite(0, r.n1, r.n2, r.u1, r.ld, r.l21, r.ld);
+    syrk_rec(TRI_INF, r.n2, r.n1, -1, r.l21, r.ld, 0, 1, r.l22, r.ld);
+    if (!chol_rec(TRI_INF, r.n2, r.l22, r.ld)) {
+        deletePacked(l);
+        return NULL;
+    }
+
+    l->nature = PACK_TRIANGULAIRE_INF;
+    return l;
+}
+
+// Déterminant : produit de la diagonale pour une triangulaire, carré du
+// produit de la diagonale de Cholesky pour une symétrique définie
+// positive, LU dense sinon
+E packed_det(Packed p) {
+    unsigned int i;
+    double d = 1;
+    Packed l;
+    Matrix m;
+    E r;
+
+    if (p->n == 0) return 0;
+
+    if (p->nature != PACK_SYMETRIQUE) {
+        for (i = 0; i < p->n; i++) d *= packed_get(p, i, i);
+        return d;
+    }
+
+    if ((l = packed_cholesky(p))) {
+        for (i = 0; i < p->n; i++) d *= packed_get(l, i, i);
+        deletePacked(l);
+        return d * d;
+    }
+
+    m = packed_to_dense(p);
+    r = det(m);
+    deleteMatrix(m);
+    return r;
+}
+
+// X tel que A X = B : TRSM par blocs pour une triangulaire, Cholesky RFP
+// pour une symétrique définie positive, LU dense pour les autres
+// symétriques. Retourne NULL si les dimensions ne correspondent pas ou si
+// A est singulière.
+Matrix packed_resolution(Packed p, Matrix b) {
+    unsigned int i;
+    Packed r;
+    Matrix x, m;
+
+    if (b->nb_rows != p->n) return NULL;
+
+    if (p->nature != PACK_SYMETRIQUE) {
+        for (i = 0; i < p->n; i++) if (packed_get(p, i, i) == 0) return NULL;
+        r = packed_convertir(p, PACK_RFP);
+        x = new_matrix_copy(b);
+        rfp_resoudre(r, p->nature == PACK_TRIANGULAIRE_INF, x);
+        deletePacked(r);
+        return x;
+    }
+
+    if ((r = packed_cholesky(p))) {
+        x = new_matrix_copy(b);
+        rfp_resoudre(r, 1, x);
+        rfp_resoudre(r, 0, x);
+        deletePacked(r);
+        return x;
+    }
+
+    m = packed_to_dense(p);
+    x = resolution(m, b);
+    deleteMatrix(m);
+    return x;
+}
@@ -2,13 +2,42 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <time.h>
 #include <unistd.h>
 #include "mpc.h"
 #include "system.h"
 #include "matrix.h"
 #include "parser.h"
+#include "threadpool.h"
+#include "lu.h"
+#include "solve.h"
+#include "eigen.h"
+#include "svd.h"
+#include "sparse.h"
+#include "iterative.h"
+#include "sparse_lu.h"
+#include "structured.h"
+#include "implicit.h"
+#include "packed.h"
+#include "pratt.h"
+#include "nombre.h"
+
+// Libère la matrice (dense, creuse, bande, implicite ou compacte) ou le
+// préconditionneur porté par e, s'il y en a un. Une valeur empruntée à
+// l'environnement n'est pas libérée : e cesse seulement d'y faire
+// référence.
+static void liberer_contenu(Expression e) {
+    if (e->emprunt) e->emprunt = 0;
+    else if (e->type == MATRIX) deleteMatrix(e->c.m);
+    else if (e->type == SPARSE) deleteSparse(e->c.sp);
+    else if (e->type == STRUCTURED) deleteStructured(e->c.st);
+    else if (e->type == IMPLICIT) deleteImplicit(e->c.im);
+    else if (e->type == PACKED) deletePacked(e->c.pk);
+    else if (e->type == PRECOND) deletePrecond(e->c.pc);
+}
 
-void print_expression(Expression e) {
+// Affiche e, sans la modifier
+void afficher_expression(Expression e) {
     if (!e) print_error("Empty expression");
 
     switch (e->type) {
@@ -20,14 +49,28 @@ void print_expression(Expression e) {
             break;
         case MATRIX:
             printMatrix(e->c.m);
-            deleteMatrix(e->c.m);
+            break;
+        case SPARSE:
+            printSparse(e->c.sp);
+            break;
+        case STRUCTURED:
+            printStructured(e->c.st);
+            break;
+        case IMPLICIT:
+            printImplicit(e->c.im);
+            break;
+        case PACKED:
+            printPacked(e->c.pk);
+            break;
+        case PRECOND:
+            printPrecond(e->c.pc);
             break;
         case SCALAR:
             printf("%f\n", e->c.s);
             break;
         case ASSIGN:
-            printf("La variable '%s' vaut désormais :\n", e->c.a->symbol);
-            print_expression(e->c.a->e);
+            printf("La variable '%s' vaut désormais :\n", nom_symbole(e->c.a->symbole));
+            afficher_expression(e->c.a->e);
             break;
         case IDENT:
             print_error("Undefined variable");
@@ -42,6 +85,13 @@ void print_expression(Expression e) {
     }
 }
 
+// Affiche e puis libère sa valeur. Celle d'une affectation appartient
+// déjà à l'environnement et n'est pas libérée.
+void print_expression(Expression e) {
+    afficher_expression(e);
+    liberer_contenu(e);
+}
+
 Expression new_expression() {
     Expression e = malloc(sizeof(struct s_expression));
     if (e == NULL) {
@@ -49,6 +99,7 @@ Expression new_expression() {
         exit(EXIT_FAILURE);
     }
     e->type = UNKNOWN;
+    e->emprunt = 0;
     return e;
 }
 
@@ -59,387 +110,1730 @@ Expression new_expression_error(char * msg) {
     return e;
 }
 
-mpc_val_t* val_to_expr(mpc_val_t* val) {
-    Expression e = new_expression();
-    e->type = SCALAR;
-    e->c.s = *(float *) val;
-    free(val);
-    return e;
+// Copie profonde de la valeur de source dans e, qui la possède
+static void copier_expression(Expression e, Expression source) {
+    memcpy(e, source, sizeof(struct s_expression));
+    e->emprunt = 0;
+    if (source->type == MATRIX) e->c.m = new_matrix_copy(source->c.m);
+    else if (source->type == SPARSE) e->c.sp = new_sparse_copy(source->c.sp);
+    else if (source->type == STRUCTURED) e->c.st = new_structured_copy(source->c.st);
+    else if (source->type == IMPLICIT) e->c.im = new_implicit_copy(source->c.im);
+    else if (source->type == PACKED) e->c.pk = new_packed_copy(source->c.pk);
+    else if (source->type == PRECOND) e->c.pc = new_precond_copy(source->c.pc);
 }
 
-mpc_val_t* ident_to_expr(int n, mpc_val_t ** xs) {
-    (void) n;
-    char * name = (char *) xs[0];
-    assign env = (assign) xs[1];
+// Copie la valeur de e si elle est empruntée à l'environnement, avant de
+// la modifier ou de la céder à une autre expression
+static void posseder(Expression e) {
+    struct s_expression source;
 
-    Expression e = new_expression();
+    if (!e->emprunt) return;
+    source = *e;
+    copier_expression(e, &source);
+}
 
-    while (env) {
-        if (!strcmp(env->symbol, name)) {
-            if (e->type == MATRIX) deleteMatrix(e->c.m);
-            memcpy(e, env->e, sizeof(struct s_expression));
-            if (env->e->type == MATRIX) {
-                e->c.m = new_matrix_copy(env->e->c.m);
-            }
+// Remplace une matrice creuse, bande, implicite ou compacte par son
+// équivalent dense
+static void densifier(Expression e) {
+    Matrix m;
+
+    if (e->type == SPARSE) {
+        m = sparse_to_dense(e->c.sp);
+        liberer_contenu(e);
+    } else if (e->type == STRUCTURED) {
+        m = structured_to_dense(e->c.st);
+        liberer_contenu(e);
+    } else if (e->type == IMPLICIT) {
+        m = implicit_to_dense(e->c.im);
+        liberer_contenu(e);
+    } else if (e->type == PACKED) {
+        m = packed_to_dense(e->c.pk);
+        liberer_contenu(e);
+    } else return;
+    e->type = MATRIX;
+    e->c.m = m;
+}
+
+// Remplace une matrice bande ou implicite par son équivalent creux, pour
+// les calculs qui ne savent traiter que les stockages dense et CSR
+static void creuser(Expression e) {
+    Sparse s;
+
+    if (e->type == STRUCTURED) {
+        s = structured_to_sparse(e->c.st);
+        liberer_contenu(e);
+    } else if (e->type == IMPLICIT) {
+        s = implicit_to_sparse(e->c.im);
+        liberer_contenu(e);
+    } else return;
+    e->type = SPARSE;
+    e->c.sp = s;
+}
+
+// Vaut 1 si e est une valeur utilisable dans un calcul
+static int operande(Expression e) {
+    return e->type == MATRIX || e->type == SPARSE || e->type == STRUCTURED || e->type == IMPLICIT
+           || e->type == PACKED || e->type == SCALAR;
+}
+
+// Dimensions d'une matrice dense, creuse, bande, implicite ou compacte
+static void dimensions(Expression e, unsigned int * lignes, unsigned int * colonnes) {
+    if (e->type == PACKED) {
+        *lignes = *colonnes = e->c.pk->n;
+    } else if (e->type == IMPLICIT) {
+        *lignes = e->c.im->nb_rows;
+        *colonnes = e->c.im->nb_columns;
+    } else if (e->type == STRUCTURED) {
+        *lignes = *colonnes = e->c.st->n;
+    } else if (e->type == SPARSE) {
+        *lignes = e->c.sp->nb_rows;
+        *colonnes = e->c.sp->nb_columns;
+    } else {
+        *lignes = e->c.m->nb_rows;
+        *colonnes = e->c.m->nb_columns;
+    }
+}
+
+// Libère une liste d'arguments et les matrices qu'elle contient
+static void delete_args(Expression args) {
+    unsigned int i;
+
+    for (i = 0; i < args->c.args.size; i++) {
+        liberer_contenu(args->c.args.list[i]);
+        free(args->c.args.list[i]);
+    }
+    free(args->c.args.list);
+    free(args);
+}
+
+// Fonctions de la SVD (sv, svd_u, svd_s, svd_v) : k vaut 0 pour la
+// décomposition complète, sinon seuls les k plus grands triplets sont
+// calculés. Les variantes préfixées par r (rsv, rsvd_u, ...) et approx
+// (approximation de rang k) utilisent la SVD aléatoire et exigent k.
+// Retourne 0 si name n'est pas l'une de ces fonctions.
+static int appel_svd(char * name, Matrix m, unsigned int k, Expression e) {
+    unsigned int i;
+    int vecteurs, aleatoire = 0;
+    SVD f;
+
+    if (k && !strcmp(name, "approx")) {
+        f = decomposition_SVD_aleatoire(m, k, SVD_ITERATIONS_PUISSANCE, 1);
+        e->type = MATRIX;
+        e->c.m = recomposer_SVD(f);
+        deleteSVD(f);
+        return 1;
+    }
+
+    if (k && !strncmp(name, "rsv", 3)) {
+        aleatoire = 1;
+        name++;
+    }
+    if (strcmp(name, "sv") && strcmp(name, "svd_u") && strcmp(name, "svd_s") && strcmp(name, "svd_v")) {
+        return 0;
+    }
+
+    vecteurs = strcmp(name, "sv") && strcmp(name, "svd_s");
+    if (aleatoire) f = decomposition_SVD_aleatoire(m, k, SVD_ITERATIONS_PUISSANCE, vecteurs);
+    else if (k) f = decomposition_SVD_tronquee(m, k, vecteurs);
+    else f = decomposition_SVD(m, vecteurs);
+
+    e->type = MATRIX;
+    if (!strcmp(name, "sv")) {
+        e->c.m = f.s;
+        f.s = NULL;
+    } else if (!strcmp(name, "svd_s")) {
+        e->c.m = newMatrix(f.s->nb_rows, f.s->nb_rows);
+        for (i = 0; i < f.s->nb_rows; i++) setElt(e->c.m, i, i, f.s->mat[i]);
+    } else if (!strcmp(name, "svd_u")) {
+        e->c.m = f.u;
+        f.u = NULL;
+    } else {
+        e->c.m = f.v;
+        f.v = NULL;
+    }
+    deleteSVD(f);
+
+    return 1;
+}
+
+// Solveurs itératifs : cg(A, b[, M][, tol[, max_iter]]), bicgstab(A, b[,
+// M][, tol[, max_iter]]) et gmres(A, b[, M][, tol[, max_iter[,
+// redemarrage]]]), M étant un préconditionneur construit par jacobi, ilu
+// ou ic. A, dense ou creuse, n'est jamais densifiée (une matrice bande ou
+// implicite passe en CSR). Retourne 0 si name
+// n'est pas un solveur.
+static int appel_solveur(char * name, unsigned int nb, Expression * a, Expression e) {
+    double tol = ITERATIF_TOLERANCE;
+    unsigned int i, o = 2, max_iter = ITERATIF_MAX_ITERATIONS, redemarrage = GMRES_REDEMARRAGE, lignes, colonnes;
+    int est_gmres = !strcmp(name, "gmres");
+    operateur op = { NULL, NULL };
+    Precond pc = NULL;
+    bilan_iteratif bilan;
+    Matrix x;
+
+    if (strcmp(name, "cg") && strcmp(name, "bicgstab") && !est_gmres) return 0;
+
+    e->type = ERROR;
+    e->c.str = "Arguments incorrects.";
+    if (nb > 2 && a[2]->type == PRECOND) {
+        pc = a[2]->c.pc;
+        o = 3;
+    }
+    if (nb < 2 || nb - o > (est_gmres ? 3u : 2u)) return 1;
+    creuser(a[0]);
+    if (a[0]->type == PACKED) densifier(a[0]);
+    if (a[0]->type != MATRIX && a[0]->type != SPARSE) return 1;
+    for (i = o; i < nb; i++) if (a[i]->type != SCALAR || a[i]->c.s <= 0) return 1;
+    densifier(a[1]);
+    if (a[1]->type != MATRIX || a[1]->c.m->nb_columns != 1) return 1;
+
+    dimensions(a[0], &lignes, &colonnes);
+    if (lignes != colonnes) {
+        e->c.str = "La matrice doit être carrée !";
+        return 1;
+    }
+    if (lignes != a[1]->c.m->nb_rows || (pc && pc->n != lignes)) {
+        e->c.str = "Les matrices doivent avoir le même nombre de lignes.";
+        return 1;
+    }
+
+    if (nb > o) tol = a[o]->c.s;
+    if (nb > o + 1) max_iter = a[o + 1]->c.s;
+    if (nb > o + 2) redemarrage = a[o + 2]->c.s;
+    if (!max_iter || !redemarrage) return 1;
+
+    if (a[0]->type == SPARSE) op.creuse = a[0]->c.sp;
+    else op.dense = a[0]->c.m;
+
+    if (est_gmres) x = gmres(op, a[1]->c.m, pc, tol, max_iter, redemarrage, &bilan);
+    else if (!strcmp(name, "cg")) x = gradient_conjugue(op, a[1]->c.m, pc, tol, max_iter, &bilan);
+    else x = bicgstab(op, a[1]->c.m, pc, tol, max_iter, &bilan);
+
+    if (!bilan.converge) {
+        deleteMatrix(x);
+        e->c.str = "Le solveur n'a pas convergé.";
+        return 1;
+    }
+
+    e->type = MATRIX;
+    e->c.m = x;
+
+    return 1;
+}
+
+// Résolution directe de A X = B : LU creuse (ordre de degré minimum) si A
+// est creuse, solveurs bande (substitution, Thomas, LU bande) si A est
+// structurée, X = A^-1 B sans factorisation si A est implicite, TRSM ou
+// Cholesky au format RFP si A est compacte, LU dense ou moindres carrés
+// sinon, comme pour A X = B saisi directement
+static void resoudre(Expression ea, Expression eb, Expression e) {
+    unsigned int lignes, colonnes;
+    Implicit inverse;
+
+    densifier(eb);
+    if ((ea->type != MATRIX && ea->type != SPARSE && ea->type != STRUCTURED && ea->type != IMPLICIT
+         && ea->type != PACKED) || eb->type != MATRIX) {
+        e->type = ERROR;
+        e->c.str = "Les deux membres doivent être des matrices.";
+        return;
+    }
+
+    dimensions(ea, &lignes, &colonnes);
+    if (lignes < colonnes) {
+        e->type = ERROR;
+        e->c.str = "Le système est sous-déterminé.";
+    } else if (lignes != eb->c.m->nb_rows) {
+        e->type = ERROR;
+        e->c.str = "Les matrices doivent avoir le même nombre de lignes.";
+    } else {
+        if (ea->type == SPARSE && lignes == colonnes) e->c.m = resolution_creuse(ea->c.sp, eb->c.m);
+        else if (ea->type == STRUCTURED) e->c.m = structured_resolution(ea->c.st, eb->c.m);
+        else if (ea->type == PACKED) e->c.m = packed_resolution(ea->c.pk, eb->c.m);
+        else if (ea->type == IMPLICIT && lignes == colonnes) {
+            inverse = implicit_inverse(ea->c.im);
+            e->c.m = inverse ? implicit_mult_dense(inverse, eb->c.m) : NULL;
+            deleteImplicit(inverse);
+        } else {
+            densifier(ea);
+            e->c.m = resolution(ea->c.m, eb->c.m);
         }
-        env = env->next;
+        if (!e->c.m) {
+            e->type = ERROR;
+            e->c.str = lignes == colonnes ? "La matrice n'est pas inversible."
+                                          : "La matrice n'est pas de rang plein.";
+        } else e->type = MATRIX;
     }
+}
 
-    if (e->type == UNKNOWN) e = new_expression_error("variable inconnue");
+// Préconditionneurs : jacobi(A), ilu(A) (ILU(0)) et ic(A) (IC(0)), à
+// ranger dans une variable pour les réutiliser d'une résolution à
+// l'autre. Retourne 0 si name n'est pas l'une de ces fonctions.
+static int appel_precond(char * name, Expression param, Expression e) {
+    Sparse a;
+    Precond p;
+
+    if (strcmp(name, "jacobi") && strcmp(name, "ilu") && strcmp(name, "ic")) return 0;
+
+    creuser(param);
+    if (param->type == PACKED) densifier(param);
+    if (param->type != MATRIX && param->type != SPARSE) {
+        e->type = ERROR;
+        e->c.str = "Arguments incorrects.";
+        return 1;
+    }
 
+    a = param->type == SPARSE ? param->c.sp : dense_to_sparse(param->c.m);
+    if (a->nb_rows != a->nb_columns) {
+        e->type = ERROR;
+        e->c.str = "La matrice doit être carrée !";
+    } else {
+        if (!strcmp(name, "jacobi")) p = precond_jacobi(a);
+        else if (!strcmp(name, "ilu")) p = precond_ilu0(a);
+        else p = precond_ic0(a);
+
+        if (p) {
+            e->type = PRECOND;
+            e->c.pc = p;
+        } else {
+            e->type = ERROR;
+            e->c.str = !strcmp(name, "ic") ? "La matrice n'est pas définie positive."
+                                           : "Un pivot est nul.";
+        }
+    }
 
-    return e;
+    if (param->type == MATRIX) deleteSparse(a);
+    liberer_contenu(param);
+
+    return 1;
+}
+
+// Matrices structurées : diag(v) (matrice diagonale de diagonale v, ou
+// diagonale de A en colonne si A est carrée), tril(A), triu(A),
+// tridiag(A) et band(A, kl, ku) gardent la partie correspondante de A,
+// stockée en bande, ou au format RFP pour un triangle trop large.
+// Retourne 0 si name n'est pas l'une de ces fonctions.
+static int appel_structure(char * name, unsigned int nb, Expression * a, Expression e) {
+    unsigned int i, n, kl, ku;
+    Matrix m;
+
+    if (strcmp(name, "diag") && strcmp(name, "tril") && strcmp(name, "triu")
+        && strcmp(name, "tridiag") && strcmp(name, "band")) return 0;
+
+    e->type = ERROR;
+    e->c.str = "Arguments incorrects.";
+    densifier(a[0]);
+    if (a[0]->type != MATRIX || nb != (strcmp(name, "band") ? 1u : 3u)) return 1;
+    m = a[0]->c.m;
+
+    if (!strcmp(name, "diag") && (m->nb_rows == 1 || m->nb_columns == 1)) {
+        n = m->nb_rows * m->nb_columns;
+        e->type = STRUCTURED;
+        e->c.st = newStructured(n, 0, 0);
+        for (i = 0; i < n; i++) e->c.st->val[i] = m->mat[i];
+        return 1;
+    }
+
+    if (!isSquare(m)) {
+        e->c.str = "La matrice doit être carrée !";
+        return 1;
+    }
+    n = m->nb_rows;
+
+    if (!strcmp(name, "diag")) {
+        e->type = MATRIX;
+        e->c.m = newMatrix(n, 1);
+        for (i = 0; i < n; i++) setElt(e->c.m, i, 0, getElt(m, i, i));
+        return 1;
+    }
+
+    // largeurs effectives de A, que la forme demandée ne fait que réduire
+    largeurs_bande(m, &kl, &ku);
+    if (!strcmp(name, "tril")) ku = 0;
+    else if (!strcmp(name, "triu")) kl = 0;
+    else if (!strcmp(name, "tridiag")) {
+        if (kl > 1) kl = 1;
+        if (ku > 1) ku = 1;
+    } else {
+        if (a[1]->type != SCALAR || a[2]->type != SCALAR || a[1]->c.s < 0 || a[2]->c.s < 0) return 1;
+        if (kl > a[1]->c.s) kl = a[1]->c.s;
+        if (ku > a[2]->c.s) ku = a[2]->c.s;
+    }
+
+    // triangle plus large que la moitié de la matrice : la bande
+    // prendrait plus de place que le triangle seul
+    if ((kl == 0 || ku == 0) && (size_t) (kl + ku + 1) * 2 > n + 1) {
+        e->type = PACKED;
+        e->c.pk = dense_to_packed(m, ku == 0 ? PACK_TRIANGULAIRE_INF : PACK_TRIANGULAIRE_SUP, PACK_RFP);
+        return 1;
+    }
+
+    e->type = STRUCTURED;
+    e->c.st = dense_to_structured(m, kl, ku);
+
+    return 1;
 }
 
-mpc_val_t* call_to_expr(int n, mpc_val_t ** xs) {
+// Appel de la fonction name sur param (NULL sans argument, ARGS pour
+// plusieurs arguments), déjà évalué. param est libéré.
+static Expression appel(char * name, Expression param) {
     Expression e = new_expression();
-    char * name = (char *) xs[0];
-    Expression param = (Expression) xs[1];
     unsigned int has_param = param != NULL;
+    unsigned int liste = has_param && param->type == ARGS;
 
-    if (n == 2) {
-        if (has_param) {
-            if (!strcmp(name, "id")) {
-                if (param->type == SCALAR) {
-                    e->type = MATRIX;
-                    e->c.m = matrix_identite(param->c.s);
+    if (has_param && !liste && appel_precond(name, param, e)) {
+        free(param);
+        return e;
+    }
+
+    // un préconditionneur ne s'utilise qu'en argument d'un solveur
+    if (has_param && param->type == PRECOND) {
+        liberer_contenu(param);
+        free(param);
+        e->type = ERROR;
+        e->c.str = "Arguments incorrects.";
+        return e;
+    }
+
+    // matrices creuses : seules quelques fonctions les traitent
+    // directement, les autres reçoivent la matrice dense équivalente
+    if (has_param && param->type == SPARSE) {
+        if (!strcmp(name, "sparse")) {
+            free(e);
+            return param;
+        }
+        if (!strcmp(name, "nnz")) {
+            e->type = SCALAR;
+            e->c.s = param->c.sp->nnz;
+            liberer_contenu(param);
+            free(param);
+            return e;
+        }
+        if (!strcmp(name, "tr")) {
+            e->type = SPARSE;
+            e->c.sp = sparse_transpose(param->c.sp);
+            liberer_contenu(param);
+            free(param);
+            return e;
+        }
+        densifier(param);
+    }
+
+    // matrices bande : déterminant et transposée sans passer par le
+    // stockage dense, passage direct en CSR
+    if (has_param && param->type == STRUCTURED) {
+        if (!strcmp(name, "det") || !strcmp(name, "det_tri")) {
+            e->type = SCALAR;
+            e->c.s = structured_det(param->c.st);
+            liberer_contenu(param);
+            free(param);
+            return e;
+        }
+        if (!strcmp(name, "tr")) {
+            e->type = STRUCTURED;
+            e->c.st = structured_transpose(param->c.st);
+            liberer_contenu(param);
+            free(param);
+            return e;
+        }
+        if (!strcmp(name, "sparse")) {
+            creuser(param);
+            free(e);
+            return param;
+        }
+        densifier(param);
+    }
+
+    // matrices implicites : les fonctions qui se lisent sur la
+    // structure sont calculées sans construire la matrice
+    if (has_param && param->type == IMPLICIT) {
+        Implicit im = param->c.im;
+        if (!strcmp(name, "det") || !strcmp(name, "det_tri") || !strcmp(name, "inv") || !strcmp(name, "invg")) {
+            if (im->nb_rows != im->nb_columns) {
+                e->type = ERROR;
+                e->c.str = "La matrice doit être carrée !";
+            } else if (!strncmp(name, "det", 3)) {
+                e->type = SCALAR;
+                e->c.s = implicit_det(im);
+            } else if ((e->c.im = implicit_inverse(im))) {
+                e->type = IMPLICIT;
+            } else {
+                e->type = ERROR;
+                e->c.str = "La matrice n'est pas inversible.";
+            }
+        } else if (!strcmp(name, "tr")) {
+            e->type = IMPLICIT;
+            e->c.im = implicit_transpose(im);
+        } else if (!strcmp(name, "nnz")) {
+            e->type = SCALAR;
+            e->c.s = implicit_nnz(im);
+        } else if (!strcmp(name, "sparse")) {
+            e->type = SPARSE;
+            e->c.sp = implicit_to_sparse(im);
+        }
+        if (e->type != UNKNOWN) {
+            liberer_contenu(param);
+            free(param);
+            return e;
+        }
+        densifier(param);
+    }
+
+    // matrices compactes : déterminant par Cholesky, transposée et
+    // changement de format sans passer par le stockage dense
+    if (has_param && param->type == PACKED) {
+        Packed pk = param->c.pk;
+        if (!strcmp(name, "det") || !strcmp(name, "det_tri")) {
+            e->type = SCALAR;
+            e->c.s = packed_det(pk);
+        } else if (!strcmp(name, "tr")) {
+            e->type = PACKED;
+            e->c.pk = packed_transpose(pk);
+        } else if (!strcmp(name, "packed")) {
+            e->type = PACKED;
+            e->c.pk = packed_convertir(pk, pk->nature == PACK_TRIANGULAIRE_SUP ? PACK_SUP : PACK_INF);
+        } else if (!strcmp(name, "rfp")) {
+            e->type = PACKED;
+            e->c.pk = packed_convertir(pk, PACK_RFP);
+        }
+        if (e->type != UNKNOWN) {
+            liberer_contenu(param);
+            free(param);
+            return e;
+        }
+        densifier(param);
+    }
+
+    if (has_param) {
+        // plusieurs arguments : solveurs itératifs, solve(A, B),
+        // band(A, kl, ku), zeros(m, n) et f(A, k) pour les versions tronquées ou aléatoires de la SVD
+        if (param->type == ARGS) {
+            Expression * a = param->c.args.list;
+            if (appel_solveur(name, param->c.args.size, a, e)) {
+                // e est déjà renseigné
+            } else if (!strcmp(name, "solve") && param->c.args.size == 2) {
+                resoudre(a[0], a[1], e);
+            } else if (appel_structure(name, param->c.args.size, a, e)) {
+                // e est déjà renseigné
+            } else if (!strcmp(name, "zeros") && param->c.args.size == 2 && a[0]->type == SCALAR
+                       && a[1]->type == SCALAR && a[0]->c.s >= 0 && a[1]->c.s >= 0) {
+                e->type = IMPLICIT;
+                e->c.im = newNulle(a[0]->c.s, a[1]->c.s);
+            } else if (densifier(a[0]), param->c.args.size != 2 || a[0]->type != MATRIX
+                || a[1]->type != SCALAR || a[1]->c.s < 1 || !appel_svd(name, a[0]->c.m, a[1]->c.s, e)) {
+                e->type = ERROR;
+                e->c.str = "Arguments incorrects.";
+            }
+            delete_args(param);
+        }
+
+        // sparse(A) : stockage creux (CSR), dense(A) : stockage dense
+        else if (!strcmp(name, "sparse")) {
+            if (param->type == MATRIX) {
+                e->type = SPARSE;
+                e->c.sp = dense_to_sparse(param->c.m);
+                liberer_contenu(param);
+            }
+        }
+
+        else if (!strcmp(name, "dense")) {
+            if (param->type == MATRIX) *e = *param;
+        }
+
+        // packed(A) : triangle stocké ligne par ligne, rfp(A) : format
+        // RFP, pour une matrice symétrique ou triangulaire
+        else if (!strcmp(name, "packed") || !strcmp(name, "rfp")) {
+            if (param->type == MATRIX) {
+                nature_packed nature;
+                if (!packed_detecter(param->c.m, &nature)) {
+                    e->type = ERROR;
+                    e->c.str = "La matrice doit être symétrique ou triangulaire !";
+                } else {
+                    e->type = PACKED;
+                    e->c.pk = dense_to_packed(param->c.m, nature,
+                                              !strcmp(name, "rfp") ? PACK_RFP
+                                              : nature == PACK_TRIANGULAIRE_SUP ? PACK_SUP : PACK_INF);
                 }
+                liberer_contenu(param);
             }
+        }
 
-            else if (!strcmp(name, "det")) {
-                if (param->type == MATRIX) {
-                    if (!isSquare(param->c.m)) {
-                        e->type = ERROR;
-                        e->c.str = "La matrice doit être carrée !";
-                    } else {
-                        e->type = SCALAR;
-                        e->c.s = det(param->c.m);
-                    }
+        // gram(A) = A^T A, symétrique : seul un triangle est calculé
+        else if (!strcmp(name, "gram")) {
+            if (param->type == MATRIX) {
+                e->type = PACKED;
+                e->c.pk = packed_syrk(param->c.m, 1);
+                liberer_contenu(param);
+            }
+        }
+
+        else if (appel_structure(name, 1, &param, e)) {
+            liberer_contenu(param);
+        }
+
+        // nnz(A) : nombre de coefficients non nuls
+        else if (!strcmp(name, "nnz")) {
+            if (param->type == MATRIX) {
+                unsigned int i;
+                e->type = SCALAR;
+                e->c.s = 0;
+                for (i = 0; i < param->c.m->nb_rows * param->c.m->nb_columns; i++) {
+                    e->c.s += param->c.m->mat[i] != 0;
                 }
+                liberer_contenu(param);
             }
+        }
 
-            else if (!strcmp(name, "det_tri")) {
-                if (param->type == MATRIX) {
-                    if (!isSquare(param->c.m)) {
-                        e->type = ERROR;
-                        e->c.str = "La matrice doit être carrée !";
-                    } else {
-                        e->type = SCALAR;
-                        e->c.s = m_determinant(param->c.m);
-                    }
+        // id(n) et zeros(n) : matrices implicites, sans coefficients
+        else if (!strcmp(name, "id")) {
+            if (param->type == SCALAR && param->c.s >= 0) {
+                e->type = IMPLICIT;
+                e->c.im = newIdentite(param->c.s, 1);
+            }
+        }
+
+        else if (!strcmp(name, "zeros")) {
+            if (param->type == SCALAR && param->c.s >= 0) {
+                e->type = IMPLICIT;
+                e->c.im = newNulle(param->c.s, param->c.s);
+            }
+        }
+
+        else if (!strcmp(name, "det")) {
+            if (param->type == MATRIX) {
+                if (!isSquare(param->c.m)) {
+                    e->type = ERROR;
+                    e->c.str = "La matrice doit être carrée !";
+                } else {
+                    e->type = SCALAR;
+                    e->c.s = det(param->c.m);
                 }
+                liberer_contenu(param);
             }
+        }
 
-            else if (!strcmp(name, "tr")) {
-                if (param->type == MATRIX) {
+        // logdet(A) = [signe, log|det(A)|] : utile quand det(A) dépasse
+        // la plage des flottants
+        else if (!strcmp(name, "logdet")) {
+            if (param->type == MATRIX) {
+                if (!isSquare(param->c.m)) {
+                    e->type = ERROR;
+                    e->c.str = "La matrice doit être carrée !";
+                } else {
+                    int signe;
+                    E l = log_det(param->c.m, &signe);
                     e->type = MATRIX;
-                    e->c.m = transpose(param->c.m);
-                    deleteMatrix(param->c.m);
+                    e->c.m = newMatrix(1, 2);
+                    setElt(e->c.m, 0, 0, signe);
+                    setElt(e->c.m, 0, 1, l);
                 }
+                liberer_contenu(param);
             }
+        }
 
-            else if (!strcmp(name, "inv")) {
-                if (param->type == MATRIX) {
-                    if (!isSquare(param->c.m)) {
-                        e->type = ERROR;
-                        e->c.str = "La matrice doit être carrée !";
-                    } else {
-                        e->c.m = inversion(param->c.m);
-                        if (!e->c.m) {
-                            e->type = ERROR;
-                            e->c.str = "La matrice n'est pas inversible.";
-                        } else e->type = MATRIX;
-                    }
-                    deleteMatrix(param->c.m);
+        else if (!strcmp(name, "det_tri")) {
+            if (param->type == MATRIX) {
+                if (!isSquare(param->c.m)) {
+                    e->type = ERROR;
+                    e->c.str = "La matrice doit être carrée !";
+                } else {
+                    e->type = SCALAR;
+                    e->c.s = m_determinant(param->c.m);
                 }
+                liberer_contenu(param);
             }
+        }
 
-            else if (!strcmp(name, "invg")) {
-                if (param->type == MATRIX) {
-                    if (!isSquare(param->c.m)) {
-                        e->type = ERROR;
-                        e->c.str = "La matrice doit être carrée !";
-                    } else {
-                        e->c.m = inversion_gauss(param->c.m);
-                        if (!e->c.m) {
-                            e->type = ERROR;
-                            e->c.str = "La matrice n'est pas inversible.";
-                        } else e->type = MATRIX;
-                    }
-                    deleteMatrix(param->c.m);
-                }
+        else if (!strcmp(name, "norm")) {
+            if (param->type == MATRIX) {
+                e->type = SCALAR;
+                e->c.s = norme(param->c.m);
+                liberer_contenu(param);
             }
+        }
 
-            else if (!strcmp(name, "plu")) {
-                if (param->type == MATRIX) {
-                    m_PLU(param->c.m);
-                    e->type = NOTHING;
-                    deleteMatrix(param->c.m);
-                }
+        else if (!strcmp(name, "tr")) {
+            if (param->type == MATRIX) {
+                e->type = MATRIX;
+                e->c.m = transpose(param->c.m);
+                liberer_contenu(param);
             }
+        }
 
-            else if (!strcmp(name, "plu_p")) {
-                if (param->type == MATRIX) {
-                    e->c.m = m_PLU_p(param->c.m);
+        else if (!strcmp(name, "inv")) {
+            if (param->type == MATRIX) {
+                if (!isSquare(param->c.m)) {
+                    e->type = ERROR;
+                    e->c.str = "La matrice doit être carrée !";
+                } else {
+                    e->c.m = inversion(param->c.m);
                     if (!e->c.m) {
                         e->type = ERROR;
-                        e->c.str = "Aucune matrice P trouvée.";
+                        e->c.str = "La matrice n'est pas inversible.";
                     } else e->type = MATRIX;
-                    deleteMatrix(param->c.m);
                 }
+                liberer_contenu(param);
             }
+        }
 
-            else if (!strcmp(name, "plu_l")) {
-                if (param->type == MATRIX) {
-                    e->c.m = m_PLU_l(param->c.m);
+        else if (!strcmp(name, "invg")) {
+            if (param->type == MATRIX) {
+                if (!isSquare(param->c.m)) {
+                    e->type = ERROR;
+                    e->c.str = "La matrice doit être carrée !";
+                } else {
+                    e->c.m = inversion_gauss(param->c.m);
                     if (!e->c.m) {
                         e->type = ERROR;
-                        e->c.str = "Aucune matrice P trouvée.";
+                        e->c.str = "La matrice n'est pas inversible.";
                     } else e->type = MATRIX;
-                    deleteMatrix(param->c.m);
                 }
+                liberer_contenu(param);
+            }
+        }
+
+        else if (!strcmp(name, "plu")) {
+            if (param->type == MATRIX) {
+                m_PLU(param->c.m);
+                e->type = NOTHING;
+                liberer_contenu(param);
+            }
+        }
+
+        // plu_p(A) : P est rendue comme permutation implicite
+        else if (!strcmp(name, "plu_p")) {
+            if (param->type == MATRIX) {
+                if (!isSquare(param->c.m)) {
+                    e->type = ERROR;
+                    e->c.str = "Aucune matrice P trouvée.";
+                } else {
+                    LU f = decomposition_LU(param->c.m);
+                    e->type = IMPLICIT;
+                    e->c.im = newPermutation(param->c.m->nb_rows, LU_permutation(f), 1);
+                    deleteLU(f);
+                }
+                liberer_contenu(param);
+            }
+        }
+
+        else if (!strcmp(name, "plu_l")) {
+            if (param->type == MATRIX) {
+                e->c.m = m_PLU_l(param->c.m);
+                if (!e->c.m) {
+                    e->type = ERROR;
+                    e->c.str = "Aucune matrice P trouvée.";
+                } else e->type = MATRIX;
+                liberer_contenu(param);
+            }
+        }
+
+        else if (!strcmp(name, "plu_u")) {
+            if (param->type == MATRIX) {
+                e->c.m = m_PLU_u(param->c.m);
+                if (!e->c.m) {
+                    e->type = ERROR;
+                    e->c.str = "Aucune matrice P trouvée.";
+                } else e->type = MATRIX;
+                liberer_contenu(param);
+            }
+        }
+
+        // qr_q(A), qr_r(A) : facteurs de A = QR (Q a min(m, n) colonnes)
+        else if (!strcmp(name, "qr_q")) {
+            if (param->type == MATRIX) {
+                e->c.m = m_QR_q(param->c.m);
+                e->type = MATRIX;
+                liberer_contenu(param);
+            }
+        }
+        else if (!strcmp(name, "qr_r")) {
+            if (param->type == MATRIX) {
+                e->c.m = m_QR_r(param->c.m);
+                e->type = MATRIX;
+                liberer_contenu(param);
             }
+        }
 
-            else if (!strcmp(name, "plu_u")) {
-                if (param->type == MATRIX) {
-                    e->c.m = m_PLU_u(param->c.m);
+        // val(A) : valeurs propres (vecteur colonne, ou n x 2 avec les
+        // parties imaginaires si certaines sont complexes)
+        else if (!strcmp(name, "val")) {
+            if (param->type == MATRIX) {
+                if (!isSquare(param->c.m)) {
+                    e->type = ERROR;
+                    e->c.str = "La matrice doit être carrée !";
+                } else {
+                    e->c.m = valeurs_propres(param->c.m);
                     if (!e->c.m) {
                         e->type = ERROR;
-                        e->c.str = "Aucune matrice P trouvée.";
+                        e->c.str = "Le calcul des valeurs propres n'a pas convergé.";
                     } else e->type = MATRIX;
-                    deleteMatrix(param->c.m);
                 }
+                liberer_contenu(param);
             }
+        }
 
-            else if (!strcmp(name, "val")) {
-                if (param->type == MATRIX) {
-                    if (!isSquare(param->c.m) || param->c.m->nb_rows != 2 || param->c.m->nb_columns != 2) {
+        // vec(A) : vecteurs propres d'une matrice symétrique (en colonnes,
+        // dans l'ordre des valeurs propres données par val)
+        else if (!strcmp(name, "vec")) {
+            if (param->type == MATRIX) {
+                Matrix valeurs;
+                if (!isSquare(param->c.m) || !isSymetric(param->c.m)) {
+                    e->type = ERROR;
+                    e->c.str = "La matrice doit être symétrique !";
+                } else {
+                    valeurs = valeurs_propres_symetrique(param->c.m, &e->c.m);
+                    if (!valeurs) {
                         e->type = ERROR;
-                        e->c.str = "La matrice doit être carrée et de taille 2x2 !";
+                        e->c.str = "Le calcul des valeurs propres n'a pas convergé.";
                     } else {
-                        e->type = NOTHING;
-                        valeurs_propres(param->c.m);
+                        e->type = MATRIX;
+                        deleteMatrix(valeurs);
                     }
-                    deleteMatrix(param->c.m);
                 }
+                liberer_contenu(param);
             }
+        }
 
+        // sv(A), svd_u(A), svd_s(A), svd_v(A) : A = U S V^T (forme réduite)
+        else if (param->type == MATRIX && appel_svd(name, param->c.m, 0, e)) {
+            liberer_contenu(param);
+        }
+
+        else if (!strcmp(name, "rang")) {
+            if (param->type == MATRIX) {
+                e->type = SCALAR;
+                e->c.s = rang(param->c.m);
+                liberer_contenu(param);
+            }
+        }
+
+        // pinv(A) : pseudo-inverse de Moore-Penrose
+        else if (!strcmp(name, "pinv")) {
+            if (param->type == MATRIX) {
+                e->type = MATRIX;
+                e->c.m = pseudo_inverse(param->c.m);
+                liberer_contenu(param);
+            }
+        }
+
+        // cond(A) : conditionnement en norme 2
+        else if (!strcmp(name, "cond")) {
+            if (param->type == MATRIX) {
+                e->type = SCALAR;
+                e->c.s = conditionnement(param->c.m);
+                liberer_contenu(param);
+            }
         }
 
     }
 
+    if (has_param && !liste) free(param);
+
     return e;
 }
 
 
-mpc_val_t *fold_sum(int n, mpc_val_t ** xs) {
-    int i;
-    Expression * e = (Expression *) xs;
+// a + b quand l'une des deux matrices au moins est creuse : le résultat
+// est creux si les deux le sont, dense sinon. Il remplace a, et la
+// matrice de b est libérée.
+static void somme_creuse(Expression a, Expression b) {
+    unsigned int la, ca, lb, cb;
+    Sparse s;
+    Matrix m;
 
-    // valeur par défaut
-    if (!n) {
-        Expression e = new_expression();
-        e->c.s = 0;
-        return e;
+    dimensions(a, &la, &ca);
+    dimensions(b, &lb, &cb);
+    if (la != lb || ca != cb) {
+        liberer_contenu(a);
+        liberer_contenu(b);
+        a->type = ERROR;
+        a->c.str = "Les matrices doivent être de même dimensions.";
+        return;
     }
 
-    for (i = 1; i < n; i++) {
-        if (e[0]->type == MATRIX && e[i]->type == MATRIX) {
-            if(sameSize(e[0]->c.m, e[i]->c.m)) {
-                e[0]->c.m = addition(e[0]->c.m, e[i]->c.m);
-            } else {
-                e[0]->type = ERROR;
-                e[0]->c.str = "Les matrices doivent être de même dimensions.";
-            }
-        } else if ((e[0]->type == MATRIX && e[i]->type == SCALAR) || (e[0]->type == SCALAR && e[i]->type == MATRIX)) {
-            e[0]->type = ERROR;
-            e[0]->c.str = "Impossible d'additioner un scalaire avec une matrice.";
-        } else {
-            e[0]->c.s += e[i]->c.s;
-        }
-        free(xs[i]);
+    if (a->type == SPARSE && b->type == SPARSE) {
+        s = sparse_addition(a->c.sp, b->c.sp);
+        liberer_contenu(a);
+        a->c.sp = s;
+    } else {
+        m = a->type == SPARSE ? sparse_addition_dense(a->c.sp, b->c.m) : sparse_addition_dense(b->c.sp, a->c.m);
+        liberer_contenu(a);
+        a->type = MATRIX;
+        a->c.m = m;
+    }
+    liberer_contenu(b);
+}
+
+// a * b quand l'une des deux opérandes au moins est creuse : creux x creux
+// et creux x scalaire restent creux, creux x dense donne une matrice dense.
+// Le résultat remplace a, et la valeur de b est libérée.
+static void produit_creux(Expression a, Expression b) {
+    unsigned int la, ca, lb, cb;
+    Sparse s = NULL;
+    Matrix m = NULL;
+
+    if (a->type == SCALAR || b->type == SCALAR) {
+        s = a->type == SCALAR ? sparse_mult_scalar(a->c.s, b->c.sp) : sparse_mult_scalar(b->c.s, a->c.sp);
+        liberer_contenu(a);
+        liberer_contenu(b);
+        a->type = SPARSE;
+        a->c.sp = s;
+        return;
     }
 
-    return xs[0];
+    dimensions(a, &la, &ca);
+    dimensions(b, &lb, &cb);
+    if (ca != lb) {
+        liberer_contenu(a);
+        liberer_contenu(b);
+        a->type = ERROR;
+        a->c.str = "Les dimensions des matrices ne permettent pas le produit.";
+        return;
+    }
+
+    if (a->type == SPARSE && b->type == SPARSE) s = sparse_multiplication(a->c.sp, b->c.sp);
+    else if (a->type == SPARSE) m = sparse_mult_dense(a->c.sp, b->c.m);
+    else m = dense_mult_sparse(a->c.m, b->c.sp);
+
+    liberer_contenu(a);
+    liberer_contenu(b);
+    if (s) {
+        a->type = SPARSE;
+        a->c.sp = s;
+    } else {
+        a->type = MATRIX;
+        a->c.m = m;
+    }
 }
 
-mpc_val_t *fold_prod(int n, mpc_val_t ** xs) {
-    int i;
-    Expression * e = (Expression *) xs;
+// a + b quand l'une des deux matrices au moins est bande : bande + bande
+// reste bande, bande + dense donne une matrice dense, et avec une matrice
+// creuse la bande passe en CSR. Le résultat remplace a, et la matrice de
+// b est libérée.
+static void somme_structuree(Expression a, Expression b) {
+    unsigned int la, ca, lb, cb;
+    Structured s;
     Matrix m;
 
-    // valeur par défaut
-    if (!n) {
-        Expression e = new_expression();
-        e->c.s = 1;
-        return e;
+    if (a->type == SPARSE || b->type == SPARSE) {
+        creuser(a);
+        creuser(b);
+        somme_creuse(a, b);
+        return;
     }
 
-    for (i = 1; i < n; i++) {
-        if (e[0]->type == MATRIX && e[i]->type == MATRIX) {
-            e[0]->c.m = multiplication(e[0]->c.m, e[i]->c.m);
-        } else if (e[0]->type == SCALAR && e[i]->type == MATRIX) {
-            e[0]->type = MATRIX;
-            e[0]->c.m = mult_scalar(e[0]->c.s, e[i]->c.m);
-            deleteMatrix(e[i]->c.m);
-        } else if (e[0]->type == MATRIX && e[i]->type == SCALAR) {
-            m = mult_scalar(e[i]->c.s, e[0]->c.m);
-            deleteMatrix(e[0]->c.m);
-            e[0]->c.m = m;
-        } else if (e[0]->type == SCALAR && e[i]->type == SCALAR) {
-            e[0]->c.s *= e[i]->c.s;
-        }
-        free(xs[i]);
+    dimensions(a, &la, &ca);
+    dimensions(b, &lb, &cb);
+    if (la != lb || ca != cb) {
+        liberer_contenu(a);
+        liberer_contenu(b);
+        a->type = ERROR;
+        a->c.str = "Les matrices doivent être de même dimensions.";
+        return;
     }
 
-    return xs[0];
+    if (a->type == STRUCTURED && b->type == STRUCTURED) {
+        s = structured_addition(a->c.st, b->c.st);
+        liberer_contenu(a);
+        a->c.st = s;
+    } else {
+        m = a->type == STRUCTURED ? structured_addition_dense(a->c.st, b->c.m)
+                                  : structured_addition_dense(b->c.st, a->c.m);
+        liberer_contenu(a);
+        a->type = MATRIX;
+        a->c.m = m;
+    }
+    liberer_contenu(b);
 }
 
-mpc_val_t *fold_assign(int n, mpc_val_t ** xs) {
-    char * name = (char *) xs[0];
-    Expression e = (Expression) xs[2];
+// a * b quand l'une des deux opérandes au moins est bande : bande x bande
+// et bande x scalaire restent bande, bande x dense donne une matrice
+// dense, et avec une matrice creuse la bande passe en CSR. Le résultat
+// remplace a, et la valeur de b est libérée.
+static void produit_structure(Expression a, Expression b) {
+    unsigned int la, ca, lb, cb;
+    Structured s = NULL;
+    Matrix m = NULL;
+
+    if (a->type == SPARSE || b->type == SPARSE) {
+        creuser(a);
+        creuser(b);
+        produit_creux(a, b);
+        return;
+    }
 
-    Expression assign = new_expression();
-    assign->type = ASSIGN;
-    assign->c.a = malloc(sizeof(struct s_assign));
-    assign->c.a->e = e;
-    assign->c.a->symbol = name;
+    if (a->type == SCALAR || b->type == SCALAR) {
+        s = a->type == SCALAR ? structured_mult_scalar(a->c.s, b->c.st) : structured_mult_scalar(b->c.s, a->c.st);
+        liberer_contenu(a);
+        liberer_contenu(b);
+        a->type = STRUCTURED;
+        a->c.st = s;
+        return;
+    }
 
-    (void) n;
+    dimensions(a, &la, &ca);
+    dimensions(b, &lb, &cb);
+    if (ca != lb) {
+        liberer_contenu(a);
+        liberer_contenu(b);
+        a->type = ERROR;
+        a->c.str = "Les dimensions des matrices ne permettent pas le produit.";
+        return;
+    }
 
-    return assign;
+    if (a->type == STRUCTURED && b->type == STRUCTURED) s = structured_multiplication(a->c.st, b->c.st);
+    else if (a->type == STRUCTURED) m = structured_mult_dense(a->c.st, b->c.m);
+    else m = dense_mult_structured(a->c.m, b->c.st);
+
+    liberer_contenu(a);
+    liberer_contenu(b);
+    if (s) {
+        a->type = STRUCTURED;
+        a->c.st = s;
+    } else {
+        a->type = MATRIX;
+        a->c.m = m;
+    }
 }
 
-mpc_val_t *fold_solve(int n, mpc_val_t ** xs) {
-    Matrix a = ((Expression) xs[0])->c.m;
-    Matrix b = ((Expression) xs[3])->c.m;
-    Expression e = new_expression();
-    e->c.m = multiplication(inversion_gauss(a), b);
-    e->type = MATRIX;
+// Échange les valeurs de deux expressions
+static void echanger(Expression a, Expression b) {
+    struct s_expression t = *a;
+    *a = *b;
+    *b = t;
+}
 
-    (void) n;
+// Vaut 1 si e est une matrice implicite de la nature donnée
+static int implicite(Expression e, nature_implicite nature) {
+    return e->type == IMPLICIT && e->c.im->nature == nature;
+}
 
-    return e;
+// Multiplie la valeur de e par k
+static void mise_a_l_echelle(Expression e, E k) {
+    Matrix m;
+    Sparse sp;
+    Structured st;
+    Packed pk;
+
+    if (e->type == SCALAR) e->c.s *= k;
+    else if (e->type == IMPLICIT) {
+        posseder(e);
+        e->c.im->alpha *= k;
+    }
+    else if (e->type == MATRIX) {
+        m = mult_scalar(k, e->c.m);
+        liberer_contenu(e);
+        e->c.m = m;
+    } else if (e->type == SPARSE) {
+        sp = sparse_mult_scalar(k, e->c.sp);
+        liberer_contenu(e);
+        e->c.sp = sp;
+    } else if (e->type == STRUCTURED) {
+        st = structured_mult_scalar(k, e->c.st);
+        liberer_contenu(e);
+        e->c.st = st;
+    } else if (e->type == PACKED) {
+        pk = packed_mult_scalar(k, e->c.pk);
+        liberer_contenu(e);
+        e->c.pk = pk;
+    }
 }
 
-mpc_val_t *fold_mat_row_first(int n, mpc_val_t ** xs) {
-    (void) n;
-    Expression head = (Expression) xs[0];
-    Expression rest = (Expression) xs[1];
+// a + b quand l'une des deux matrices au moins est implicite : A + 0
+// rend A, alpha I + A n'ajoute que la diagonale, et dans les autres cas
+// la matrice implicite est construite (creuse à côté d'une matrice creuse
+// ou bande, dense sinon). Le résultat remplace a, et la matrice de b est
+// libérée.
+static void somme_implicite(Expression a, Expression b) {
+    unsigned int la, ca, lb, cb, i;
+    E k;
+    Matrix m;
 
-    if (head->type == SCALAR) {
-        rest->c.mr.row[0] = head->c.s;
+    dimensions(a, &la, &ca);
+    dimensions(b, &lb, &cb);
+    if (la != lb || ca != cb) {
+        liberer_contenu(a);
+        liberer_contenu(b);
+        a->type = ERROR;
+        a->c.str = "Les matrices doivent être de même dimensions.";
+        return;
     }
 
-    free(head);
+    if (implicite(a, IMPLICITE_NULLE)) echanger(a, b);
+    if (implicite(b, IMPLICITE_NULLE)) {
+        liberer_contenu(b);
+        return;
+    }
 
-    return rest;
+    if (implicite(a, IMPLICITE_IDENTITE)) echanger(a, b);
+    if (implicite(b, IMPLICITE_IDENTITE)
+        && (a->type == MATRIX || a->type == STRUCTURED || a->type == PACKED || implicite(a, IMPLICITE_IDENTITE))) {
+        k = b->c.im->alpha;
+        posseder(a);
+        if (a->type == IMPLICIT) a->c.im->alpha += k;
+        else if (a->type == PACKED) packed_ajouter_diagonale(a->c.pk, k);
+        else if (a->type == MATRIX) for (i = 0; i < la; i++) a->c.m->mat[(size_t) i * la + i] += k;
+        else for (i = 0; i < la; i++) a->c.st->val[(size_t) i * (a->c.st->kl + a->c.st->ku + 1) + a->c.st->kl] += k;
+        liberer_contenu(b);
+        return;
+    }
+
+    if (a->type == SPARSE || a->type == STRUCTURED || b->type == SPARSE || b->type == STRUCTURED) {
+        creuser(a);
+        creuser(b);
+        somme_creuse(a, b);
+        return;
+    }
+
+    densifier(a);
+    densifier(b);
+    m = addition(a->c.m, b->c.m);
+    liberer_contenu(a);
+    liberer_contenu(b);
+    a->c.m = m;
 }
 
-mpc_val_t *fold_mat_row(int n, mpc_val_t ** xs) {
-    int i;
-    Expression row = new_expression();
-    Expression * e = (Expression *) xs;
-    row->type = MATRIX_ROW;
-    if (!n) {
-        row->c.mr.size = 1;
-        row->c.mr.row = malloc(sizeof(float));
-        return row;
-    }
-    row->c.mr.size = n+1;
-    row->c.mr.row = malloc((n+1) * sizeof(float));
-    for (i = 0; i < n; i++) {
-        if (e[i]->type == SCALAR) {
-            row->c.mr.row[i+1] = e[i]->c.s;
-            free(xs[i]);
+// a * b quand l'une des deux opérandes au moins est implicite : sans
+// produit matriciel, 0 A donne la matrice nulle, alpha I A donne alpha A
+// (A elle-même si alpha vaut 1) et alpha P A permute les lignes de A
+// (P A les colonnes de A pour A P). Le résultat remplace a, et la valeur
+// de b est libérée.
+static void produit_implicite(Expression a, Expression b) {
+    unsigned int la, ca, lb, cb;
+    Implicit r;
+    Matrix m;
+    E k;
+
+    if (a->type == SCALAR || b->type == SCALAR) {
+        if (a->type == SCALAR) echanger(a, b);
+        posseder(a);
+        a->c.im->alpha *= b->c.s;
+        return;
+    }
+
+    dimensions(a, &la, &ca);
+    dimensions(b, &lb, &cb);
+    if (ca != lb) {
+        liberer_contenu(a);
+        liberer_contenu(b);
+        a->type = ERROR;
+        a->c.str = "Les dimensions des matrices ne permettent pas le produit.";
+        return;
+    }
+
+    if (implicite(a, IMPLICITE_NULLE) || implicite(b, IMPLICITE_NULLE)) {
+        liberer_contenu(a);
+        liberer_contenu(b);
+        a->type = IMPLICIT;
+        a->c.im = newNulle(la, cb);
+        return;
+    }
+
+    if (a->type == IMPLICIT && b->type == IMPLICIT) {
+        r = implicit_multiplication(a->c.im, b->c.im);
+        liberer_contenu(a);
+        liberer_contenu(b);
+        a->c.im = r;
+        return;
+    }
+
+    // l'identité commute : on la range dans b
+    if (implicite(a, IMPLICITE_IDENTITE)) echanger(a, b);
+    if (implicite(b, IMPLICITE_IDENTITE)) {
+        k = b->c.im->alpha;
+        liberer_contenu(b);
+        if (k != 1) mise_a_l_echelle(a, k);
+        return;
+    }
+
+    if (a->type == PACKED) densifier(a);
+    if (b->type == PACKED) densifier(b);
+    if (a->type == MATRIX || b->type == MATRIX) {
+        m = a->type == IMPLICIT ? implicit_mult_dense(a->c.im, b->c.m) : dense_mult_implicit(a->c.m, b->c.im);
+        liberer_contenu(a);
+        liberer_contenu(b);
+        a->type = MATRIX;
+        a->c.m = m;
+    } else {
+        // permutation et matrice creuse ou bande : produit en CSR
+        creuser(a);
+        creuser(b);
+        produit_creux(a, b);
+    }
+}
+
+// a + b quand l'une des deux matrices au moins est compacte : deux
+// matrices de même nature restent compactes, compacte + dense donne une
+// matrice dense, et à côté d'une matrice creuse ou bande la matrice
+// compacte est construite. Le résultat remplace a, et la matrice de b est
+// libérée.
+static void somme_compacte(Expression a, Expression b) {
+    unsigned int la, ca, lb, cb;
+    Packed p = NULL;
+    Matrix m;
+
+    if (a->type == SPARSE || b->type == SPARSE || a->type == STRUCTURED || b->type == STRUCTURED) {
+        densifier(a->type == PACKED ? a : b);
+        if (a->type == STRUCTURED || b->type == STRUCTURED) somme_structuree(a, b);
+        else somme_creuse(a, b);
+        return;
+    }
+
+    dimensions(a, &la, &ca);
+    dimensions(b, &lb, &cb);
+    if (la != lb || ca != cb) {
+        liberer_contenu(a);
+        liberer_contenu(b);
+        a->type = ERROR;
+        a->c.str = "Les matrices doivent être de même dimensions.";
+        return;
+    }
+
+    if (a->type == PACKED && b->type == PACKED && (p = packed_addition(a->c.pk, b->c.pk))) {
+        liberer_contenu(a);
+        a->c.pk = p;
+    } else {
+        // natures différentes : le résultat n'a plus de structure
+        if (a->type == PACKED && b->type == PACKED) densifier(b);
+        m = a->type == PACKED ? packed_addition_dense(a->c.pk, b->c.m) : packed_addition_dense(b->c.pk, a->c.m);
+        liberer_contenu(a);
+        a->type = MATRIX;
+        a->c.m = m;
+    }
+    liberer_contenu(b);
+}
+
+// a * b quand l'une des deux opérandes au moins est compacte : compacte x
+// scalaire reste compacte, compacte x dense passe par les noyaux SYMM ou
+// TRMM sans construire la matrice, et les autres cas se ramènent au
+// produit dense, creux ou bande. Le résultat remplace a, et la valeur de
+// b est libérée.
+static void produit_compact(Expression a, Expression b) {
+    unsigned int la, ca, lb, cb;
+    Packed p;
+    Matrix m;
+
+    if (a->type == SCALAR || b->type == SCALAR) {
+        if (a->type == SCALAR) echanger(a, b);
+        p = packed_mult_scalar(b->c.s, a->c.pk);
+        liberer_contenu(a);
+        a->c.pk = p;
+        return;
+    }
+
+    if (a->type == SPARSE || b->type == SPARSE || a->type == STRUCTURED || b->type == STRUCTURED) {
+        densifier(a->type == PACKED ? a : b);
+        if (a->type == STRUCTURED || b->type == STRUCTURED) produit_structure(a, b);
+        else produit_creux(a, b);
+        return;
+    }
+
+    dimensions(a, &la, &ca);
+    dimensions(b, &lb, &cb);
+    if (ca != lb) {
+        liberer_contenu(a);
+        liberer_contenu(b);
+        a->type = ERROR;
+        a->c.str = "Les dimensions des matrices ne permettent pas le produit.";
+        return;
+    }
+
+    if (b->type == PACKED && a->type == PACKED) densifier(b);
+    m = a->type == PACKED ? packed_mult_dense(a->c.pk, b->c.m) : dense_mult_packed(a->c.m, b->c.pk);
+    liberer_contenu(a);
+    liberer_contenu(b);
+    a->type = MATRIX;
+    a->c.m = m;
+}
+
+// a + b, évalués : le résultat remplace a, et la valeur de b est libérée
+static void sommer(Expression a, Expression b) {
+    Matrix m;
+
+    if (a->type == MATRIX && b->type == MATRIX) {
+        if(sameSize(a->c.m, b->c.m)) {
+            m = addition(a->c.m, b->c.m);
+            liberer_contenu(a);
+            liberer_contenu(b);
+            a->c.m = m;
+        } else {
+            liberer_contenu(a);
+            liberer_contenu(b);
+            a->type = ERROR;
+            a->c.str = "Les matrices doivent être de même dimensions.";
         }
+    } else if ((a->type == IMPLICIT || b->type == IMPLICIT) && operande(a) && operande(b)
+               && a->type != SCALAR && b->type != SCALAR) {
+        somme_implicite(a, b);
+    } else if ((a->type == PACKED || b->type == PACKED) && operande(a) && operande(b)
+               && a->type != SCALAR && b->type != SCALAR) {
+        somme_compacte(a, b);
+    } else if ((a->type == STRUCTURED || b->type == STRUCTURED) && operande(a) && operande(b)
+               && a->type != SCALAR && b->type != SCALAR) {
+        somme_structuree(a, b);
+    } else if ((a->type == SPARSE && (b->type == SPARSE || b->type == MATRIX))
+               || (a->type == MATRIX && b->type == SPARSE)) {
+        somme_creuse(a, b);
+    } else if (a->type == PRECOND || b->type == PRECOND) {
+        liberer_contenu(a);
+        liberer_contenu(b);
+        a->type = ERROR;
+        a->c.str = "Un préconditionneur ne s'utilise qu'avec un solveur.";
+    } else if (operande(a) && operande(b) && (a->type == SCALAR) != (b->type == SCALAR)) {
+        liberer_contenu(a);
+        liberer_contenu(b);
+        a->type = ERROR;
+        a->c.str = "Impossible d'additioner un scalaire avec une matrice.";
+    } else {
+        a->c.s += b->c.s;
     }
-    return row;
 }
 
-mpc_val_t *fold_mat_first(int n, mpc_val_t ** xs) {
-    (void) n;
-    unsigned int i, j, max_cols = 0;
-    Expression head = (Expression) xs[0];
-    Expression rest = (Expression) xs[1];
+// a * b, évalués : le résultat remplace a, et la valeur de b est libérée
+static void multiplier(Expression a, Expression b) {
+    Matrix m;
 
-    if (head->type == MATRIX_ROW) {
-        rest->c.mra.raw[0] = head->c.mr;
+    if (a->type == MATRIX && b->type == MATRIX) {
+        m = multiplication(a->c.m, b->c.m);
+        liberer_contenu(a);
+        liberer_contenu(b);
+        if (m) a->c.m = m;
+        else {
+            a->type = ERROR;
+            a->c.str = "Les dimensions des matrices ne permettent pas le produit.";
+        }
+    } else if ((a->type == IMPLICIT || b->type == IMPLICIT) && operande(a) && operande(b)) {
+        produit_implicite(a, b);
+    } else if ((a->type == PACKED || b->type == PACKED) && operande(a) && operande(b)) {
+        produit_compact(a, b);
+    } else if ((a->type == STRUCTURED || b->type == STRUCTURED) && operande(a) && operande(b)) {
+        produit_structure(a, b);
+    } else if ((a->type == SPARSE || b->type == SPARSE) && operande(a) && operande(b)) {
+        produit_creux(a, b);
+    } else if (a->type == SCALAR && b->type == MATRIX) {
+        a->type = MATRIX;
+        a->c.m = mult_scalar(a->c.s, b->c.m);
+        liberer_contenu(b);
+    } else if (a->type == MATRIX && b->type == SCALAR) {
+        m = mult_scalar(b->c.s, a->c.m);
+        liberer_contenu(a);
+        a->c.m = m;
+    } else if (a->type == SCALAR && b->type == SCALAR) {
+        a->c.s *= b->c.s;
+    } else if (a->type == PRECOND || b->type == PRECOND) {
+        liberer_contenu(a);
+        liberer_contenu(b);
+        a->type = ERROR;
+        a->c.str = "Un préconditionneur ne s'utilise qu'avec un solveur.";
     }
+}
 
-    for (i = 0; i < rest->c.mra.size; i++) {
-        if (rest->c.mra.raw[i].size > max_cols) {
-            max_cols = rest->c.mra.raw[i].size;
+// Inverse de e, qui est remplacée
+static void inverser(Expression e) {
+    // l'inverse d'une matrice implicite carrée reste implicite
+    if (e->type == IMPLICIT && e->c.im->nb_rows == e->c.im->nb_columns) {
+        Implicit inverse = implicit_inverse(e->c.im);
+        liberer_contenu(e);
+        if (!inverse) {
+            e->type = ERROR;
+            e->c.str = "La matrice n'est pas inversible.";
+        } else e->c.im = inverse;
+        return;
+    }
+    densifier(e);
+    if (e->type == SCALAR) e->c.s = 1 / e->c.s;
+    else if (e->type == MATRIX) {
+        if (!isSquare(e->c.m)) {
+            liberer_contenu(e);
+            e->type = ERROR;
+            e->c.str = "La matrice doit être carrée !";
+        } else {
+            Matrix inverse = inversion(e->c.m);
+            liberer_contenu(e);
+            if (!inverse) {
+                e->type = ERROR;
+                e->c.str = "La matrice n'est pas inversible.";
+            } else e->c.m = inverse;
         }
     }
+}
 
-    Matrix m = newMatrix(rest->c.mra.size, max_cols);
-    for (i = 0; i < rest->c.mra.size; i++) {
-        for (j = 0; j < rest->c.mra.raw[i].size; j++) {
-            setElt(m, i, j, rest->c.mra.raw[i].row[j]);
+// Matrice saisie, dont le stockage est choisi d'après les coefficients :
+// bande, creux, compact ou dense (m est alors gardée telle quelle)
+static Expression construire_matrice(Matrix m) {
+    unsigned int i, j;
+    size_t nnz = 0, p;
+    unsigned int kl = 0, ku = 0;
+    Expression e = new_expression();
+
+    // on relève au passage les largeurs de bande
+    for (i = 0; i < m->nb_rows; i++) {
+        for (j = 0; j < m->nb_columns; j++) {
+            if (getElt(m, i, j) != 0) {
+                nnz++;
+                if (j + kl < i) kl = i - j;
+                if (j > i + ku) ku = j - i;
+            }
         }
-        free(rest->c.mra.raw[i].row);
     }
-    free(rest->c.mra.raw);
 
-    free(head);
+    // matrice carrée triangulaire ou à bande étroite : stockage bande
+    if (isSquare(m) && structured_preferable(m->nb_columns, kl, ku, nnz)) {
+        Structured st = newStructured(m->nb_columns, kl, ku);
+        for (i = 0; i < m->nb_rows; i++) {
+            for (j = i > kl ? i - kl : 0; j < m->nb_columns && j <= i + ku; j++) {
+                st->val[(size_t) i * (kl + ku + 1) + j + kl - i] = getElt(m, i, j);
+            }
+        }
+        deleteMatrix(m);
+        e->type = STRUCTURED;
+        e->c.st = st;
+        return e;
+    }
 
-    rest->type = MATRIX;
-    rest->c.m = m;
-    return rest;
+    // peu de coefficients non nuls : stockage creux
+    if (sparse_preferable(m->nb_rows, m->nb_columns, nnz)) {
+        Sparse s = newSparse(m->nb_rows, m->nb_columns, nnz);
+        for (i = 0, p = 0; i < m->nb_rows; i++) {
+            for (j = 0; j < m->nb_columns; j++) {
+                if (getElt(m, i, j) != 0) {
+                    s->col[p] = j;
+                    s->val[p++] = getElt(m, i, j);
+                }
+            }
+            s->row_ptr[i + 1] = p;
+        }
+        deleteMatrix(m);
+        e->type = SPARSE;
+        e->c.sp = s;
+        return e;
+    }
+
+    // grande matrice symétrique ou triangulaire : un seul triangle est
+    // gardé, au format RFP
+    nature_packed nature;
+    if (isSquare(m) && (size_t) m->nb_rows * m->nb_rows >= SPARSE_TAILLE_MIN && packed_detecter(m, &nature)) {
+        e->type = PACKED;
+        e->c.pk = dense_to_packed(m, nature, PACK_RFP);
+        deleteMatrix(m);
+        return e;
+    }
+
+    e->type = MATRIX;
+    e->c.m = m;
+    return e;
 }
 
-mpc_val_t *fold_mat(int n, mpc_val_t ** xs) {
-    int i;
-    Expression raw = new_expression();
-    Expression * e = (Expression *) xs;
-    raw->type = MATRIX_RAW;
-    if (!n) {
-        raw->c.mra.size = 1;
-        raw->c.mra.raw = malloc(sizeof(struct s_matrix_row));
-        return raw;
-    }
-    raw->c.mra.size = n+1;
-    raw->c.mra.raw = malloc((n+1) * sizeof(struct s_matrix_row));
+// Vaut 1 si e ne peut pas servir d'opérande : erreur, ou fonction inconnue
+static int echec(Expression e) {
+    return e->type == ERROR || e->type == UNKNOWN;
+}
+
+// Libère les n valeurs de v (et le tableau), sauf celle d'indice garde
+static void liberer_valeurs(Expression * v, unsigned int n, unsigned int garde) {
+    unsigned int i;
+
     for (i = 0; i < n; i++) {
-        if (e[i]->type == MATRIX_ROW) {
-            raw->c.mra.raw[i+1] = e[i]->c.mr;
-            free(xs[i]);
-        }
+        if (i == garde || !v[i]) continue;
+        liberer_contenu(v[i]);
+        free(v[i]);
     }
-    return raw;
+    free(v);
 }
 
+// Évalue les fils de n dans l'ordre. Retourne NULL si l'un d'eux échoue :
+// les valeurs déjà calculées sont libérées et l'échec est rendu dans
+// *erreur.
+static Expression * evaluer_fils(Node n, Environnement env, Expression * erreur) {
+    Expression * v = allouer_zero(n->nb, sizeof(Expression));
+    unsigned int i;
+
+    for (i = 0; i < n->nb; i++) {
+        v[i] = evaluer(n->fils[i], env);
+        if (echec(v[i])) {
+            *erreur = v[i];
+            liberer_valeurs(v, i, i);
+            return NULL;
+        }
+    }
+
+    return v;
+}
 
-mpc_val_t *fold_value(int n, mpc_val_t ** xs) {
+// Matrice saisie : chaque coefficient doit être un scalaire. Les lignes
+// plus courtes que la plus longue sont complétées par des zéros. Une
+// matrice de constantes lue d'un bloc est reprise telle quelle : elle
+// n'appartient plus ensuite au noeud.
+static Expression evaluer_matrice(Node n, Environnement env) {
+    Matrix m = n->m;
+    Expression c;
+    unsigned int i, j, colonnes = 0;
+
+    if (m) {
+        n->m = NULL;
+        return construire_matrice(m);
+    }
 
-    char * op = (char *) xs[0];
-    Expression e = (Expression) xs[1];
+    for (i = 0; i < n->nb; i++) {
+        if (n->fils[i]->nb > colonnes) colonnes = n->fils[i]->nb;
+    }
 
-    switch (*op) {
-        case '-':
-            // Si l'opérateur était un -, on multiplie par -1
-            if (e->type == SCALAR) e->c.s *= -1;
-            else if (e->type == MATRIX) {
-                mult_scalar(-1, e->c.m);
+    m = newMatrix(n->nb, colonnes);
+    for (i = 0; i < n->nb; i++) {
+        Node ligne = n->fils[i];
+        for (j = 0; j < ligne->nb; j++) {
+            c = evaluer(ligne->fils[j], env);
+            if (c->type != SCALAR) {
+                if (!echec(c)) {
+                    liberer_contenu(c);
+                    c->type = ERROR;
+                    c->c.str = "Les coefficients d'une matrice doivent être des scalaires.";
+                }
+                deleteMatrix(m);
+                return c;
             }
-            break;
-        case '/':
-            // Si l'opérateur était un /, on  prend l'inverse
-            if (e->type == SCALAR) e->c.s = 1 / e->c.s;
-            else if (e->type == MATRIX) {
-                e->c.m = inversion(e->c.m);
+            setElt(m, i, j, c->c.s);
+            free(c);
+        }
+    }
+
+    return construire_matrice(m);
+}
+
+// Appel de fonction : les arguments sont évalués, puis passés seuls ou en
+// liste (ARGS) à la fonction
+static Expression evaluer_appel(Node n, Environnement env) {
+    Expression erreur = NULL, param = NULL;
+    Expression * v = evaluer_fils(n, env, &erreur);
+
+    if (!v) return erreur;
+
+    if (n->nb == 1) {
+        param = v[0];
+        free(v);
+    } else if (n->nb > 1) {
+        param = new_expression();
+        param->type = ARGS;
+        param->c.args.size = n->nb;
+        param->c.args.list = v;
+    } else free(v);
+
+    return appel(n->nom, param);
+}
+
+// Évalue l'arbre n une fois l'analyse terminée : chaque opération n'est
+// exécutée qu'une fois, de gauche à droite. La valeur rendue appartient à
+// l'appelant ; une erreur arrête l'évaluation et libère les valeurs
+// intermédiaires.
+Expression evaluer(Node n, Environnement env) {
+    Expression e = NULL, r, erreur = NULL, * v;
+    unsigned int i;
+
+    switch (n->nature) {
+        case NOEUD_CONSTANTE:
+            e = new_expression();
+            e->type = SCALAR;
+            e->c.s = n->s;
+            return e;
+
+        case NOEUD_VARIABLE:
+            // la valeur est empruntée, et ne sera copiée que si elle doit
+            // être modifiée (les scalaires sont copiés d'emblée)
+            if (!(e = env_chercher(env, n->symbole))) return new_expression_error("variable inconnue");
+            r = new_expression();
+            *r = *e;
+            r->emprunt = r->type != SCALAR;
+            return r;
+
+        case NOEUD_MATRICE:
+            return evaluer_matrice(n, env);
+
+        case NOEUD_SOMME:
+        case NOEUD_PRODUIT:
+            e = evaluer(n->fils[0], env);
+            for (i = 1; i < n->nb && !echec(e); i++) {
+                r = evaluer(n->fils[i], env);
+                if (echec(r)) {
+                    liberer_contenu(e);
+                    free(e);
+                    return r;
+                }
+                if (n->nature == NOEUD_SOMME) sommer(e, r);
+                else multiplier(e, r);
+                free(r);
             }
-            break;
+            return e;
+
+        case NOEUD_OPPOSE:
+            e = evaluer(n->fils[0], env);
+            mise_a_l_echelle(e, -1);
+            return e;
+
+        case NOEUD_INVERSE:
+            e = evaluer(n->fils[0], env);
+            inverser(e);
+            return e;
+
+        case NOEUD_APPEL:
+            return evaluer_appel(n, env);
+
+        case NOEUD_AFFECTATION:
+            e = evaluer(n->fils[0], env);
+            if (echec(e)) return e;
+            posseder(e);
+            r = new_expression();
+            r->type = ASSIGN;
+            r->c.a = allouer(1, sizeof(struct s_assign));
+            r->c.a->symbole = n->symbole;
+            r->c.a->e = e;
+            return r;
+
+        case NOEUD_RESOLUTION:
+            if (!(v = evaluer_fils(n, env, &erreur))) return erreur;
+            e = new_expression();
+            resoudre(v[0], v[1], e);
+            liberer_valeurs(v, 2, 2);
+            return e;
+
         default:
-            break;
+            return new_expression_error("Expression inconnue");
     }
+}
 
+// Construction de l'arbre par l'analyseur : les fonctions *_first
+// reçoivent le premier élément et la liste des suivants, construite par
+// la fonction sans suffixe avec une place libre en tête.
+
+// Place libre en tête d'une liste de n éléments
+static Node liste(nature_noeud nature, int n, mpc_val_t ** xs) {
+    Node l = newNode(nature, n + 1);
+    int i;
+
+    for (i = 0; i < n; i++) l->fils[i + 1] = (Node) xs[i];
+
+    return l;
+}
+
+// Complète la liste rest par head ; une somme ou un produit d'un seul
+// terme est remplacé par ce terme
+static Node premier(Node head, Node rest) {
+    if (rest->nb == 1 && (rest->nature == NOEUD_SOMME || rest->nature == NOEUD_PRODUIT)) {
+        deleteNode(rest);
+        return head;
+    }
+    rest->fils[0] = head;
+    return rest;
+}
+
+mpc_val_t* val_to_node(mpc_val_t* val) {
+    E s = 0;
+
+    lire_nombre((char *) val, &s);
+    free(val);
+    return newConstante(s);
+}
+
+mpc_val_t* ident_to_node(mpc_val_t* val) {
+    Node n = newNode(NOEUD_VARIABLE, 0);
+    n->symbole = interner(val, strlen(val));
+    free(val);
+    return n;
+}
+
+mpc_val_t* call_to_node(int n, mpc_val_t ** xs) {
+    Node args = (Node) xs[1];
+    Node c = args ? args : newNode(NOEUD_APPEL, 0);
+
+    (void) n;
+    c->nature = NOEUD_APPEL;
+    c->nom = (char *) xs[0];
+
+    return c;
+}
+
+mpc_val_t *fold_sum_first(int n, mpc_val_t ** xs) {
+    (void) n;
+    return premier((Node) xs[0], (Node) xs[1]);
+}
+
+mpc_val_t *fold_sum(int n, mpc_val_t ** xs) {
+    return liste(NOEUD_SOMME, n, xs);
+}
+
+mpc_val_t *fold_prod_first(int n, mpc_val_t ** xs) {
+    (void) n;
+    return premier((Node) xs[0], (Node) xs[1]);
+}
+
+mpc_val_t *fold_prod(int n, mpc_val_t ** xs) {
+    return liste(NOEUD_PRODUIT, n, xs);
+}
+
+mpc_val_t *fold_assign(int n, mpc_val_t ** xs) {
+    Node a = newNode(NOEUD_AFFECTATION, 1);
+
+    (void) n;
+    a->symbole = interner(xs[0], strlen(xs[0]));
+    a->fils[0] = (Node) xs[2];
     free(xs[0]);
+    free(xs[1]);
+
+    return a;
+}
+
+mpc_val_t *fold_solve(int n, mpc_val_t ** xs) {
+    Node r = newNode(NOEUD_RESOLUTION, 2);
 
     (void) n;
+    r->fils[0] = (Node) xs[0];
+    r->fils[1] = (Node) xs[3];
+    free(xs[1]);
+    free(xs[2]);
 
-    return xs[1];
+    return r;
+}
+
+mpc_val_t *fold_mat_row_first(int n, mpc_val_t ** xs) {
+    (void) n;
+    return premier((Node) xs[0], (Node) xs[1]);
+}
+
+mpc_val_t *fold_mat_row(int n, mpc_val_t ** xs) {
+    return liste(NOEUD_LIGNE, n, xs);
+}
+
+mpc_val_t *fold_mat_first(int n, mpc_val_t ** xs) {
+    (void) n;
+    return premier((Node) xs[0], (Node) xs[1]);
+}
+
+mpc_val_t *fold_mat(int n, mpc_val_t ** xs) {
+    return liste(NOEUD_MATRICE, n, xs);
+}
+
+mpc_val_t *fold_args_first(int n, mpc_val_t ** xs) {
+    (void) n;
+    return premier((Node) xs[0], (Node) xs[1]);
+}
+
+mpc_val_t *fold_args(int n, mpc_val_t ** xs) {
+    return liste(NOEUD_ARGUMENTS, n, xs);
+}
+
+// Opérateur unaire devant un terme ou un facteur : - donne l'opposé, /
+// l'inverse
+mpc_val_t *fold_value(int n, mpc_val_t ** xs) {
+    char * op = (char *) xs[0];
+    Node v = (Node) xs[1];
+    Node r = v;
+
+    (void) n;
+    if (*op == '-' || *op == '/') {
+        r = newNode(*op == '-' ? NOEUD_OPPOSE : NOEUD_INVERSE, 1);
+        r->fils[0] = v;
+    }
+    free(op);
+
+    return r;
 }
 
 
@@ -450,30 +1844,129 @@ void catch_segfault(int signum) {
     exit(EXIT_FAILURE);
 }
 
-void free_env(assign env) {
+// Secondes écoulées depuis une origine fixe
+static double horloge(void) {
+    struct timespec t;
+
+    clock_gettime(CLOCK_MONOTONIC, &t);
+    return t.tv_sec + t.tv_nsec * 1e-9;
+}
+
+// Lignes analysées par seconde, sans évaluation, par l'analyseur direct
+// (direct = 1) ou par mpc : la ligne est analysée par lots de taille
+// croissante jusqu'à ce qu'une demi-seconde se soit écoulée
+static double debit(const char * ligne, int direct, mpc_parser_t * Input) {
+    unsigned long n = 0, lot = 1, i;
+    double debut = horloge(), duree;
+    mpc_result_t r;
+
+    do {
+        for (i = 0; i < lot; i++) {
+            if (direct) deleteNode(pratt_analyser(ligne));
+            else if (mpc_parse("input", ligne, Input, &r)) deleteNode(r.output);
+            else mpc_err_delete(r.error);
+        }
+        n += lot;
+        lot *= 2;
+        duree = horloge() - debut;
+    } while (duree < 0.5);
+
+    return n / duree;
+}
+
+// Commandes de l'interpréteur (lignes commençant par ':')
+//   :threads      affiche le nombre de threads de calcul
+//   :threads N    utilise N threads (0 = nombre de coeurs)
+//   :bench L      débit d'analyse de la ligne L (lignes par seconde), avec
+//                 l'analyseur direct et avec mpc
+void run_command(char * line, mpc_parser_t * Input) {
+    char cmd[32];
+    int n, nb = sscanf(line, ":%31s %d", cmd, &n);
+
+    if (nb >= 1 && !strcmp(cmd, "bench")) {
+        char * ligne = line + strlen(":bench");
+        Node arbre = pratt_analyser(ligne);
+        if (arbre) {
+            deleteNode(arbre);
+            printf("Analyseur direct : %.0f lignes/s\n", debit(ligne, 1, Input));
+        } else printf("Analyseur direct : ligne non reconnue\n");
+        printf("Analyseur mpc : %.0f lignes/s\n", debit(ligne, 0, Input));
+    } else if (nb >= 1 && !strcmp(cmd, "threads")) {
+        if (nb == 2) {
+            if (n < 0) {
+                print_error("Le nombre de threads doit être positif.");
+                return;
+            }
+            pool_set_threads(n);
+        }
+        printf("Threads : %u\n", pool_threads());
+    } else {
+        print_error("Commande inconnue");
+    }
+}
+
+// Taille de départ d'un environnement neuf
+#define ENV_TAILLE 16
+
+Environnement newEnvironnement() {
+    Environnement env = allouer_zero(1, sizeof(struct s_environnement));
+    env->taille = ENV_TAILLE;
+    env->valeurs = allouer_zero(env->taille, sizeof(Expression));
+    return env;
+}
+
+void deleteEnvironnement(Environnement env) {
+    unsigned int i;
+
     if (!env) return;
-    if (env->next) free_env(env->next);
-    if (env->e) {
-        if (env->e->type == MATRIX) deleteMatrix(env->e->c.m);
-        free(env->e);
+    for (i = 0; i < env->taille; i++) {
+        if (!env->valeurs[i]) continue;
+        liberer_contenu(env->valeurs[i]);
+        free(env->valeurs[i]);
     }
+    free(env->valeurs);
     free(env);
 }
 
+// Valeur de la variable symbole (qui reste à l'environnement), NULL si
+// elle n'est pas définie
+Expression env_chercher(Environnement env, unsigned int symbole) {
+    return symbole < env->taille ? env->valeurs[symbole] : NULL;
+}
+
+// Affecte e, qui appartient désormais à l'environnement, à la variable
+// symbole : l'ancienne valeur est libérée. Le tableau est agrandi (au
+// moins doublé) pour un symbole qui le dépasse.
+void env_definir(Environnement env, unsigned int symbole, Expression e) {
+    unsigned int taille;
+
+    if (symbole >= env->taille) {
+        taille = 2 * env->taille > symbole ? 2 * env->taille : symbole + 1;
+        env->valeurs = reallouer(env->valeurs, taille, sizeof(Expression));
+        memset(env->valeurs + env->taille, 0, (taille - env->taille) * sizeof(Expression));
+        env->taille = taille;
+    }
+
+    if (env->valeurs[symbole]) {
+        liberer_contenu(env->valeurs[symbole]);
+        free(env->valeurs[symbole]);
+    }
+    env->valeurs[symbole] = e;
+}
+
 
 void run_parser() {
     signal(SIGSEGV, catch_segfault);
 
-    assign environnement = malloc(sizeof(struct s_assign));
-    environnement->symbol = "pi";
-    environnement->e = new_expression();
-    environnement->e->type = SCALAR;
-    environnement->e->c.s = 3.141593;
-    environnement->next = NULL;
+    Environnement environnement = newEnvironnement();
+    Expression e, valeur;
 
-    assign env_last = environnement;
+    valeur = new_expression();
+    valeur->type = SCALAR;
+    valeur->c.s = 3.141593;
+    env_definir(environnement, interner("pi", 2), valeur);
 
-    Expression e;
+    Node racine;
 
     int is_tty = isatty(0);
     if (is_tty) printf("\033[1mBonjour !\033[0m\n"); // convivialité !
@@ -491,25 +1984,30 @@ void run_parser() {
     mpc_parser_t *Row      = mpc_new("row");
     mpc_parser_t *Call     = mpc_new("call");
     mpc_parser_t *Solve    = mpc_new("solve");
+    mpc_parser_t *Args     = mpc_new("args");
 
     mpc_define(Ident, mpc_ident());
 
-    mpc_define(Constant, mpc_apply(mpc_re("-?([0-9]*\\.[0-9]+|[0-9]+\\.?)"), mpcf_float));
+    mpc_define(Constant, mpc_re("-?([0-9]*\\.[0-9]+|[0-9]+\\.?)"));
+
+    // l'analyse ne construit que l'arbre : les valeurs abandonnées lors
+    // d'un retour arrière sont des noeuds, libérés par deleteNode
+    mpc_dtor_t noeud = (mpc_dtor_t) deleteNode;
 
-    mpc_define(Expr, mpc_and(2, fold_sum,
+    mpc_define(Expr, mpc_and(2, fold_sum_first,
         Prod, mpc_many(fold_sum, mpc_and(2, fold_value,
             mpc_oneof("+-"), Prod,
             free
         )),
-        free
+        noeud
     ));
 
-    mpc_define(Prod, mpc_and(2, fold_prod,
+    mpc_define(Prod, mpc_and(2, fold_prod_first,
         Value, mpc_many(fold_prod, mpc_and(2, fold_value,
             mpc_oneof("*/"), Value,
             free
         )),
-        free
+        noeud
     ));
 
     mpc_define(Assign, mpc_and(3, fold_assign,
@@ -518,45 +2016,53 @@ void run_parser() {
     ));
 
     mpc_define(MatRow, mpc_and(2, fold_mat_row_first,
-        Expr, mpc_many(fold_mat_row, mpc_and(2, mpcf_snd,
+        Expr, mpc_many(fold_mat_row, mpc_and(2, mpcf_snd_free,
             mpc_char(','), Expr,
             free
         )),
-        free
+        noeud
     ));
 
     mpc_define(Mat, mpc_tok_squares(mpc_and(2, fold_mat_first,
-        MatRow, mpc_many(fold_mat, mpc_and(2, mpcf_snd,
+        MatRow, mpc_many(fold_mat, mpc_and(2, mpcf_snd_free,
             mpc_char(';'), MatRow,
             free
         )),
-        free
-    ), free));
+        noeud
+    ), noeud));
 
-    mpc_define(Call, mpc_and(2, call_to_expr,
+    mpc_define(Args, mpc_and(2, fold_args_first,
+        Expr, mpc_many(fold_args, mpc_and(2, mpcf_snd_free,
+            mpc_char(','), Expr,
+            free
+        )),
+        noeud
+    ));
+
+    mpc_define(Call, mpc_and(2, call_to_node,
         Ident,
-        mpc_parens(mpc_maybe(Expr), free),
+        mpc_parens(mpc_maybe(Args), noeud),
         free
     ));
 
     mpc_define(Value, mpc_strip(mpc_or(5,
         Call,
-        mpc_and(2, ident_to_expr, Ident, mpc_lift_val(environnement), free),
-        mpc_apply(Constant, val_to_expr),
+        mpc_apply(Ident, ident_to_node),
+        mpc_apply(Constant, val_to_node),
         Mat,
-        mpc_parens(Expr, free)
+        mpc_parens(Expr, noeud)
     )));
 
     mpc_define(Solve, mpc_and(4, fold_solve,
         Mat, mpc_char('X'), mpc_strip(mpc_char('=')), Mat,
-        free, free, free
+        noeud, free, free
     ));
 
     mpc_define(Line, mpc_strip(mpc_or(3,
         Solve, Assign, Expr
     )));
 
-    mpc_define(Input, mpc_whole(Line, free));
+    mpc_define(Input, mpc_whole(Line, noeud));
 
     mpc_optimise(Expr);
     mpc_optimise(Prod);
@@ -571,10 +2077,16 @@ void run_parser() {
     mpc_optimise(Mat);
     mpc_optimise(MatRow);
     mpc_optimise(Solve);
+    mpc_optimise(Args);
 
 
     mpc_result_t r;
 
+    // MATRIX_PARSEUR=mpc désactive l'analyseur direct : toutes les lignes
+    // passent par mpc (pour comparer les deux analyseurs)
+    const char * parseur = getenv("MATRIX_PARSEUR");
+    int direct = !parseur || strcmp(parseur, "mpc");
+
     // pour le getline
     char * line = NULL;
     size_t len = 0;
@@ -583,23 +2095,22 @@ void run_parser() {
     while ((getline(&line, &len, stdin)) != -1) {
         line[strcspn(line, "\r\n#")] = 0;
 
-        if (strlen(line) > 0) {
-            if (mpc_parse("input", line, Input, &r)) {
-                e = (Expression) r.output;
-                if (e->type == ASSIGN) {
-                    assign new_assign = malloc(sizeof(struct s_assign));
-                    new_assign->symbol = e->c.a->symbol;
-                    new_assign->e = new_expression();
-                    memcpy(new_assign->e, e->c.a->e, sizeof(struct s_expression));
-                    if (e->c.a->e->type == MATRIX) {
-                        new_assign->e->c.m = new_matrix_copy(e->c.a->e->c.m);
-                    }
-                    new_assign->next = NULL;
-                    env_last->next = new_assign;
-                    env_last = env_last->next;
-                }
-                print_expression(r.output);
-                free(r.output);
+        if (line[0] == ':') {
+            run_command(line, Input);
+        } else if (strlen(line) > 0) {
+            // l'analyseur direct reconnaît les lignes correctes, mpc ne sert
+            // qu'en cas d'échec, pour situer l'erreur
+            racine = direct ? pratt_analyser(line) : NULL;
+            if (racine || mpc_parse("input", line, Input, &r)) {
+                racine = simplifier(racine ? racine : (Node) r.output);
+                e = evaluer(racine, environnement);
+                // la valeur affectée passe à l'environnement, et elle est
+                // affichée depuis celui-ci, sans copie
+                if (e->type == ASSIGN) env_definir(environnement, e->c.a->symbole, e->c.a->e);
+                print_expression(e);
+                if (e->type == ASSIGN) free(e->c.a);
+                free(e);
+                deleteNode(racine);
             } else {
                 if (!is_tty) fprintf(stderr, "%s\n", line);
                 printf("%*s", (int) (is_tty ? r.error->state.col+4 : r.error->state.col), "");
@@ -614,9 +2125,13 @@ void run_parser() {
 
     if (line) free(line);
 
-    mpc_cleanup(13, Assign, Call, Constant, Ident, Expr, Prod, Value, Line, Input, Row, Mat, MatRow, Solve);
+    mpc_cleanup(14, Assign, Call, Constant, Ident, Expr, Prod, Value, Line, Input, Row, Mat, MatRow, Solve, Args);
+
+    deleteEnvironnement(environnement);
+    liberer_symboles();
+    sparse_lu_vider_cache();
 
-    free_env(environnement);
+    pool_shutdown();
 
     if (is_tty) printf("\n\033[1mAu revoir ! :)\033[0m\n"); // convivialité !
 }
@@ -0,0 +1,337 @@
+#include <stdlib.h>
+#include <string.h>
+#include "system.h"
+#include "ast.h"
+#include "nombre.h"
+#include "pratt.h"
+
+// Nombre de fils gardés sur la pile avant de passer au tas
+#define PRATT_PILE 16
+
+// Nombre de coefficients réservés au départ pour une matrice lue d'un bloc
+#define PRATT_BLOC 64
+
+// Fils d'un noeud en cours d'analyse
+typedef struct {
+    unsigned int nb, taille;
+    Node * t;
+    Node pile[PRATT_PILE];
+} liste_noeuds;
+
+// Niveaux de priorité, du plus faible au plus fort : le premier opérateur
+// ajoute le terme tel quel, le second l'enveloppe dans un noeud unaire
+typedef struct {
+    char op[3];
+    nature_noeud liste, unaire;
+} niveau;
+
+static const niveau niveaux[] = {
+    { "+-", NOEUD_SOMME, NOEUD_OPPOSE },
+    { "*/", NOEUD_PRODUIT, NOEUD_INVERSE }
+};
+
+#define NB_NIVEAUX (sizeof(niveaux) / sizeof(niveau))
+
+static Node expression(const char ** p, unsigned int k);
+
+static void initialiser(liste_noeuds * l) {
+    l->nb = 0;
+    l->taille = PRATT_PILE;
+    l->t = l->pile;
+}
+
+static void ajouter(liste_noeuds * l, Node n) {
+    Node * t;
+
+    if (l->nb == l->taille) {
+        t = allouer(2 * l->taille, sizeof(Node));
+        memcpy(t, l->t, l->nb * sizeof(Node));
+        if (l->t != l->pile) free(l->t);
+        l->t = t;
+        l->taille *= 2;
+    }
+    l->t[l->nb++] = n;
+}
+
+// Noeud dont les fils sont ceux de la liste, qui est vidée
+static Node terminer(liste_noeuds * l, nature_noeud nature) {
+    Node n = newNode(nature, l->nb);
+
+    memcpy(n->fils, l->t, l->nb * sizeof(Node));
+    if (l->t != l->pile) free(l->t);
+    return n;
+}
+
+// Abandon : libère les noeuds déjà construits
+static Node abandonner(liste_noeuds * l) {
+    unsigned int i;
+
+    for (i = 0; i < l->nb; i++) deleteNode(l->t[i]);
+    if (l->t != l->pile) free(l->t);
+    return NULL;
+}
+
+static int blanc(char c) {
+    return c == ' ' || c == '\f' || c == '\n' || c == '\r' || c == '\t' || c == '\v';
+}
+
+static int chiffre(char c) {
+    return c >= '0' && c <= '9';
+}
+
+static int lettre(char c) {
+    return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || c == '_';
+}
+
+static void blancs(const char ** p) {
+    while (blanc(**p)) (*p)++;
+}
+
+// Longueur de l'identifiant en p (0 s'il n'y en a pas)
+static size_t identifiant(const char * p) {
+    size_t n = 0;
+
+    if (!lettre(*p)) return 0;
+    while (lettre(p[n]) || chiffre(p[n])) n++;
+    return n;
+}
+
+static char * copier_nom(const char * p, size_t n) {
+    char * nom = allouer(n + 1, 1);
+
+    memcpy(nom, p, n);
+    nom[n] = 0;
+    return nom;
+}
+
+// Ajoute x à la fin du tableau t de taille *taille, agrandi au besoin
+static E * empiler(E * t, size_t * nb, size_t * taille, E x) {
+    if (*nb == *taille) {
+        *taille *= 2;
+        t = reallouer(t, *taille, sizeof(E));
+    }
+    t[(*nb)++] = x;
+    return t;
+}
+
+// Matrice [..;..] dont tous les coefficients sont des constantes, en p sur
+// le crochet ouvrant : les nombres sont écrits à la suite dans un seul
+// tableau, qui devient celui de la matrice, sans noeud par coefficient.
+// Les lignes plus courtes que la première sont complétées par des zéros.
+// Retourne NULL, sans avancer, si un coefficient n'est pas une constante
+// ou si une ligne est plus longue que la première.
+static Node bloc(const char ** p) {
+    const char * q = *p + 1;
+    size_t nb = 0, taille = PRATT_BLOC, k;
+    unsigned int lignes = 0, colonnes = 0, j = 0;
+    E * val = allouer(taille, sizeof(E));
+    E x;
+    Node n;
+
+    for (;;) {
+        blancs(&q);
+        if (!(k = lire_nombre(q, &x)) || (lignes && j == colonnes)) break;
+        q += k;
+        val = empiler(val, &nb, &taille, x);
+        j++;
+        blancs(&q);
+        if (*q == ',') {
+            q++;
+            continue;
+        }
+
+        // fin de ligne
+        if (!lignes) colonnes = j;
+        for (; j < colonnes; j++) val = empiler(val, &nb, &taille, 0);
+        lignes++;
+        j = 0;
+        if (*q == ';') {
+            q++;
+            continue;
+        }
+        if (*q != ']') break;
+
+        // on rend la place réservée en trop
+        n = newNode(NOEUD_MATRICE, 0);
+        n->m = newMatrix_buffer(lignes, colonnes, reallouer(val, nb, sizeof(E)));
+        *p = q + 1;
+        blancs(p);
+        return n;
+    }
+
+    free(val);
+    return NULL;
+}
+
+// Liste « e1 sep e2 sep ... » : arguments d'un appel ou coefficients
+// d'une ligne de matrice. Le séparateur doit suivre
+// directement l'expression, qui a déjà consommé ses blancs.
+static Node suite(const char ** p, char sep, nature_noeud nature) {
+    liste_noeuds l;
+    Node e;
+
+    initialiser(&l);
+    for (;;) {
+        if (!(e = expression(p, 0))) return abandonner(&l);
+        ajouter(&l, e);
+        if (**p != sep) break;
+        (*p)++;
+    }
+
+    return terminer(&l, nature);
+}
+
+// Matrice [l1; l2; ...], en p sur le crochet ouvrant
+static Node matrice(const char ** p) {
+    liste_noeuds l;
+    Node ligne;
+
+    if ((ligne = bloc(p))) return ligne;
+    (*p)++;
+    blancs(p);
+    initialiser(&l);
+    for (;;) {
+        if (!(ligne = suite(p, ',', NOEUD_LIGNE))) return abandonner(&l);
+        ajouter(&l, ligne);
+        if (**p != ';') break;
+        (*p)++;
+    }
+
+    blancs(p);
+    if (**p != ']') return abandonner(&l);
+    (*p)++;
+    blancs(p);
+
+    return terminer(&l, NOEUD_MATRICE);
+}
+
+// Valeur : appel, variable, constante, matrice ou expression entre
+// parenthèses, blancs compris de part et d'autre
+static Node valeur(const char ** p) {
+    Node v = NULL;
+    size_t n;
+    E x;
+
+    blancs(p);
+    if ((n = identifiant(*p))) {
+        if ((*p)[n] == '(') {
+            const char * debut = *p;
+            *p += n + 1;
+            if (**p == ')') v = newNode(NOEUD_APPEL, 0);
+            else if ((v = suite(p, ',', NOEUD_APPEL)) && **p != ')') {
+                deleteNode(v);
+                v = NULL;
+            }
+            if (!v) return NULL;
+            v->nom = copier_nom(debut, n);
+            (*p)++;
+        } else {
+            v = newNode(NOEUD_VARIABLE, 0);
+            v->symbole = interner(*p, n);
+            *p += n;
+        }
+    } else if ((n = lire_nombre(*p, &x))) {
+        v = newConstante(x);
+        *p += n;
+    } else if (**p == '[') {
+        if (!(v = matrice(p))) return NULL;
+    } else if (**p == '(') {
+        (*p)++;
+        if (!(v = expression(p, 0))) return NULL;
+        if (**p != ')') {
+            deleteNode(v);
+            return NULL;
+        }
+        (*p)++;
+    } else return NULL;
+
+    blancs(p);
+    return v;
+}
+
+// Opérandes du niveau de priorité k, séparées par ses opérateurs : une
+// somme ou un produit n'est construit que s'il y a au moins deux termes
+static Node expression(const char ** p, unsigned int k) {
+    const niveau * niv = niveaux + k;
+    liste_noeuds l;
+    Node e, u;
+    char op;
+
+    if (k == NB_NIVEAUX) return valeur(p);
+
+    if (!(e = expression(p, k + 1))) return NULL;
+    if (**p != niv->op[0] && **p != niv->op[1]) return e;
+
+    initialiser(&l);
+    ajouter(&l, e);
+    while (**p == niv->op[0] || **p == niv->op[1]) {
+        op = *(*p)++;
+        if (!(e = expression(p, k + 1))) return abandonner(&l);
+        if (op == niv->op[1]) {
+            u = newNode(niv->unaire, 1);
+            u->fils[0] = e;
+            e = u;
+        }
+        ajouter(&l, e);
+    }
+
+    return terminer(&l, niv->liste);
+}
+
+// Ligne entière : A X = B, nom = expression ou expression. Les choix se
+// font sur le premier caractère, sans revenir en arrière : une matrice
+// seule suivie de X est une résolution, un nom suivi de = une affectation.
+Node pratt_analyser(const char * ligne) {
+    const char * p = ligne;
+    Node e, b, r;
+    size_t n;
+    char debut;
+
+    blancs(&p);
+    debut = *p;
+    if ((n = identifiant(p))) {
+        const char * q = p + n;
+        blancs(&q);
+        if (*q == '=') {
+            q++;
+            if (!(e = expression(&q, 0))) return NULL;
+            if (*q) {
+                deleteNode(e);
+                return NULL;
+            }
+            r = newNode(NOEUD_AFFECTATION, 1);
+            r->symbole = interner(p, n);
+            r->fils[0] = e;
+            return r;
+        }
+    }
+
+    if (!(e = expression(&p, 0))) return NULL;
+
+    // une matrice entre parenthèses n'est pas un premier membre
+    if (*p == 'X' && e->nature == NOEUD_MATRICE && debut == '[') {
+        p++;
+        blancs(&p);
+        if (*p != '=') {
+            deleteNode(e);
+            return NULL;
+        }
+        p++;
+        blancs(&p);
+        if (*p != '[' || !(b = matrice(&p))) {
+            deleteNode(e);
+            return NULL;
+        }
+        r = newNode(NOEUD_RESOLUTION, 2);
+        r->fils[0] = e;
+        r->fils[1] = b;
+        e = r;
+    }
+
+    if (*p) {
+        deleteNode(e);
+        return NULL;
+    }
+
+    return e;
+}
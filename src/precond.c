@@ -0,0 +1,313 @@
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "system.h"
+#include "sparse.h"
+#include "threadpool.h"
+#include "precond.h"
+
+static Precond newPrecond(type_precond type, unsigned int n) {
+    Precond p = allouer(1, sizeof(struct precond));
+    p->type = type;
+    p->n = n;
+    p->diag = allouer(n, sizeof(double));
+    memset(&p->l, 0, sizeof(facteur_creux));
+    memset(&p->u, 0, sizeof(facteur_creux));
+    return p;
+}
+
+// Alloue un facteur de n lignes, ptr étant rempli ensuite
+static void allouer_facteur(facteur_creux * f, unsigned int n, size_t nnz) {
+    f->nnz = nnz;
+    f->ptr = allouer((size_t) n + 1, sizeof(size_t));
+    f->col = allouer(nnz, sizeof(unsigned int));
+    f->val = allouer(nnz, sizeof(double));
+}
+
+static void liberer_facteur(facteur_creux * f) {
+    free(f->ptr);
+    free(f->col);
+    free(f->val);
+}
+
+static void copier_facteur(facteur_creux * f, facteur_creux * source, unsigned int n) {
+    if (!source->ptr) {
+        memset(f, 0, sizeof(facteur_creux));
+        return;
+    }
+    allouer_facteur(f, n, source->nnz);
+    memcpy(f->ptr, source->ptr, ((size_t) n + 1) * sizeof(size_t));
+    memcpy(f->col, source->col, source->nnz * sizeof(unsigned int));
+    memcpy(f->val, source->val, source->nnz * sizeof(double));
+}
+
+void deletePrecond(Precond p) {
+    if (!p) return;
+    free(p->diag);
+    liberer_facteur(&p->l);
+    liberer_facteur(&p->u);
+    free(p);
+}
+
+Precond new_precond_copy(Precond p) {
+    Precond r = newPrecond(p->type, p->n);
+    memcpy(r->diag, p->diag, p->n * sizeof(double));
+    copier_facteur(&r->l, &p->l, p->n);
+    copier_facteur(&r->u, &p->u, p->n);
+    return r;
+}
+
+void printPrecond(Precond p) {
+    if (!p) {
+        print_error("No preconditioner to print");
+        return;
+    }
+
+    switch (p->type) {
+        case PRECOND_JACOBI:
+            printf("Préconditionneur de Jacobi %u x %u\n", p->n, p->n);
+            break;
+        case PRECOND_ILU0:
+            printf("Préconditionneur ILU(0) %u x %u, %zu coefficients\n", p->n, p->n,
+                   p->l.nnz + p->u.nnz + p->n);
+            break;
+        case PRECOND_IC0:
+            printf("Préconditionneur IC(0) %u x %u, %zu coefficients\n", p->n, p->n, p->l.nnz + p->n);
+            break;
+    }
+}
+
+
+// ---------------------------------------------------------------------
+// Construction
+// ---------------------------------------------------------------------
+
+// Position du coefficient diagonal dans la ligne i, ou row_ptr[i+1] s'il
+// n'est pas dans le motif (les colonnes sont triées)
+static size_t position_diagonale(Sparse a, unsigned int i) {
+    size_t k = a->row_ptr[i];
+    while (k < a->row_ptr[i + 1] && a->col[k] < i) k++;
+    return k < a->row_ptr[i + 1] && a->col[k] == i ? k : a->row_ptr[i + 1];
+}
+
+// Prépare les facteurs strictement inférieur (et supérieur si u n'est
+// pas NULL) sur le motif de a. Retourne 0 si un coefficient diagonal
+// manque.
+static int motif_triangulaire(Sparse a, facteur_creux * l, facteur_creux * u) {
+    unsigned int i, n = a->nb_rows;
+    size_t nl = 0, nu = 0, d;
+
+    for (i = 0; i < n; i++) {
+        d = position_diagonale(a, i);
+        if (d == a->row_ptr[i + 1]) return 0;
+        nl += d - a->row_ptr[i];
+        nu += a->row_ptr[i + 1] - d - 1;
+    }
+
+    allouer_facteur(l, n, nl);
+    if (u) allouer_facteur(u, n, nu);
+
+    nl = nu = 0;
+    for (i = 0; i < n; i++) {
+        d = position_diagonale(a, i);
+        l->ptr[i] = nl;
+        memcpy(l->col + nl, a->col + a->row_ptr[i], (d - a->row_ptr[i]) * sizeof(unsigned int));
+        nl += d - a->row_ptr[i];
+        if (u) {
+            u->ptr[i] = nu;
+            memcpy(u->col + nu, a->col + d + 1, (a->row_ptr[i + 1] - d - 1) * sizeof(unsigned int));
+            nu += a->row_ptr[i + 1] - d - 1;
+        }
+    }
+    l->ptr[n] = nl;
+    if (u) u->ptr[n] = nu;
+
+    return 1;
+}
+
+// M = diag(A). Retourne NULL si A n'est pas carrée ou si un coefficient
+// diagonal est nul.
+Precond precond_jacobi(Sparse a) {
+    unsigned int i;
+    size_t d;
+    Precond p;
+
+    if (a->nb_rows != a->nb_columns) return NULL;
+
+    p = newPrecond(PRECOND_JACOBI, a->nb_rows);
+    for (i = 0; i < p->n; i++) {
+        d = position_diagonale(a, i);
+        if (d == a->row_ptr[i + 1] || a->val[d] == 0) {
+            deletePrecond(p);
+            return NULL;
+        }
+        p->diag[i] = 1.0 / a->val[d];
+    }
+
+    return p;
+}
+
+// Factorisation LU incomplète sans remplissage (variante IKJ) : chaque
+// ligne de A est éparpillée dans w, puis éliminée par les lignes de U
+// déjà calculées en ne gardant que les positions du motif (marquées par
+// i + 1). Retourne NULL si A n'est pas carrée ou si un pivot est nul.
+Precond precond_ilu0(Sparse a) {
+    unsigned int i, j, k, n = a->nb_rows, * marque;
+    size_t q, r;
+    double * w, lik;
+    Precond p;
+
+    if (n != a->nb_columns) return NULL;
+
+    p = newPrecond(PRECOND_ILU0, n);
+    if (!motif_triangulaire(a, &p->l, &p->u)) {
+        deletePrecond(p);
+        return NULL;
+    }
+
+    w = allouer(n, sizeof(double));
+    marque = allouer_zero(n, sizeof(unsigned int));
+
+    for (i = 0; i < n; i++) {
+        for (q = a->row_ptr[i]; q < a->row_ptr[i + 1]; q++) {
+            w[a->col[q]] = a->val[q];
+            marque[a->col[q]] = i + 1;
+        }
+
+        for (q = p->l.ptr[i]; q < p->l.ptr[i + 1]; q++) {
+            k = p->l.col[q];
+            lik = w[k] *= p->diag[k];
+            for (r = p->u.ptr[k]; r < p->u.ptr[k + 1]; r++) {
+                j = p->u.col[r];
+                if (marque[j] == i + 1) w[j] -= lik * p->u.val[r];
+            }
+            p->l.val[q] = lik;
+        }
+
+        if (w[i] == 0) {
+            free(w);
+            free(marque);
+            deletePrecond(p);
+            return NULL;
+        }
+        p->diag[i] = 1 / w[i];
+        for (q = p->u.ptr[i]; q < p->u.ptr[i + 1]; q++) p->u.val[q] = w[p->u.col[q]];
+    }
+
+    free(w);
+    free(marque);
+
+    return p;
+}
+
+// Factorisation de Cholesky incomplète sans remplissage, ligne par ligne :
+// L_ij = (a_ij - somme_k L_ik L_jk) / L_jj sur le motif du triangle
+// inférieur de A (seul ce triangle est lu, A est supposée symétrique).
+// Retourne NULL si A n'est pas carrée ou si un pivot n'est pas positif.
+Precond precond_ic0(Sparse a) {
+    unsigned int i, j, n = a->nb_rows, * marque;
+    size_t q, r;
+    double * w, s;
+    Precond p;
+
+    if (n != a->nb_columns) return NULL;
+
+    p = newPrecond(PRECOND_IC0, n);
+    if (!motif_triangulaire(a, &p->l, NULL)) {
+        deletePrecond(p);
+        return NULL;
+    }
+
+    w = allouer(n, sizeof(double));
+    marque = allouer_zero(n, sizeof(unsigned int));
+
+    for (i = 0; i < n; i++) {
+        for (q = a->row_ptr[i]; q < a->row_ptr[i + 1] && a->col[q] <= i; q++) {
+            w[a->col[q]] = a->val[q];
+            marque[a->col[q]] = i + 1;
+        }
+
+        // w[k] vaut déjà L_ik pour les colonnes k < j du motif
+        s = w[i];
+        for (q = p->l.ptr[i]; q < p->l.ptr[i + 1]; q++) {
+            j = p->l.col[q];
+            for (r = p->l.ptr[j]; r < p->l.ptr[j + 1]; r++) {
+                if (marque[p->l.col[r]] == i + 1) w[j] -= w[p->l.col[r]] * p->l.val[r];
+            }
+            w[j] *= p->diag[j];
+            p->l.val[q] = w[j];
+            s -= w[j] * w[j];
+        }
+
+        if (!(s > 0)) {
+            free(w);
+            free(marque);
+            deletePrecond(p);
+            return NULL;
+        }
+        p->diag[i] = 1 / sqrt(s);
+    }
+
+    free(w);
+    free(marque);
+
+    return p;
+}
+
+
+// ---------------------------------------------------------------------
+// Application
+// ---------------------------------------------------------------------
+
+typedef struct {
+    const double * d;
+    const double * r;
+    double * z;
+} args_jacobi;
+
+static void jacobi_morceau(void * arg, size_t debut, size_t fin) {
+    args_jacobi * j = arg;
+    size_t i;
+
+    for (i = debut; i < fin; i++) j->z[i] = j->d[i] * j->r[i];
+}
+
+// z = M^-1 r. Les descentes et remontées triangulaires sont séquentielles,
+// seul Jacobi est parallélisé.
+void appliquer_precond(Precond p, const double * r, double * z) {
+    unsigned int i, n = p->n;
+    size_t q;
+    double s;
+    args_jacobi j;
+
+    if (p->type == PRECOND_JACOBI) {
+        j.d = p->diag;
+        j.r = r;
+        j.z = z;
+        parallel_for(0, n, PARALLEL_SEUIL, jacobi_morceau, &j);
+        return;
+    }
+
+    // descente L y = r (L unitaire pour ILU(0))
+    for (i = 0; i < n; i++) {
+        s = r[i];
+        for (q = p->l.ptr[i]; q < p->l.ptr[i + 1]; q++) s -= p->l.val[q] * z[p->l.col[q]];
+        z[i] = p->type == PRECOND_IC0 ? s * p->diag[i] : s;
+    }
+
+    if (p->type == PRECOND_ILU0) {
+        // remontée U z = y
+        for (i = n; i-- > 0; ) {
+            s = z[i];
+            for (q = p->u.ptr[i]; q < p->u.ptr[i + 1]; q++) s -= p->u.val[q] * z[p->u.col[q]];
+            z[i] = s * p->diag[i];
+        }
+    } else {
+        // remontée L^T z = y, par colonnes de L^T (lignes de L)
+        for (i = n; i-- > 0; ) {
+            z[i] *= p->diag[i];
+            for (q = p->l.ptr[i]; q < p->l.ptr[i + 1]; q++) z[p->l.col[q]] -= p->l.val[q] * z[i];
+        }
+    }
+}
@@ -0,0 +1,239 @@
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+#include "system.h"
+#include "matrix.h"
+#include "gemm.h"
+#include "trsm.h"
+#include "qr.h"
+
+// Réflexion de Householder de la colonne j (lignes j à m) : x devient
+// (beta, 0, ..., 0) et les coefficients sous la diagonale reçoivent v
+// (v_0 = 1 implicite). Retourne tau.
+static E reflexion(E * a, unsigned int m, unsigned int ld, unsigned int j) {
+    unsigned int i;
+    double alpha = a[(size_t) j * ld + j], norme = 0, beta;
+    E echelle;
+
+    for (i = j + 1; i < m; i++) norme += (double) a[(size_t) i * ld + j] * a[(size_t) i * ld + j];
+    if (norme == 0) return 0;
+
+    beta = -copysign(sqrt(alpha * alpha + norme), alpha);
+    echelle = 1 / (alpha - beta);
+    for (i = j + 1; i < m; i++) a[(size_t) i * ld + j] *= echelle;
+    a[(size_t) j * ld + j] = beta;
+
+    return (beta - alpha) / beta;
+}
+
+// Factorisation non bloquée du panneau [k0, k1[ (lignes k0 à m) : chaque
+// réflexion est appliquée immédiatement aux colonnes restantes du panneau,
+// ligne par ligne pour parcourir la mémoire dans l'ordre
+static void panneau(E * a, unsigned int m, unsigned int n, unsigned int k0, unsigned int k1, E * tau) {
+    unsigned int i, j, c;
+    double * w = allouer(QR_NB, sizeof(double));
+    E * ai, vi;
+
+
+    for (j = k0; j < k1; j++) {
+        tau[j] = reflexion(a, m, n, j);
+        if (tau[j] == 0 || j + 1 == k1) continue;
+        // w = tau (v^T A[j:m, j+1:k1])
+        ai = a + (size_t) j * n;
+        for (c = j + 1; c < k1; c++) w[c - j - 1] = ai[c];
+        for (i = j + 1; i < m; i++) {
+            ai = a + (size_t) i * n;
+            vi = ai[j];
+            for (c = j + 1; c < k1; c++) w[c - j - 1] += (double) vi * ai[c];
+        }
+        for (c = j + 1; c < k1; c++) w[c - j - 1] *= tau[j];
+        ai = a + (size_t) j * n;
+        for (c = j + 1; c < k1; c++) ai[c] -= w[c - j - 1];
+        for (i = j + 1; i < m; i++) {
+            ai = a + (size_t) i * n;
+            vi = ai[j];
+            for (c = j + 1; c < k1; c++) ai[c] -= w[c - j - 1] * vi;
+        }
+    }
+
+    free(w);
+}
+
+// Copie les vecteurs du panneau [k0, k1[ dans v ((m - k0) x nb) avec les
+// uns de la diagonale et les zéros au-dessus, puis forme le facteur
+// triangulaire supérieur t (nb x nb) tel que
+// H_k0 ... H_{k1-1} = I - V T V^T (représentation WY compacte)
+static void facteur_wy(const E * a, unsigned int m, unsigned int n, unsigned int k0, unsigned int k1,
+                       const E * tau, E * v, E * t) {
+    unsigned int nb = k1 - k0, i, j, p;
+    double s, * y = allouer(nb, sizeof(double));
+
+
+    for (i = k0; i < m; i++) {
+        E * vi = v + (size_t) (i - k0) * nb;
+        for (j = 0; j < nb; j++) {
+            if (i - k0 < j) vi[j] = 0;
+            else if (i - k0 == j) vi[j] = 1;
+            else vi[j] = a[(size_t) i * n + k0 + j];
+        }
+    }
+
+    // T[0:j, j] = -tau_j T[0:j, 0:j] (V[:, 0:j]^T v_j)
+    memset(t, 0, (size_t) nb * nb * sizeof(E));
+    for (j = 0; j < nb; j++) {
+        t[(size_t) j * nb + j] = tau[k0 + j];
+        for (p = 0; p < j; p++) {
+            s = 0;
+            for (i = j; i < m - k0; i++) s += (double) v[(size_t) i * nb + p] * v[(size_t) i * nb + j];
+            y[p] = s;
+        }
+        for (p = 0; p < j; p++) {
+            s = 0;
+            for (i = p; i < j; i++) s += t[(size_t) p * nb + i] * y[i];
+            t[(size_t) p * nb + j] = -tau[k0 + j] * s;
+        }
+    }
+
+    free(y);
+}
+
+// C = (I - V op(T) V^T) C, avec op(T) = T^T si trans vaut 1.
+// V est de taille r x nb, C de taille r x nc (pas ldc). Les deux
+// produits passent par GEMM.
+static void appliquer_bloc(int trans, unsigned int r, unsigned int nb, const E * v, const E * t,
+                           E * c, unsigned int nc, unsigned int ldc) {
+    unsigned int i, j, p;
+    E * w = allouer((size_t) nb * nc, sizeof(E)), * tw = allouer((size_t) nb * nc, sizeof(E));
+    double s;
+
+    // W = V^T C
+    gemm_t(1, 0, nb, nc, r, 1, v, nb, c, ldc, 0, w, nc);
+
+    // W = op(T) W (T triangulaire supérieure)
+    for (i = 0; i < nb; i++) {
+        for (j = 0; j < nc; j++) {
+            s = 0;
+            if (trans) for (p = 0; p <= i; p++) s += t[(size_t) p * nb + i] * w[(size_t) p * nc + j];
+            else for (p = i; p < nb; p++) s += t[(size_t) i * nb + p] * w[(size_t) p * nc + j];
+            tw[(size_t) i * nc + j] = s;
+        }
+    }
+
+    // C -= V W
+    gemm(r, nc, nb, -1, v, nb, tw, nc, 1, c, ldc);
+
+    free(w);
+    free(tw);
+}
+
+// Factorisation QR par blocs (variante « right-looking ») en place : pour
+// chaque panneau de QR_NB colonnes,
+//   1. factorisation non bloquée du panneau
+//   2. représentation WY compacte I - V T V^T du produit des réflexions
+//   3. mise à jour du reste de la matrice par deux GEMM
+QR decomposition_QR_en_place(Matrix m) {
+    unsigned int nr = m->nb_rows, nc = m->nb_columns, k = nr < nc ? nr : nc, k0, k1;
+    E * a = m->mat, * v = allouer((size_t) nr * QR_NB, sizeof(E)), * t = allouer(QR_NB * QR_NB, sizeof(E));
+    QR f;
+
+    f.qr = m;
+    f.tau = allouer(k, sizeof(E));
+
+    for (k0 = 0; k0 < k; k0 = k1) {
+        k1 = k - k0 < QR_NB ? k : k0 + QR_NB;
+        panneau(a, nr, nc, k0, k1, f.tau);
+        if (k1 == nc) continue;
+        facteur_wy(a, nr, nc, k0, k1, f.tau, v, t);
+        appliquer_bloc(1, nr - k0, k1 - k0, v, t, a + (size_t) k0 * nc + k1, nc - k1, nc);
+    }
+
+    free(v);
+    free(t);
+
+    return f;
+}
+
+QR decomposition_QR(Matrix m) {
+    return decomposition_QR_en_place(new_matrix_copy(m));
+}
+
+void deleteQR(QR f) {
+    deleteMatrix(f.qr);
+    free(f.tau);
+}
+
+// B = Q^T B (B a autant de lignes que A)
+void appliquer_qt(QR f, Matrix b) {
+    unsigned int nr = f.qr->nb_rows, nc = f.qr->nb_columns, k = nr < nc ? nr : nc, k0, k1;
+    E * v = allouer((size_t) nr * QR_NB, sizeof(E)), * t = allouer(QR_NB * QR_NB, sizeof(E));
+
+    for (k0 = 0; k0 < k; k0 = k1) {
+        k1 = k - k0 < QR_NB ? k : k0 + QR_NB;
+        facteur_wy(f.qr->mat, nr, nc, k0, k1, f.tau, v, t);
+        appliquer_bloc(1, nr - k0, k1 - k0, v, t, b->mat + (size_t) k0 * b->nb_columns,
+                       b->nb_columns, b->nb_columns);
+    }
+
+    free(v);
+    free(t);
+}
+
+// Retourne les min(m, n) premières colonnes de Q (Q entière si A est
+// carrée), en appliquant les blocs de réflexions du dernier au premier
+Matrix QR_q(QR f) {
+    unsigned int nr = f.qr->nb_rows, nc = f.qr->nb_columns, k = nr < nc ? nr : nc, k0, k1, i;
+    E * v = allouer((size_t) nr * QR_NB, sizeof(E)), * t = allouer(QR_NB * QR_NB, sizeof(E));
+    Matrix q = newMatrix(nr, k);
+
+    memset(q->mat, 0, (size_t) nr * k * sizeof(E));
+    for (i = 0; i < k; i++) q->mat[(size_t) i * k + i] = 1;
+
+    for (k1 = k; k1 > 0; k1 = k0) {
+        k0 = (k1 - 1) / QR_NB * QR_NB;
+        facteur_wy(f.qr->mat, nr, nc, k0, k1, f.tau, v, t);
+        appliquer_bloc(0, nr - k0, k1 - k0, v, t, q->mat + (size_t) k0 * k, k, k);
+    }
+
+    free(v);
+    free(t);
+
+    return q;
+}
+
+// Retourne R (min(m, n) x n, triangulaire supérieure)
+Matrix QR_r(QR f) {
+    unsigned int nr = f.qr->nb_rows, nc = f.qr->nb_columns, k = nr < nc ? nr : nc, i, j;
+    Matrix r = newMatrix(k, nc);
+
+    for (i = 0; i < k; i++) {
+        for (j = 0; j < nc; j++) {
+            r->mat[(size_t) i * nc + j] = j < i ? 0 : f.qr->mat[(size_t) i * nc + j];
+        }
+    }
+
+    return r;
+}
+
+// Solution au sens des moindres carrés de A X = B : X minimise ||A X - B||
+// colonne par colonne. On calcule Q^T B puis on résout R X = (Q^T B)[0:n].
+// Retourne NULL si A n'est pas de rang plein.
+// prec : A a au moins autant de lignes que de colonnes, B autant de lignes que A
+Matrix resolution_QR(QR f, Matrix b) {
+    unsigned int nc = f.qr->nb_columns, p = b->nb_columns, i;
+    Matrix c, x;
+
+    for (i = 0; i < nc; i++) {
+        if (f.qr->mat[(size_t) i * nc + i] == 0) return NULL;
+    }
+
+    c = new_matrix_copy(b);
+    appliquer_qt(f, c);
+
+    x = newMatrix(nc, p);
+    memcpy(x->mat, c->mat, (size_t) nc * p * sizeof(E));
+    trsm(TRI_SUP, 0, 0, nc, p, f.qr->mat, nc, x->mat, p);
+
+    deleteMatrix(c);
+
+    return x;
+}
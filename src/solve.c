@@ -0,0 +1,38 @@
+#include <stdlib.h>
+#include "matrix.h"
+#include "lu.h"
+#include "cholesky.h"
+#include "qr.h"
+#include "solve.h"
+
+// Résout A X = B sans former l'inverse de A : factorisation puis
+// résolutions triangulaires sur toutes les colonnes de B à la fois.
+// Cholesky est tenté si A est symétrique, LU sinon ou en cas d'échec.
+// Si A a plus de lignes que de colonnes, X est la solution au sens des
+// moindres carrés, obtenue par factorisation QR.
+// Retourne NULL si A est singulière (ou n'est pas de rang plein).
+// prec : A a au moins autant de lignes que de colonnes, B autant de lignes que A
+Matrix resolution(Matrix a, Matrix b) {
+    LU f;
+    QR q;
+    Matrix l, x = NULL;
+
+    if (a->nb_rows > a->nb_columns) {
+        q = decomposition_QR(a);
+        x = resolution_QR(q, b);
+        deleteQR(q);
+        return x;
+    }
+
+    if (isSymetric(a) && (l = decomposition_cholesky(a))) {
+        x = resolution_cholesky(l, b);
+        deleteMatrix(l);
+        return x;
+    }
+
+    f = decomposition_LU(a);
+    if (!f.singuliere) x = resolution_LU(f, b);
+    deleteLU(f);
+
+    return x;
+}
@@ -0,0 +1,469 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "system.h"
+#include "matrix.h"
+#include "threadpool.h"
+#include "sparse.h"
+
+Sparse newSparse(unsigned int nb_rows, unsigned int nb_columns, size_t nnz) {
+    Sparse s = allouer(1, sizeof(struct sparse));
+    s->nb_rows = nb_rows;
+    s->nb_columns = nb_columns;
+    s->nnz = nnz;
+    s->row_ptr = allouer_zero((size_t) nb_rows + 1, sizeof(size_t));
+    s->col = allouer(nnz, sizeof(unsigned int));
+    s->val = allouer(nnz, sizeof(E));
+    return s;
+}
+
+void deleteSparse(Sparse s) {
+    if (!s) return;
+    free(s->row_ptr);
+    free(s->col);
+    free(s->val);
+    free(s);
+}
+
+// Vaut 1 si une matrice de cette taille avec nnz coefficients non nuls
+// prend moins de place (et se multiplie plus vite) en CSR
+int sparse_preferable(unsigned int nb_rows, unsigned int nb_columns, size_t nnz) {
+    double taille = (double) nb_rows * nb_columns;
+    return taille >= SPARSE_TAILLE_MIN && nnz <= SPARSE_DENSITE_MAX * taille;
+}
+
+Sparse new_sparse_copy(Sparse s) {
+    Sparse r = newSparse(s->nb_rows, s->nb_columns, s->nnz);
+    memcpy(r->row_ptr, s->row_ptr, ((size_t) s->nb_rows + 1) * sizeof(size_t));
+    memcpy(r->col, s->col, s->nnz * sizeof(unsigned int));
+    memcpy(r->val, s->val, s->nnz * sizeof(E));
+    return r;
+}
+
+// Alloue col et val une fois row_ptr rempli avec le nombre de coefficients
+// de chaque ligne (row_ptr[i+1]) : somme préfixe puis allocation
+static void sparse_finaliser_structure(Sparse s) {
+    unsigned int i;
+
+    for (i = 0; i < s->nb_rows; i++) s->row_ptr[i + 1] += s->row_ptr[i];
+    s->nnz = s->row_ptr[s->nb_rows];
+    free(s->col);
+    free(s->val);
+    s->col = allouer(s->nnz, sizeof(unsigned int));
+    s->val = allouer(s->nnz, sizeof(E));
+}
+
+// Retire les coefficients nuls (compensations d'un produit, facteur nul),
+// pour que nnz ne compte que les vrais coefficients non nuls
+static void sparse_compacter(Sparse s) {
+    size_t p, r = 0, debut = 0;
+    unsigned int i;
+
+    for (i = 0; i < s->nb_rows; i++) {
+        for (p = debut; p < s->row_ptr[i + 1]; p++) {
+            if (s->val[p] == 0) continue;
+            s->col[r] = s->col[p];
+            s->val[r++] = s->val[p];
+        }
+        debut = s->row_ptr[i + 1];
+        s->row_ptr[i + 1] = r;
+    }
+    s->nnz = r;
+}
+
+// Grain des boucles parallèles sur les lignes, selon le travail moyen
+// par ligne
+static size_t grain_lignes(size_t travail, unsigned int nb_rows) {
+    size_t par_ligne = nb_rows ? travail / nb_rows + 1 : 1;
+    return PARALLEL_SEUIL / par_ligne + 1;
+}
+
+
+// ---------------------------------------------------------------------
+// Conversions
+// ---------------------------------------------------------------------
+
+typedef struct {
+    const Matrix m;
+    Sparse s;
+} args_conversion;
+
+static void compter_morceau(void * arg, size_t debut, size_t fin) {
+    args_conversion * c = arg;
+    unsigned int n = c->m->nb_columns, j;
+    size_t i, nb;
+
+    for (i = debut; i < fin; i++) {
+        const E * ligne = c->m->mat + i * n;
+        nb = 0;
+        for (j = 0; j < n; j++) nb += ligne[j] != 0;
+        c->s->row_ptr[i + 1] = nb;
+    }
+}
+
+static void remplir_morceau(void * arg, size_t debut, size_t fin) {
+    args_conversion * c = arg;
+    unsigned int n = c->m->nb_columns, j;
+    size_t i, p;
+
+    for (i = debut; i < fin; i++) {
+        const E * ligne = c->m->mat + i * n;
+        p = c->s->row_ptr[i];
+        for (j = 0; j < n; j++) {
+            if (ligne[j] != 0) {
+                c->s->col[p] = j;
+                c->s->val[p++] = ligne[j];
+            }
+        }
+    }
+}
+
+// Ne garde que les coefficients non nuls de m
+Sparse dense_to_sparse(Matrix m) {
+    Sparse s = newSparse(m->nb_rows, m->nb_columns, 0);
+    args_conversion c = { m, s };
+    size_t grain = grain_lignes((size_t) m->nb_rows * m->nb_columns, m->nb_rows);
+
+    parallel_for(0, m->nb_rows, grain, compter_morceau, &c);
+    sparse_finaliser_structure(s);
+    parallel_for(0, m->nb_rows, grain, remplir_morceau, &c);
+
+    return s;
+}
+
+Matrix sparse_to_dense(Sparse s) {
+    Matrix m = newMatrix(s->nb_rows, s->nb_columns);
+    unsigned int i;
+    size_t p;
+
+    for (i = 0; i < s->nb_rows; i++) {
+        E * ligne = m->mat + (size_t) i * s->nb_columns;
+        for (p = s->row_ptr[i]; p < s->row_ptr[i + 1]; p++) ligne[s->col[p]] = s->val[p];
+    }
+
+    return m;
+}
+
+// Les petites matrices sont affichées comme les matrices denses, les
+// grandes par leurs dimensions et leur nombre de coefficients non nuls
+void printSparse(Sparse s) {
+    Matrix m;
+
+    if (!s) {
+        print_error("No matrix to print");
+        return;
+    }
+
+    if ((size_t) s->nb_rows * s->nb_columns <= AFFICHAGE_MAX) {
+        m = sparse_to_dense(s);
+        printMatrix(m);
+        deleteMatrix(m);
+    } else {
+        printf("Matrice creuse %u x %u, %zu coefficients non nuls (%.2f %%)\n",
+               s->nb_rows, s->nb_columns, s->nnz,
+               100.0 * s->nnz / ((double) s->nb_rows * s->nb_columns));
+    }
+}
+
+// Transposée par tri par dénombrement sur les colonnes : les lignes de la
+// transposée sont remplies dans l'ordre, donc leurs colonnes restent triées
+Sparse sparse_transpose(Sparse s) {
+    Sparse t = newSparse(s->nb_columns, s->nb_rows, s->nnz);
+    size_t * pos = allouer((size_t) s->nb_columns + 1, sizeof(size_t)), p, q;
+    unsigned int i;
+
+    for (p = 0; p < s->nnz; p++) t->row_ptr[s->col[p] + 1]++;
+    for (i = 0; i < s->nb_columns; i++) t->row_ptr[i + 1] += t->row_ptr[i];
+    memcpy(pos, t->row_ptr, ((size_t) s->nb_columns + 1) * sizeof(size_t));
+
+    for (i = 0; i < s->nb_rows; i++) {
+        for (p = s->row_ptr[i]; p < s->row_ptr[i + 1]; p++) {
+            q = pos[s->col[p]]++;
+            t->col[q] = i;
+            t->val[q] = s->val[p];
+        }
+    }
+
+    free(pos);
+
+    return t;
+}
+
+Sparse sparse_mult_scalar(E k, Sparse s) {
+    Sparse r = new_sparse_copy(s);
+    size_t p;
+
+    for (p = 0; p < r->nnz; p++) r->val[p] *= k;
+    sparse_compacter(r);
+
+    return r;
+}
+
+
+// ---------------------------------------------------------------------
+// Produits avec une matrice dense
+// ---------------------------------------------------------------------
+
+typedef struct {
+    Sparse s;
+    Matrix d;
+    Matrix r;
+} args_mixte;
+
+// Lignes [debut, fin[ de C = A B : c_i = somme des a_ik b_k
+static void spmm_morceau(void * arg, size_t debut, size_t fin) {
+    args_mixte * a = arg;
+    unsigned int m = a->d->nb_columns, j;
+    size_t i, p;
+
+    for (i = debut; i < fin; i++) {
+        E * ci = a->r->mat + i * m;
+        if (m == 1) {
+            // produit matrice-vecteur : simple produit scalaire creux
+            E s = 0;
+            for (p = a->s->row_ptr[i]; p < a->s->row_ptr[i + 1]; p++) s += a->s->val[p] * a->d->mat[a->s->col[p]];
+            ci[0] = s;
+            continue;
+        }
+        for (p = a->s->row_ptr[i]; p < a->s->row_ptr[i + 1]; p++) {
+            const E * bk = a->d->mat + (size_t) a->s->col[p] * m;
+            E v = a->s->val[p];
+            for (j = 0; j < m; j++) ci[j] += v * bk[j];
+        }
+    }
+}
+
+// Produit creux x dense (SpMV si b n'a qu'une colonne), lignes réparties
+// sur le pool. Retourne NULL si les dimensions ne correspondent pas.
+Matrix sparse_mult_dense(Sparse a, Matrix b) {
+    Matrix r;
+    args_mixte m;
+
+    if (a->nb_columns != b->nb_rows) return NULL;
+
+    r = newMatrix(a->nb_rows, b->nb_columns);
+    m.s = a;
+    m.d = b;
+    m.r = r;
+    parallel_for(0, a->nb_rows, grain_lignes(a->nnz * b->nb_columns, a->nb_rows), spmm_morceau, &m);
+
+    return r;
+}
+
+// Lignes [debut, fin[ de C = A B avec B creuse : c_i = somme des a_ik b_k
+// où b_k est une ligne creuse
+static void dense_sparse_morceau(void * arg, size_t debut, size_t fin) {
+    args_mixte * a = arg;
+    unsigned int n = a->d->nb_columns, m = a->s->nb_columns, k;
+    size_t i, p;
+
+    for (i = debut; i < fin; i++) {
+        const E * ai = a->d->mat + i * n;
+        E * ci = a->r->mat + i * m;
+        for (k = 0; k < n; k++) {
+            E v = ai[k];
+            if (v == 0) continue;
+            for (p = a->s->row_ptr[k]; p < a->s->row_ptr[k + 1]; p++) ci[a->s->col[p]] += v * a->s->val[p];
+        }
+    }
+}
+
+// Produit dense x creux. Retourne NULL si les dimensions ne correspondent pas.
+Matrix dense_mult_sparse(Matrix a, Sparse b) {
+    Matrix r;
+    args_mixte m;
+
+    if (a->nb_columns != b->nb_rows) return NULL;
+
+    r = newMatrix(a->nb_rows, b->nb_columns);
+    m.s = b;
+    m.d = a;
+    m.r = r;
+    parallel_for(0, a->nb_rows, grain_lignes((size_t) a->nb_rows * a->nb_columns + b->nnz * (size_t) a->nb_rows,
+                                             a->nb_rows), dense_sparse_morceau, &m);
+
+    return r;
+}
+
+
+// ---------------------------------------------------------------------
+// Produit creux x creux (Gustavson)
+// ---------------------------------------------------------------------
+
+typedef struct {
+    Sparse a;
+    Sparse b;
+    Sparse c;
+} args_spgemm;
+
+static int compare_colonnes(const void * x, const void * y) {
+    unsigned int a = *(const unsigned int *) x, b = *(const unsigned int *) y;
+    return a < b ? -1 : a > b;
+}
+
+// Phase symbolique : nombre de colonnes distinctes de chaque ligne de C,
+// repérées par un tableau de marques propre à la tâche
+static void spgemm_symbolique(void * arg, size_t debut, size_t fin) {
+    args_spgemm * g = arg;
+    Sparse a = g->a, b = g->b;
+    size_t * marque = allouer(b->nb_columns, sizeof(size_t)), i, p, q, nb;
+    unsigned int j;
+
+    for (j = 0; j < b->nb_columns; j++) marque[j] = (size_t) -1;
+
+    for (i = debut; i < fin; i++) {
+        nb = 0;
+        for (p = a->row_ptr[i]; p < a->row_ptr[i + 1]; p++) {
+            unsigned int k = a->col[p];
+            for (q = b->row_ptr[k]; q < b->row_ptr[k + 1]; q++) {
+                j = b->col[q];
+                if (marque[j] != i) {
+                    marque[j] = i;
+                    nb++;
+                }
+            }
+        }
+        g->c->row_ptr[i + 1] = nb;
+    }
+
+    free(marque);
+}
+
+// Phase numérique : accumulation dans un tableau dense de la taille d'une
+// ligne, puis recopie des colonnes touchées, triées
+static void spgemm_numerique(void * arg, size_t debut, size_t fin) {
+    args_spgemm * g = arg;
+    Sparse a = g->a, b = g->b, c = g->c;
+    size_t * marque = allouer(b->nb_columns, sizeof(size_t)), i, p, q, d, f;
+    E * acc = allouer(b->nb_columns, sizeof(E));
+    unsigned int j;
+
+    for (j = 0; j < b->nb_columns; j++) marque[j] = (size_t) -1;
+
+    for (i = debut; i < fin; i++) {
+        d = f = c->row_ptr[i];
+        for (p = a->row_ptr[i]; p < a->row_ptr[i + 1]; p++) {
+            unsigned int k = a->col[p];
+            E v = a->val[p];
+            for (q = b->row_ptr[k]; q < b->row_ptr[k + 1]; q++) {
+                j = b->col[q];
+                if (marque[j] != i) {
+                    marque[j] = i;
+                    acc[j] = 0;
+                    c->col[f++] = j;
+                }
+                acc[j] += v * b->val[q];
+            }
+        }
+        qsort(c->col + d, f - d, sizeof(unsigned int), compare_colonnes);
+        for (p = d; p < f; p++) c->val[p] = acc[c->col[p]];
+    }
+
+    free(marque);
+    free(acc);
+}
+
+// Produit creux x creux par l'algorithme de Gustavson, en deux passes
+// (structure puis valeurs) réparties par lignes sur le pool.
+// Retourne NULL si les dimensions ne correspondent pas.
+Sparse sparse_multiplication(Sparse a, Sparse b) {
+    Sparse c;
+    args_spgemm g;
+    size_t travail = 0, p;
+
+    if (a->nb_columns != b->nb_rows) return NULL;
+
+    for (p = 0; p < a->nnz; p++) travail += b->row_ptr[a->col[p] + 1] - b->row_ptr[a->col[p]];
+
+    c = newSparse(a->nb_rows, b->nb_columns, 0);
+    g.a = a;
+    g.b = b;
+    g.c = c;
+
+    parallel_for(0, a->nb_rows, grain_lignes(travail + b->nb_columns, a->nb_rows), spgemm_symbolique, &g);
+    sparse_finaliser_structure(c);
+    parallel_for(0, a->nb_rows, grain_lignes(travail + b->nb_columns, a->nb_rows), spgemm_numerique, &g);
+    sparse_compacter(c);
+
+    return c;
+}
+
+
+// ---------------------------------------------------------------------
+// Sommes
+// ---------------------------------------------------------------------
+
+// Fusion des lignes i de a et b ; si c est NULL, on ne fait que compter.
+// Les coefficients dont la somme est nulle sont omis : les deux passes
+// calculant les mêmes sommes, elles omettent les mêmes.
+static size_t fusion_lignes(Sparse a, Sparse b, size_t i, Sparse c) {
+    size_t p = a->row_ptr[i], pf = a->row_ptr[i + 1];
+    size_t q = b->row_ptr[i], qf = b->row_ptr[i + 1];
+    size_t r = c ? c->row_ptr[i] : 0, nb = 0;
+
+    while (p < pf || q < qf) {
+        unsigned int j;
+        E v;
+        if (q == qf || (p < pf && a->col[p] < b->col[q])) {
+            j = a->col[p];
+            v = a->val[p++];
+        } else if (p == pf || b->col[q] < a->col[p]) {
+            j = b->col[q];
+            v = b->val[q++];
+        } else {
+            j = a->col[p];
+            v = a->val[p++] + b->val[q++];
+        }
+        if (v == 0) continue;
+        if (c) {
+            c->col[r + nb] = j;
+            c->val[r + nb] = v;
+        }
+        nb++;
+    }
+
+    return nb;
+}
+
+static void addition_symbolique(void * arg, size_t debut, size_t fin) {
+    args_spgemm * g = arg;
+    size_t i;
+
+    for (i = debut; i < fin; i++) g->c->row_ptr[i + 1] = fusion_lignes(g->a, g->b, i, NULL);
+}
+
+static void addition_numerique(void * arg, size_t debut, size_t fin) {
+    args_spgemm * g = arg;
+    size_t i;
+
+    for (i = debut; i < fin; i++) fusion_lignes(g->a, g->b, i, g->c);
+}
+
+// Somme creux + creux : fusion des lignes triées, en deux passes.
+// prec : a et b de même dimension
+Sparse sparse_addition(Sparse a, Sparse b) {
+    Sparse c = newSparse(a->nb_rows, a->nb_columns, 0);
+    args_spgemm g = { a, b, c };
+    size_t grain = grain_lignes(a->nnz + b->nnz, a->nb_rows);
+
+    parallel_for(0, a->nb_rows, grain, addition_symbolique, &g);
+    sparse_finaliser_structure(c);
+    parallel_for(0, a->nb_rows, grain, addition_numerique, &g);
+
+    return c;
+}
+
+// Somme creux + dense, dont le résultat est dense
+// prec : a et b de même dimension
+Matrix sparse_addition_dense(Sparse a, Matrix b) {
+    Matrix r = new_matrix_copy(b);
+    unsigned int i;
+    size_t p;
+
+    for (i = 0; i < a->nb_rows; i++) {
+        E * ligne = r->mat + (size_t) i * a->nb_columns;
+        for (p = a->row_ptr[i]; p < a->row_ptr[i + 1]; p++) ligne[a->col[p]] += a->val[p];
+    }
+
+    return r;
+}
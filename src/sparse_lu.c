@@ -0,0 +1,669 @@
+#include <limits.h>
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+#include "system.h"
+#include "matrix.h"
+#include "sparse.h"
+#include "threadpool.h"
+#include "sparse_lu.h"
+
+#define AUCUN UINT_MAX
+
+static int compare_indices(const void * x, const void * y) {
+    unsigned int a = *(const unsigned int *) x, b = *(const unsigned int *) y;
+    return (a > b) - (a < b);
+}
+
+
+// ---------------------------------------------------------------------
+// Ordre de degré minimum
+// ---------------------------------------------------------------------
+
+// Liste d'indices extensible
+typedef struct {
+    unsigned int * d;
+    unsigned int n;
+    unsigned int cap;
+} liste;
+
+static void ajouter(liste * l, unsigned int v) {
+    if (l->n == l->cap) {
+        l->cap = l->cap ? 2 * l->cap : 4;
+        l->d = reallouer(l->d, l->cap, sizeof(unsigned int));
+    }
+    l->d[l->n++] = v;
+}
+
+static void vider(liste * l) {
+    free(l->d);
+    l->d = NULL;
+    l->n = l->cap = 0;
+}
+
+enum { VARIABLE, ELEMENT, ABSORBE };
+
+// Listes chaînées des variables par degré
+typedef struct {
+    unsigned int * tete;
+    unsigned int * suiv;
+    unsigned int * prec;
+    unsigned int * deg;
+} paquets;
+
+static void inserer(paquets * p, unsigned int i, unsigned int d) {
+    p->deg[i] = d;
+    p->prec[i] = AUCUN;
+    p->suiv[i] = p->tete[d];
+    if (p->tete[d] != AUCUN) p->prec[p->tete[d]] = i;
+    p->tete[d] = i;
+}
+
+static void retirer(paquets * p, unsigned int i) {
+    if (p->prec[i] != AUCUN) p->suiv[p->prec[i]] = p->suiv[i];
+    else p->tete[p->deg[i]] = p->suiv[i];
+    if (p->suiv[i] != AUCUN) p->prec[p->suiv[i]] = p->prec[i];
+}
+
+// Ordre de degré minimum approché sur le graphe quotient (à la manière
+// d'AMD, sans supervariables) du motif symétrique ptr / col, sans
+// diagonale. Chaque variable éliminée p devient un élément dont la liste
+// Lp remplace toutes les arêtes créées par son élimination ; le degré
+// d'une variable i de Lp est majoré par |A_i| + |Lp| - 1 + somme des
+// |Le \ Lp| pour les autres éléments e voisins de i, et les éléments
+// inclus dans Lp sont absorbés. perm[k] est la variable éliminée à
+// l'étape k.
+static unsigned int * ordre_degre_minimum(unsigned int n, size_t * ptr, unsigned int * col) {
+    unsigned int * perm = allouer(n, sizeof(unsigned int));
+    unsigned int * marque = allouer_zero(n, sizeof(unsigned int));
+    unsigned int * wmarque = allouer_zero(n, sizeof(unsigned int));
+    unsigned int * w = allouer(n, sizeof(unsigned int));
+    unsigned char * etat = allouer_zero(n, 1);
+    liste * adjv = allouer_zero(n, sizeof(liste)), * adje = allouer_zero(n, sizeof(liste));
+    liste * le = allouer_zero(n, sizeof(liste));
+    paquets pq;
+    unsigned int i, j, k, p, e, v, q, d, ext, nouv, mindeg = 0, tag = 0, restant;
+
+    pq.tete = allouer(n, sizeof(unsigned int));
+    pq.suiv = allouer(n, sizeof(unsigned int));
+    pq.prec = allouer(n, sizeof(unsigned int));
+    pq.deg = allouer(n, sizeof(unsigned int));
+    for (i = 0; i < n; i++) pq.tete[i] = AUCUN;
+
+    for (i = 0; i < n; i++) {
+        adjv[i].n = adjv[i].cap = ptr[i + 1] - ptr[i];
+        adjv[i].d = allouer(adjv[i].n, sizeof(unsigned int));
+        memcpy(adjv[i].d, col + ptr[i], adjv[i].n * sizeof(unsigned int));
+        inserer(&pq, i, adjv[i].n);
+    }
+
+    for (k = 0; k < n; k++) {
+        while (pq.tete[mindeg] == AUCUN) mindeg++;
+        p = pq.tete[mindeg];
+        retirer(&pq, p);
+        perm[k] = p;
+        etat[p] = ELEMENT;
+        tag++;
+        marque[p] = tag;
+
+        // Lp : voisins de p, directs ou par ses éléments, qui sont absorbés
+        for (j = 0; j < adjv[p].n; j++) {
+            v = adjv[p].d[j];
+            if (etat[v] == VARIABLE && marque[v] != tag) {
+                marque[v] = tag;
+                ajouter(&le[p], v);
+            }
+        }
+        for (j = 0; j < adje[p].n; j++) {
+            e = adje[p].d[j];
+            if (etat[e] != ELEMENT || e == p) continue;
+            for (q = 0; q < le[e].n; q++) {
+                v = le[e].d[q];
+                if (etat[v] == VARIABLE && marque[v] != tag) {
+                    marque[v] = tag;
+                    ajouter(&le[p], v);
+                }
+            }
+            etat[e] = ABSORBE;
+            vider(&le[e]);
+        }
+        vider(&adjv[p]);
+        vider(&adje[p]);
+
+        // w[e] = |Le \ Lp| pour les éléments voisins de Lp
+        for (j = 0; j < le[p].n; j++) {
+            i = le[p].d[j];
+            retirer(&pq, i);
+            for (q = 0; q < adje[i].n; q++) {
+                e = adje[i].d[q];
+                if (etat[e] != ELEMENT || e == p) continue;
+                if (wmarque[e] != tag) {
+                    wmarque[e] = tag;
+                    // on en profite pour retirer les variables éliminées
+                    for (d = nouv = 0; d < le[e].n; d++) {
+                        if (etat[le[e].d[d]] == VARIABLE) le[e].d[nouv++] = le[e].d[d];
+                    }
+                    le[e].n = nouv;
+                    w[e] = nouv;
+                }
+                w[e]--;
+            }
+        }
+
+        // mise à jour des listes et des degrés des variables de Lp
+        restant = n - k - 1;
+        for (j = 0; j < le[p].n; j++) {
+            i = le[p].d[j];
+            ext = 0;
+            for (q = nouv = 0; q < adje[i].n; q++) {
+                e = adje[i].d[q];
+                if (etat[e] != ELEMENT || e == p) continue;
+                if (w[e] == 0) {
+                    etat[e] = ABSORBE;
+                    vider(&le[e]);
+                } else {
+                    adje[i].d[nouv++] = e;
+                    ext += w[e];
+                }
+            }
+            adje[i].n = nouv;
+            ajouter(&adje[i], p);
+
+            for (q = nouv = 0; q < adjv[i].n; q++) {
+                v = adjv[i].d[q];
+                if (etat[v] == VARIABLE && marque[v] != tag) adjv[i].d[nouv++] = v;
+            }
+            adjv[i].n = nouv;
+
+            d = adjv[i].n + le[p].n - 1 + ext;
+            if (d > restant - 1) d = restant - 1;
+            inserer(&pq, i, d);
+            if (d < mindeg) mindeg = d;
+        }
+    }
+
+    for (i = 0; i < n; i++) {
+        vider(&adjv[i]);
+        vider(&adje[i]);
+        vider(&le[i]);
+    }
+    free(adjv);
+    free(adje);
+    free(le);
+    free(etat);
+    free(marque);
+    free(wmarque);
+    free(w);
+    free(pq.tete);
+    free(pq.suiv);
+    free(pq.prec);
+    free(pq.deg);
+
+    return perm;
+}
+
+
+// ---------------------------------------------------------------------
+// Analyse symbolique
+// ---------------------------------------------------------------------
+
+// Motif de A + A^T sans la diagonale, lignes triées et sans doublons
+static void motif_symetrique(Sparse a, size_t ** sptr, unsigned int ** scol) {
+    unsigned int i, j, n = a->nb_rows;
+    size_t q, r, * ptr = allouer_zero((size_t) n + 1, sizeof(size_t)), * pos;
+    unsigned int * col;
+
+
+    for (i = 0; i < n; i++) {
+        for (q = a->row_ptr[i]; q < a->row_ptr[i + 1]; q++) {
+            if (a->col[q] == i) continue;
+            ptr[i + 1]++;
+            ptr[a->col[q] + 1]++;
+        }
+    }
+    for (i = 0; i < n; i++) ptr[i + 1] += ptr[i];
+
+    col = allouer(ptr[n], sizeof(unsigned int));
+    pos = allouer((size_t) n + 1, sizeof(size_t));
+    memcpy(pos, ptr, ((size_t) n + 1) * sizeof(size_t));
+    for (i = 0; i < n; i++) {
+        for (q = a->row_ptr[i]; q < a->row_ptr[i + 1]; q++) {
+            j = a->col[q];
+            if (j == i) continue;
+            col[pos[i]++] = j;
+            col[pos[j]++] = i;
+        }
+    }
+
+    // tri et suppression des doublons, en compactant sur place
+    r = 0;
+    for (i = 0; i < n; i++) {
+        size_t debut = ptr[i], fin = ptr[i + 1];
+        qsort(col + debut, fin - debut, sizeof(unsigned int), compare_indices);
+        ptr[i] = r;
+        for (q = debut; q < fin; q++) {
+            if (q == debut || col[q] != col[q - 1]) col[r++] = col[q];
+        }
+    }
+    ptr[n] = r;
+
+    free(pos);
+    *sptr = ptr;
+    *scol = col;
+}
+
+// Signature FNV-1a du motif de A
+static unsigned long signature_motif(Sparse a) {
+    unsigned long h = 2166136261UL;
+    unsigned int i;
+    size_t q;
+
+    for (i = 0; i <= a->nb_rows; i++) h = (h ^ a->row_ptr[i]) * 16777619UL;
+    for (q = 0; q < a->nnz; q++) h = (h ^ a->col[q]) * 16777619UL;
+
+    return h;
+}
+
+void deleteSymboliqueLU(SymboliqueLU s) {
+    if (!s) return;
+    free(s->q);
+    free(s->a_ptr);
+    free(s->a_col);
+    free(s);
+}
+
+// Ordre des colonnes : degré minimum sur le motif de A + A^T, qui limite
+// le remplissage tant que les pivots restent sur la diagonale. Le motif de
+// A est gardé pour reconnaître une matrice de même structure. Retourne
+// NULL si A n'est pas carrée.
+SymboliqueLU analyse_symbolique(Sparse a) {
+    unsigned int n = a->nb_rows, * ccol;
+    size_t * cptr;
+    SymboliqueLU s;
+
+    if (a->nb_rows != a->nb_columns) return NULL;
+
+    s = allouer(1, sizeof(struct symbolique_lu));
+    s->n = n;
+    motif_symetrique(a, &cptr, &ccol);
+    s->q = ordre_degre_minimum(n, cptr, ccol);
+    free(cptr);
+    free(ccol);
+
+    s->nnz_a = a->nnz;
+    s->a_ptr = allouer((size_t) n + 1, sizeof(size_t));
+    s->a_col = allouer(a->nnz, sizeof(unsigned int));
+    memcpy(s->a_ptr, a->row_ptr, ((size_t) n + 1) * sizeof(size_t));
+    memcpy(s->a_col, a->col, a->nnz * sizeof(unsigned int));
+    s->signature = signature_motif(a);
+
+    return s;
+}
+
+// Vaut 1 si A a le motif analysé par s
+static int meme_motif(SymboliqueLU s, Sparse a, unsigned long signature) {
+    return s->n == a->nb_rows && a->nb_rows == a->nb_columns && s->nnz_a == a->nnz
+        && s->signature == signature
+        && !memcmp(s->a_ptr, a->row_ptr, ((size_t) s->n + 1) * sizeof(size_t))
+        && !memcmp(s->a_col, a->col, a->nnz * sizeof(unsigned int));
+}
+
+
+// ---------------------------------------------------------------------
+// Factorisation numérique
+// ---------------------------------------------------------------------
+
+void deleteSparseLU(SparseLU f) {
+    if (!f) return;
+    free(f->pinv);
+    free(f->l_ptr);
+    free(f->l_ind);
+    free(f->l_val);
+    free(f->u_ptr);
+    free(f->u_ind);
+    free(f->u_val);
+    free(f);
+}
+
+// Agrandit L ou U pour qu'ils puissent recevoir au moins min coefficients
+static void agrandir(unsigned int ** ind, double ** val, size_t * cap, size_t min) {
+    if (min <= *cap) return;
+    *cap = 2 * *cap > min ? 2 * *cap : min;
+    *ind = reallouer(*ind, *cap, sizeof(unsigned int));
+    *val = reallouer(*val, *cap, sizeof(double));
+}
+
+// Coefficient de U, pour trier les colonnes
+typedef struct {
+    unsigned int ind;
+    double val;
+} paire;
+
+static int compare_paires(const void * x, const void * y) {
+    return compare_indices(&((const paire *) x)->ind, &((const paire *) y)->ind);
+}
+
+// Parcours en profondeur depuis la ligne j dans le graphe de L (la ligne
+// i mène aux lignes de la colonne pinv[i] de L) ; les lignes atteintes
+// sont rangées dans xi[top - 1], xi[top - 2], ... en ordre topologique.
+// xi[0 .. ] sert aussi de pile, pile[] mémorise la reprise de chaque nœud.
+static unsigned int profondeur(SparseLU f, unsigned int j, unsigned int top, unsigned int * xi,
+                               size_t * pile, unsigned int * marque, unsigned int tag) {
+    long tete = 0;
+    unsigned int i, jj;
+    size_t q, fin;
+    int fini;
+
+    xi[0] = j;
+    while (tete >= 0) {
+        j = xi[tete];
+        jj = f->pinv[j];
+        if (marque[j] != tag) {
+            marque[j] = tag;
+            pile[tete] = jj == AUCUN ? 0 : f->l_ptr[jj] + 1;    // la diagonale est en tête
+        }
+        fini = 1;
+        fin = jj == AUCUN ? 0 : f->l_ptr[jj + 1];
+        for (q = pile[tete]; q < fin; q++) {
+            i = f->l_ind[q];
+            if (marque[i] == tag) continue;
+            pile[tete] = q + 1;
+            xi[++tete] = i;
+            fini = 0;
+            break;
+        }
+        if (fini) {
+            tete--;
+            xi[--top] = j;
+        }
+    }
+
+    return top;
+}
+
+// Factorisation P A Q = L U à gauche (Gilbert-Peierls) : la colonne k est
+// obtenue en résolvant L x = A(:, q[k]), dont le motif est l'ensemble des
+// lignes atteignables depuis celui de la colonne dans le graphe de L.
+// Pivotage partiel à seuil : le coefficient diagonal est préféré s'il vaut
+// au moins SPARSE_LU_SEUIL_PIVOT fois le plus grand candidat, ce qui
+// respecte l'ordre de degré minimum. Retourne NULL si A est singulière.
+SparseLU factorisation_numerique(SymboliqueLU s, Sparse a) {
+    unsigned int i, j, k, col, top, ipiv, n = s->n, * xi, * marque;
+    size_t q, t, lcap, ucap, lnz = 0, unz = 0, * pile;
+    double * x, amax, pivot;
+    paire * paires;
+    Sparse at;
+    SparseLU f;
+
+    if (a->nb_rows != n || a->nb_columns != n) return NULL;
+
+    at = sparse_transpose(a);       // colonnes de A
+    f = allouer(1, sizeof(struct sparse_lu));
+    f->s = s;
+    f->pinv = allouer(n, sizeof(unsigned int));
+    f->l_ptr = allouer((size_t) n + 1, sizeof(size_t));
+    f->u_ptr = allouer((size_t) n + 1, sizeof(size_t));
+    lcap = ucap = 4 * a->nnz + n;
+    f->l_ind = allouer(lcap, sizeof(unsigned int));
+    f->l_val = allouer(lcap, sizeof(double));
+    f->u_ind = allouer(ucap, sizeof(unsigned int));
+    f->u_val = allouer(ucap, sizeof(double));
+    for (i = 0; i < n; i++) f->pinv[i] = AUCUN;
+
+    x = allouer_zero(n, sizeof(double));
+    xi = allouer(n, sizeof(unsigned int));
+    pile = allouer(n, sizeof(size_t));
+    marque = allouer_zero(n, sizeof(unsigned int));
+
+    for (k = 0; k < n; k++) {
+        f->l_ptr[k] = lnz;
+        f->u_ptr[k] = unz;
+        agrandir(&f->l_ind, &f->l_val, &lcap, lnz + n);
+        agrandir(&f->u_ind, &f->u_val, &ucap, unz + n);
+        col = s->q[k];
+
+        // motif de x = L \ A(:, col), puis résolution creuse
+        top = n;
+        for (q = at->row_ptr[col]; q < at->row_ptr[col + 1]; q++) {
+            if (marque[at->col[q]] != k + 1) top = profondeur(f, at->col[q], top, xi, pile, marque, k + 1);
+        }
+        for (q = top; q < n; q++) x[xi[q]] = 0;
+        for (q = at->row_ptr[col]; q < at->row_ptr[col + 1]; q++) x[at->col[q]] = at->val[q];
+        for (q = top; q < n; q++) {
+            j = xi[q];
+            if (f->pinv[j] == AUCUN || x[j] == 0) continue;
+            for (t = f->l_ptr[f->pinv[j]] + 1; t < f->l_ptr[f->pinv[j] + 1]; t++) {
+                x[f->l_ind[t]] -= f->l_val[t] * x[j];
+            }
+        }
+
+        // lignes déjà pivots : colonne k de U ; les autres sont candidates
+        ipiv = AUCUN;
+        amax = -1;
+        for (q = top; q < n; q++) {
+            i = xi[q];
+            if (f->pinv[i] == AUCUN) {
+                if (fabs(x[i]) > amax) {
+                    amax = fabs(x[i]);
+                    ipiv = i;
+                }
+            } else {
+                f->u_ind[unz] = f->pinv[i];
+                f->u_val[unz++] = x[i];
+            }
+        }
+        if (ipiv == AUCUN || amax <= 0) {
+            free(x);
+            free(xi);
+            free(pile);
+            free(marque);
+            deleteSparse(at);
+            deleteSparseLU(f);
+            return NULL;
+        }
+        if (f->pinv[col] == AUCUN && fabs(x[col]) >= SPARSE_LU_SEUIL_PIVOT * amax) ipiv = col;
+
+        pivot = x[ipiv];
+        f->u_ind[unz] = k;
+        f->u_val[unz++] = pivot;
+        f->pinv[ipiv] = k;
+        f->l_ind[lnz] = ipiv;
+        f->l_val[lnz++] = 1;
+        for (q = top; q < n; q++) {
+            i = xi[q];
+            if (f->pinv[i] == AUCUN) {
+                f->l_ind[lnz] = i;
+                f->l_val[lnz++] = x[i] / pivot;
+            }
+            x[i] = 0;
+        }
+    }
+    f->l_ptr[n] = lnz;
+    f->u_ptr[n] = unz;
+
+    // lignes de L dans l'ordre des pivots, colonnes de U triées (pivot en
+    // dernier) pour que la refactorisation les parcoure dans l'ordre
+    for (q = 0; q < lnz; q++) f->l_ind[q] = f->pinv[f->l_ind[q]];
+    paires = allouer(n, sizeof(paire));
+    for (k = 0; k < n; k++) {
+        size_t debut = f->u_ptr[k], nb = f->u_ptr[k + 1] - 1 - debut;
+        for (q = 0; q < nb; q++) {
+            paires[q].ind = f->u_ind[debut + q];
+            paires[q].val = f->u_val[debut + q];
+        }
+        qsort(paires, nb, sizeof(paire), compare_paires);
+        for (q = 0; q < nb; q++) {
+            f->u_ind[debut + q] = paires[q].ind;
+            f->u_val[debut + q] = paires[q].val;
+        }
+    }
+    free(paires);
+
+    free(x);
+    free(xi);
+    free(pile);
+    free(marque);
+    deleteSparse(at);
+
+    return f;
+}
+
+// Refait la factorisation numérique pour une matrice A de même motif, avec
+// les mêmes pivots et les mêmes motifs de L et U (aucun parcours de graphe).
+// Retourne 0 si un pivot ne respecte plus le seuil : il faut alors
+// refactoriser avec pivotage.
+int refactorisation_numerique(SparseLU f, Sparse a) {
+    SymboliqueLU s = f->s;
+    unsigned int i, k, n = s->n;
+    size_t q, t, fin;
+    double * x, ujk, pivot, amax;
+    Sparse at;
+    int ok = 1;
+
+    if (a->nb_rows != n || a->nb_columns != n) return 0;
+
+    at = sparse_transpose(a);
+    x = allouer(n, sizeof(double));
+
+    for (k = 0; k < n && ok; k++) {
+        fin = f->u_ptr[k + 1] - 1;
+        for (q = f->u_ptr[k]; q <= fin; q++) x[f->u_ind[q]] = 0;
+        for (q = f->l_ptr[k]; q < f->l_ptr[k + 1]; q++) x[f->l_ind[q]] = 0;
+        for (q = at->row_ptr[s->q[k]]; q < at->row_ptr[s->q[k] + 1]; q++) {
+            x[f->pinv[at->col[q]]] = at->val[q];
+        }
+
+        for (q = f->u_ptr[k]; q < fin; q++) {
+            i = f->u_ind[q];
+            ujk = f->u_val[q] = x[i];
+            if (ujk == 0) continue;
+            for (t = f->l_ptr[i] + 1; t < f->l_ptr[i + 1]; t++) x[f->l_ind[t]] -= f->l_val[t] * ujk;
+        }
+
+        pivot = x[k];
+        amax = 0;
+        for (q = f->l_ptr[k] + 1; q < f->l_ptr[k + 1]; q++) {
+            if (fabs(x[f->l_ind[q]]) > amax) amax = fabs(x[f->l_ind[q]]);
+        }
+        if (pivot == 0 || fabs(pivot) < SPARSE_LU_SEUIL_PIVOT * amax) {
+            ok = 0;
+            break;
+        }
+
+        f->u_val[fin] = pivot;
+        for (q = f->l_ptr[k] + 1; q < f->l_ptr[k + 1]; q++) f->l_val[q] = x[f->l_ind[q]] / pivot;
+    }
+
+    free(x);
+    deleteSparse(at);
+
+    return ok;
+}
+
+
+// ---------------------------------------------------------------------
+// Résolution
+// ---------------------------------------------------------------------
+
+typedef struct {
+    SparseLU f;
+    Matrix b;
+    Matrix x;
+} args_resolution;
+
+// Colonnes [debut, fin[ de X : L U (Q^T x) = P b
+static void resolution_morceau(void * arg, size_t debut, size_t fin) {
+    args_resolution * r = arg;
+    SparseLU f = r->f;
+    unsigned int i, j, n = f->s->n, nc = r->b->nb_columns;
+    size_t c, q, d;
+    double * y = allouer(n, sizeof(double));
+
+    for (c = debut; c < fin; c++) {
+        for (i = 0; i < n; i++) y[f->pinv[i]] = r->b->mat[(size_t) i * nc + c];
+
+        for (j = 0; j < n; j++) {
+            if (y[j] == 0) continue;
+            for (q = f->l_ptr[j] + 1; q < f->l_ptr[j + 1]; q++) y[f->l_ind[q]] -= f->l_val[q] * y[j];
+        }
+        for (j = n; j-- > 0; ) {
+            d = f->u_ptr[j + 1] - 1;
+            y[j] /= f->u_val[d];
+            if (y[j] == 0) continue;
+            for (q = f->u_ptr[j]; q < d; q++) y[f->u_ind[q]] -= f->u_val[q] * y[j];
+        }
+
+        for (j = 0; j < n; j++) r->x->mat[(size_t) f->s->q[j] * nc + c] = y[j];
+    }
+
+    free(y);
+}
+
+// X tel que A X = B à partir de la factorisation f de A, les colonnes de B
+// étant réparties sur le pool. Retourne NULL si les dimensions ne
+// correspondent pas.
+Matrix resolution_sparse_LU(SparseLU f, Matrix b) {
+    args_resolution r;
+
+    if (b->nb_rows != f->s->n) return NULL;
+
+    r.f = f;
+    r.b = b;
+    r.x = newMatrix(b->nb_rows, b->nb_columns);
+    parallel_for(0, b->nb_columns, 1, resolution_morceau, &r);
+
+    return r.x;
+}
+
+// Analyses symboliques récentes, avec la dernière factorisation obtenue
+// pour chacune (NULL si la matrice était singulière)
+static struct {
+    SymboliqueLU s;
+    SparseLU f;
+} cache[SPARSE_LU_CACHE];
+static unsigned int cache_suivant = 0;
+
+// Résolution directe de A X = B pour A creuse carrée. Si une matrice de
+// même motif a déjà été factorisée, seule la phase numérique est refaite,
+// en gardant ses pivots tant qu'ils restent acceptables. Retourne NULL si
+// les dimensions ne conviennent pas ou si A est singulière.
+Matrix resolution_creuse(Sparse a, Matrix b) {
+    unsigned long signature;
+    unsigned int i;
+
+    if (a->nb_rows != a->nb_columns || b->nb_rows != a->nb_rows) return NULL;
+
+    signature = signature_motif(a);
+    for (i = 0; i < SPARSE_LU_CACHE; i++) {
+        if (cache[i].s && meme_motif(cache[i].s, a, signature)) break;
+    }
+
+    if (i < SPARSE_LU_CACHE) {
+        if (!cache[i].f || !refactorisation_numerique(cache[i].f, a)) {
+            deleteSparseLU(cache[i].f);
+            cache[i].f = factorisation_numerique(cache[i].s, a);
+        }
+    } else {
+        i = cache_suivant;
+        cache_suivant = (cache_suivant + 1) % SPARSE_LU_CACHE;
+        deleteSparseLU(cache[i].f);
+        deleteSymboliqueLU(cache[i].s);
+        cache[i].s = analyse_symbolique(a);
+        cache[i].f = factorisation_numerique(cache[i].s, a);
+    }
+
+    return cache[i].f ? resolution_sparse_LU(cache[i].f, b) : NULL;
+}
+
+// Libère les analyses et factorisations gardées en cache
+void sparse_lu_vider_cache(void) {
+    unsigned int i;
+
+    for (i = 0; i < SPARSE_LU_CACHE; i++) {
+        deleteSparseLU(cache[i].f);
+        deleteSymboliqueLU(cache[i].s);
+        cache[i].f = NULL;
+        cache[i].s = NULL;
+    }
+    cache_suivant = 0;
+}
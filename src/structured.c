@@ -0,0 +1,684 @@
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "system.h"
+#include "matrix.h"
+#include "sparse.h"
+#include "threadpool.h"
+#include "structured.h"
+
+static unsigned int largeur(Structured s) {
+    return s->kl + s->ku + 1;
+}
+
+// Première et dernière colonnes de la bande de la ligne i
+static unsigned int debut_ligne(unsigned int i, unsigned int kl) {
+    return i > kl ? i - kl : 0;
+}
+
+static unsigned int fin_ligne(unsigned int i, unsigned int ku, unsigned int n) {
+    return n - 1 - i > ku ? i + ku : n - 1;
+}
+
+// Adresse du coefficient (i, j), qui doit être dans la bande
+static E * coefficient(Structured s, unsigned int i, unsigned int j) {
+    return s->val + (size_t) i * largeur(s) + j + s->kl - i;
+}
+
+Structured newStructured(unsigned int n, unsigned int kl, unsigned int ku) {
+    Structured s = allouer(1, sizeof(struct structured));
+    s->n = n;
+    s->kl = kl;
+    s->ku = ku;
+    s->val = allouer((size_t) n * (kl + ku + 1), sizeof(E));
+    memset(s->val, 0, (size_t) n * (kl + ku + 1) * sizeof(E));
+    return s;
+}
+
+void deleteStructured(Structured s) {
+    if (!s) return;
+    free(s->val);
+    free(s);
+}
+
+Structured new_structured_copy(Structured s) {
+    Structured r = newStructured(s->n, s->kl, s->ku);
+    memcpy(r->val, s->val, (size_t) s->n * largeur(s) * sizeof(E));
+    return r;
+}
+
+forme structured_forme(Structured s) {
+    if (s->kl == 0 && s->ku == 0) return STRUCT_DIAGONALE;
+    if (s->kl == 0) return STRUCT_TRIANGULAIRE_SUP;
+    if (s->ku == 0) return STRUCT_TRIANGULAIRE_INF;
+    if (s->kl == 1 && s->ku == 1) return STRUCT_TRIDIAGONALE;
+    return STRUCT_BANDE;
+}
+
+// Vaut 1 si une matrice n x n de largeurs de bande kl, ku avec nnz
+// coefficients non nuls gagne à être stockée en bande
+int structured_preferable(unsigned int n, unsigned int kl, unsigned int ku, size_t nnz) {
+    double bande = (double) (kl + ku + 1) * n, taille = (double) n * n;
+
+    if (taille < SPARSE_TAILLE_MIN) return 0;
+    if (kl && ku && bande > STRUCT_DENSITE_MAX * taille) return 0;
+    // triangle plein : le stockage compact (packed.h) en prend la moitié
+    if (bande > (double) n * (n + 1) / 2) return 0;
+    // bande plus qu'à moitié vide : le stockage CSR est plus compact
+    if (sparse_preferable(n, n, nnz) && bande > 2.0 * nnz) return 0;
+    return 1;
+}
+
+// Largeurs de bande d'une matrice dense carrée
+void largeurs_bande(Matrix m, unsigned int * kl, unsigned int * ku) {
+    unsigned int i, j, n = m->nb_rows;
+    const E * ligne;
+
+    *kl = *ku = 0;
+    for (i = 0; i < n; i++) {
+        ligne = m->mat + (size_t) i * n;
+        for (j = 0; j + *kl < i; j++) {
+            if (ligne[j] != 0) {
+                *kl = i - j;
+                break;
+            }
+        }
+        for (j = n; j-- > i + *ku; ) {
+            if (ligne[j] != 0) {
+                *ku = j - i;
+                break;
+            }
+        }
+    }
+}
+
+E structured_get(Structured s, unsigned int i, unsigned int j) {
+    if (i > j + s->kl || j > i + s->ku) return 0;
+    return *coefficient(s, i, j);
+}
+
+// Garde la bande -kl <= j - i <= ku de m (carrée)
+Structured dense_to_structured(Matrix m, unsigned int kl, unsigned int ku) {
+    unsigned int i, j, n = m->nb_rows;
+    Structured s = newStructured(n, kl, ku);
+
+    for (i = 0; i < n; i++) {
+        for (j = debut_ligne(i, kl); n && j <= fin_ligne(i, ku, n); j++) {
+            *coefficient(s, i, j) = m->mat[(size_t) i * n + j];
+        }
+    }
+
+    return s;
+}
+
+Matrix structured_to_dense(Structured s) {
+    unsigned int i, j, n = s->n;
+    Matrix m = newMatrix(n, n);
+
+    for (i = 0; i < n; i++) {
+        for (j = debut_ligne(i, s->kl); j <= fin_ligne(i, s->ku, n); j++) {
+            m->mat[(size_t) i * n + j] = *coefficient(s, i, j);
+        }
+    }
+
+    return m;
+}
+
+// Coefficients non nuls de la bande, au format CSR
+Sparse structured_to_sparse(Structured s) {
+    unsigned int i, j, n = s->n;
+    size_t nnz = 0, p = 0, k;
+    Sparse r;
+
+    for (k = 0; k < (size_t) n * largeur(s); k++) nnz += s->val[k] != 0;
+
+    r = newSparse(n, n, nnz);
+    for (i = 0; i < n; i++) {
+        for (j = debut_ligne(i, s->kl); j <= fin_ligne(i, s->ku, n); j++) {
+            if (*coefficient(s, i, j) != 0) {
+                r->col[p] = j;
+                r->val[p++] = *coefficient(s, i, j);
+            }
+        }
+        r->row_ptr[i + 1] = p;
+    }
+
+    return r;
+}
+
+// Les petites matrices sont affichées comme les matrices denses, les
+// grandes par leur forme et leurs dimensions
+void printStructured(Structured s) {
+    Matrix m;
+
+    if (!s) {
+        print_error("No matrix to print");
+        return;
+    }
+
+    if ((size_t) s->n * s->n <= AFFICHAGE_MAX) {
+        m = structured_to_dense(s);
+        printMatrix(m);
+        deleteMatrix(m);
+        return;
+    }
+
+    switch (structured_forme(s)) {
+        case STRUCT_DIAGONALE:
+            printf("Matrice diagonale %u x %u\n", s->n, s->n);
+            break;
+        case STRUCT_TRIDIAGONALE:
+            printf("Matrice tridiagonale %u x %u\n", s->n, s->n);
+            break;
+        case STRUCT_TRIANGULAIRE_INF:
+            printf("Matrice triangulaire inférieure %u x %u, %u sous-diagonales\n", s->n, s->n, s->kl);
+            break;
+        case STRUCT_TRIANGULAIRE_SUP:
+            printf("Matrice triangulaire supérieure %u x %u, %u sur-diagonales\n", s->n, s->n, s->ku);
+            break;
+        case STRUCT_BANDE:
+            printf("Matrice bande %u x %u, %u sous-diagonales et %u sur-diagonales\n",
+                   s->n, s->n, s->kl, s->ku);
+            break;
+    }
+}
+
+Structured structured_transpose(Structured s) {
+    unsigned int i, j, n = s->n;
+    Structured t = newStructured(n, s->ku, s->kl);
+
+    for (i = 0; i < n; i++) {
+        for (j = debut_ligne(i, s->kl); j <= fin_ligne(i, s->ku, n); j++) {
+            *coefficient(t, j, i) = *coefficient(s, i, j);
+        }
+    }
+
+    return t;
+}
+
+Structured structured_mult_scalar(E k, Structured s) {
+    Structured r = new_structured_copy(s);
+    size_t i, nb = (size_t) s->n * largeur(s);
+
+    for (i = 0; i < nb; i++) r->val[i] *= k;
+
+    return r;
+}
+
+
+// ---------------------------------------------------------------------
+// Produits et sommes
+// ---------------------------------------------------------------------
+
+typedef struct {
+    Structured s;
+    Structured t;
+    Structured r;
+    Matrix b;
+    Matrix c;
+} args_structured;
+
+// Lignes [debut, fin[ de C = S B
+static void mult_dense_morceau(void * arg, size_t debut, size_t fin) {
+    args_structured * a = arg;
+    Structured s = a->s;
+    unsigned int j, k, p = a->b->nb_columns;
+    size_t i;
+    E sij, * ci;
+    const E * bj;
+
+    for (i = debut; i < fin; i++) {
+        ci = a->c->mat + i * p;
+        for (j = debut_ligne(i, s->kl); j <= fin_ligne(i, s->ku, s->n); j++) {
+            sij = *coefficient(s, i, j);
+            if (sij == 0) continue;
+            bj = a->b->mat + (size_t) j * p;
+            for (k = 0; k < p; k++) ci[k] += sij * bj[k];
+        }
+    }
+}
+
+// S B en O(n (kl + ku + 1) p). Retourne NULL si les dimensions ne
+// correspondent pas.
+Matrix structured_mult_dense(Structured s, Matrix b) {
+    args_structured a;
+
+    if (b->nb_rows != s->n) return NULL;
+
+    a.s = s;
+    a.b = b;
+    a.c = newMatrix(s->n, b->nb_columns);
+    parallel_for(0, s->n, PARALLEL_SEUIL / ((size_t) largeur(s) * b->nb_columns + 1) + 1, mult_dense_morceau, &a);
+
+    return a.c;
+}
+
+// Lignes [debut, fin[ de C = B S
+static void dense_mult_morceau(void * arg, size_t debut, size_t fin) {
+    args_structured * a = arg;
+    Structured s = a->s;
+    unsigned int j, k, n = s->n;
+    size_t r;
+    E brk, * cr;
+
+    for (r = debut; r < fin; r++) {
+        cr = a->c->mat + r * n;
+        for (k = 0; k < n; k++) {
+            brk = a->b->mat[r * n + k];
+            if (brk == 0) continue;
+            for (j = debut_ligne(k, s->kl); j <= fin_ligne(k, s->ku, n); j++) cr[j] += brk * *coefficient(s, k, j);
+        }
+    }
+}
+
+// B S en O(m n (kl + ku + 1)). Retourne NULL si les dimensions ne
+// correspondent pas.
+Matrix dense_mult_structured(Matrix b, Structured s) {
+    args_structured a;
+
+    if (b->nb_columns != s->n) return NULL;
+
+    a.s = s;
+    a.b = b;
+    a.c = newMatrix(b->nb_rows, s->n);
+    parallel_for(0, b->nb_rows, PARALLEL_SEUIL / ((size_t) largeur(s) * s->n + 1) + 1, dense_mult_morceau, &a);
+
+    return a.c;
+}
+
+// Lignes [debut, fin[ de C = S T, C ayant déjà ses largeurs de bande
+static void mult_structured_morceau(void * arg, size_t debut, size_t fin) {
+    args_structured * a = arg;
+    Structured s = a->s, t = a->t;
+    Structured c = a->r;
+    unsigned int j, k, n = s->n;
+    size_t i;
+    E sik;
+
+    for (i = debut; i < fin; i++) {
+        for (k = debut_ligne(i, s->kl); k <= fin_ligne(i, s->ku, n); k++) {
+            sik = *coefficient(s, i, k);
+            if (sik == 0) continue;
+            for (j = debut_ligne(k, t->kl); j <= fin_ligne(k, t->ku, n); j++) {
+                *coefficient(c, i, j) += sik * *coefficient(t, k, j);
+            }
+        }
+    }
+}
+
+// S T : les largeurs de bande s'additionnent (le produit de deux
+// diagonales ou de deux triangulaires de même sens garde sa forme).
+// Retourne NULL si les dimensions ne correspondent pas.
+Structured structured_multiplication(Structured s, Structured t) {
+    unsigned int n = s->n, kl, ku;
+    args_structured a;
+    Structured c;
+
+    if (t->n != n) return NULL;
+
+    kl = n && s->kl + t->kl > n - 1 ? n - 1 : s->kl + t->kl;
+    ku = n && s->ku + t->ku > n - 1 ? n - 1 : s->ku + t->ku;
+    c = newStructured(n, kl, ku);
+
+    a.s = s;
+    a.t = t;
+    a.r = c;
+    parallel_for(0, n, PARALLEL_SEUIL / ((size_t) largeur(s) * largeur(t) + 1) + 1, mult_structured_morceau, &a);
+
+    return c;
+}
+
+// S + T, avec les plus grandes largeurs de bande des deux. Retourne NULL
+// si les dimensions ne correspondent pas.
+Structured structured_addition(Structured s, Structured t) {
+    unsigned int i, j, n = s->n;
+    Structured c;
+
+    if (t->n != n) return NULL;
+
+    c = newStructured(n, s->kl > t->kl ? s->kl : t->kl, s->ku > t->ku ? s->ku : t->ku);
+    for (i = 0; i < n; i++) {
+        for (j = debut_ligne(i, s->kl); j <= fin_ligne(i, s->ku, n); j++) *coefficient(c, i, j) += *coefficient(s, i, j);
+        for (j = debut_ligne(i, t->kl); j <= fin_ligne(i, t->ku, n); j++) *coefficient(c, i, j) += *coefficient(t, i, j);
+    }
+
+    return c;
+}
+
+// S + B, dense. Retourne NULL si les dimensions ne correspondent pas.
+Matrix structured_addition_dense(Structured s, Matrix b) {
+    unsigned int i, j, n = s->n;
+    Matrix c;
+
+    if (b->nb_rows != n || b->nb_columns != n) return NULL;
+
+    c = new_matrix_copy(b);
+    for (i = 0; i < n; i++) {
+        for (j = debut_ligne(i, s->kl); j <= fin_ligne(i, s->ku, n); j++) {
+            c->mat[(size_t) i * n + j] += *coefficient(s, i, j);
+        }
+    }
+
+    return c;
+}
+
+
+// ---------------------------------------------------------------------
+// Factorisation LU bande
+// ---------------------------------------------------------------------
+
+// Factorisation P S = L U avec pivot partiel, au format bande de LAPACK
+// (colonne j : ab[j * ldab + kv + i - j] = A(i, j), kv = kl + ku) : les
+// échanges de lignes élargissent U de kl sur-diagonales
+typedef struct {
+    unsigned int n;
+    unsigned int kl;
+    unsigned int kv;
+    unsigned int ldab;
+    double * ab;
+    unsigned int * piv;
+    int signe;
+    int singuliere;
+} lu_bande;
+
+static double * element_lu(lu_bande * f, unsigned int i, unsigned int j) {
+    return f->ab + (size_t) j * f->ldab + f->kv + i - j;
+}
+
+static lu_bande factoriser_bande(Structured s) {
+    unsigned int i, j, c, t, km, jp, ju = 0, n = s->n;
+    double pivot, v, * colonne;
+    lu_bande f;
+
+    f.n = n;
+    f.kl = s->kl;
+    f.kv = s->kl + s->ku;
+    f.ldab = 2 * s->kl + s->ku + 1;
+    f.ab = allouer((size_t) n * f.ldab, sizeof(double));
+    memset(f.ab, 0, (size_t) n * f.ldab * sizeof(double));
+    f.piv = allouer(n, sizeof(unsigned int));
+    f.signe = 1;
+    f.singuliere = 0;
+
+    for (i = 0; i < n; i++) {
+        for (j = debut_ligne(i, s->kl); j <= fin_ligne(i, s->ku, n); j++) *element_lu(&f, i, j) = *coefficient(s, i, j);
+    }
+
+    for (j = 0; j < n; j++) {
+        km = n - 1 - j < f.kl ? n - 1 - j : f.kl;
+        colonne = element_lu(&f, j, j);
+
+        jp = 0;
+        for (t = 1; t <= km; t++) if (fabs(colonne[t]) > fabs(colonne[jp])) jp = t;
+        f.piv[j] = j + jp;
+        if (colonne[jp] == 0) {
+            f.singuliere = 1;
+            continue;
+        }
+
+        if (j + s->ku + jp > ju) ju = j + s->ku + jp < n - 1 ? j + s->ku + jp : n - 1;
+        if (jp) {
+            f.signe = -f.signe;
+            for (c = j; c <= ju; c++) {
+                v = *element_lu(&f, j, c);
+                *element_lu(&f, j, c) = *element_lu(&f, j + jp, c);
+                *element_lu(&f, j + jp, c) = v;
+            }
+        }
+
+        pivot = colonne[0];
+        for (t = 1; t <= km; t++) colonne[t] /= pivot;
+        for (c = j + 1; c <= ju; c++) {
+            double * cc = element_lu(&f, j, c);
+            if (cc[0] == 0) continue;
+            for (t = 1; t <= km; t++) cc[t] -= colonne[t] * cc[0];
+        }
+    }
+
+    return f;
+}
+
+static void liberer_lu_bande(lu_bande * f) {
+    free(f->ab);
+    free(f->piv);
+}
+
+typedef struct {
+    lu_bande * f;
+    double * x;
+    size_t p;
+} args_lu_bande;
+
+// Colonnes [debut, fin[ de X = (P^T L U)^-1 X, X étant rangée par lignes
+static void resoudre_bande_morceau(void * arg, size_t debut, size_t fin) {
+    args_lu_bande * a = arg;
+    lu_bande * f = a->f;
+    unsigned int i, j, t, km, n = f->n;
+    size_t c, p = a->p;
+    double l, * xj, * xi, v;
+
+    for (j = 0; j + 1 < n; j++) {
+        km = n - 1 - j < f->kl ? n - 1 - j : f->kl;
+        xj = a->x + (size_t) j * p;
+        if (f->piv[j] != j) {
+            xi = a->x + (size_t) f->piv[j] * p;
+            for (c = debut; c < fin; c++) {
+                v = xi[c];
+                xi[c] = xj[c];
+                xj[c] = v;
+            }
+        }
+        for (t = 1; t <= km; t++) {
+            l = *element_lu(f, j + t, j);
+            if (l == 0) continue;
+            xi = a->x + (size_t) (j + t) * p;
+            for (c = debut; c < fin; c++) xi[c] -= l * xj[c];
+        }
+    }
+
+    for (j = n; j-- > 0; ) {
+        xj = a->x + (size_t) j * p;
+        v = *element_lu(f, j, j);
+        for (c = debut; c < fin; c++) xj[c] /= v;
+        for (i = j > f->kv ? j - f->kv : 0; i < j; i++) {
+            l = *element_lu(f, i, j);
+            if (l == 0) continue;
+            xi = a->x + (size_t) i * p;
+            for (c = debut; c < fin; c++) xi[c] -= l * xj[c];
+        }
+    }
+}
+
+
+// ---------------------------------------------------------------------
+// Déterminant et résolution
+// ---------------------------------------------------------------------
+
+// Déterminant en O(n) pour les formes diagonale, triangulaires et
+// tridiagonale (récurrence f_i = d_i f_(i-1) - a_i c_(i-1) f_(i-2)), en
+// O(n kl (kl + ku)) par LU bande sinon
+E structured_det(Structured s) {
+    unsigned int i, n = s->n;
+    double d = 1, f0 = 1, f1, f2;
+    lu_bande f;
+
+    if (n == 0) return 0;
+
+    switch (structured_forme(s)) {
+        case STRUCT_DIAGONALE:
+        case STRUCT_TRIANGULAIRE_INF:
+        case STRUCT_TRIANGULAIRE_SUP:
+            for (i = 0; i < n; i++) d *= *coefficient(s, i, i);
+            return d;
+
+        case STRUCT_TRIDIAGONALE:
+            f1 = *coefficient(s, 0, 0);
+            for (i = 1; i < n; i++) {
+                f2 = *coefficient(s, i, i) * f1 - (double) *coefficient(s, i, i - 1) * *coefficient(s, i - 1, i) * f0;
+                f0 = f1;
+                f1 = f2;
+            }
+            return f1;
+
+        default:
+            f = factoriser_bande(s);
+            if (f.singuliere) d = 0;
+            else {
+                d = f.signe;
+                for (i = 0; i < n; i++) d *= *element_lu(&f, i, i);
+            }
+            liberer_lu_bande(&f);
+            return d;
+    }
+}
+
+typedef struct {
+    Structured s;
+    double * x;
+    size_t p;
+    double * cp;        // Thomas : c'_i
+    double * m;         // Thomas : dénominateurs
+} args_resolution;
+
+// Colonnes [debut, fin[ de la substitution triangulaire, X rangée par lignes
+static void triangulaire_morceau(void * arg, size_t debut, size_t fin) {
+    args_resolution * a = arg;
+    Structured s = a->s;
+    unsigned int i, j, n = s->n;
+    size_t c, p = a->p;
+    double sij, * xi, * xj;
+
+    if (structured_forme(s) != STRUCT_TRIANGULAIRE_SUP) {
+        for (i = 0; i < n; i++) {
+            xi = a->x + (size_t) i * p;
+            for (j = debut_ligne(i, s->kl); j < i; j++) {
+                sij = *coefficient(s, i, j);
+                if (sij == 0) continue;
+                xj = a->x + (size_t) j * p;
+                for (c = debut; c < fin; c++) xi[c] -= sij * xj[c];
+            }
+            sij = *coefficient(s, i, i);
+            for (c = debut; c < fin; c++) xi[c] /= sij;
+        }
+    } else {
+        for (i = n; i-- > 0; ) {
+            xi = a->x + (size_t) i * p;
+            for (j = i + 1; j <= fin_ligne(i, s->ku, n); j++) {
+                sij = *coefficient(s, i, j);
+                if (sij == 0) continue;
+                xj = a->x + (size_t) j * p;
+                for (c = debut; c < fin; c++) xi[c] -= sij * xj[c];
+            }
+            sij = *coefficient(s, i, i);
+            for (c = debut; c < fin; c++) xi[c] /= sij;
+        }
+    }
+}
+
+// Colonnes [debut, fin[ de l'algorithme de Thomas, les c'_i et les
+// dénominateurs étant déjà calculés
+static void thomas_morceau(void * arg, size_t debut, size_t fin) {
+    args_resolution * a = arg;
+    Structured s = a->s;
+    unsigned int i, n = s->n;
+    size_t c, p = a->p;
+    double ai, * xi, * xp;
+
+    for (c = debut; c < fin; c++) a->x[c] /= a->m[0];
+    for (i = 1; i < n; i++) {
+        ai = *coefficient(s, i, i - 1);
+        xi = a->x + (size_t) i * p;
+        xp = xi - p;
+        for (c = debut; c < fin; c++) xi[c] = (xi[c] - ai * xp[c]) / a->m[i];
+    }
+    for (i = n - 1; i-- > 0; ) {
+        xi = a->x + (size_t) i * p;
+        xp = xi + p;
+        for (c = debut; c < fin; c++) xi[c] -= a->cp[i] * xp[c];
+    }
+}
+
+// Prépare l'algorithme de Thomas (élimination sans pivot), réservé aux
+// matrices tridiagonales à diagonale dominante pour lesquelles il est
+// stable. Retourne 0 s'il ne s'applique pas.
+static int preparer_thomas(Structured s, args_resolution * a) {
+    unsigned int i, n = s->n;
+    double b, g, d;
+
+    for (i = 0; i < n; i++) {
+        b = fabs(*coefficient(s, i, i));
+        g = i ? fabs(*coefficient(s, i, i - 1)) : 0;
+        d = i + 1 < n ? fabs(*coefficient(s, i, i + 1)) : 0;
+        if (b < g + d) return 0;
+    }
+
+    a->cp = allouer(n, sizeof(double));
+    a->m = allouer(n, sizeof(double));
+    for (i = 0; i < n; i++) {
+        a->m[i] = *coefficient(s, i, i) - (i ? *coefficient(s, i, i - 1) * a->cp[i - 1] : 0);
+        if (a->m[i] == 0) {
+            free(a->cp);
+            free(a->m);
+            return 0;
+        }
+        a->cp[i] = i + 1 < n ? *coefficient(s, i, i + 1) / a->m[i] : 0;
+    }
+
+    return 1;
+}
+
+// X tel que S X = B : division (diagonale), substitution (triangulaires),
+// algorithme de Thomas (tridiagonale à diagonale dominante) ou LU bande
+// avec pivot partiel, en double, les colonnes de B étant réparties sur le
+// pool. Retourne NULL si les dimensions ne correspondent pas ou si S est
+// singulière.
+Matrix structured_resolution(Structured s, Matrix b) {
+    unsigned int i, n = s->n;
+    size_t k, p = b->nb_columns, grain;
+    forme f = structured_forme(s);
+    args_resolution a;
+    args_lu_bande ab;
+    lu_bande lu;
+    Matrix x;
+
+    if (b->nb_rows != n) return NULL;
+
+    a.s = s;
+    a.p = p;
+    a.x = allouer((size_t) n * p, sizeof(double));
+    for (k = 0; k < (size_t) n * p; k++) a.x[k] = b->mat[k];
+    grain = PARALLEL_SEUIL / ((size_t) n * largeur(s) + 1) + 1;
+
+    if (f == STRUCT_DIAGONALE || f == STRUCT_TRIANGULAIRE_INF || f == STRUCT_TRIANGULAIRE_SUP) {
+        for (i = 0; i < n; i++) {
+            if (*coefficient(s, i, i) == 0) {
+                free(a.x);
+                return NULL;
+            }
+        }
+        parallel_for(0, p, grain, triangulaire_morceau, &a);
+    } else if (f == STRUCT_TRIDIAGONALE && preparer_thomas(s, &a)) {
+        parallel_for(0, p, grain, thomas_morceau, &a);
+        free(a.cp);
+        free(a.m);
+    } else {
+        lu = factoriser_bande(s);
+        if (lu.singuliere) {
+            liberer_lu_bande(&lu);
+            free(a.x);
+            return NULL;
+        }
+        ab.f = &lu;
+        ab.x = a.x;
+        ab.p = p;
+        parallel_for(0, p, grain, resoudre_bande_morceau, &ab);
+        liberer_lu_bande(&lu);
+    }
+
+    x = newMatrix(n, p);
+    for (k = 0; k < (size_t) n * p; k++) x->mat[k] = a.x[k];
+    free(a.x);
+
+    return x;
+}
@@ -0,0 +1,463 @@
+#include <float.h>
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+#include "system.h"
+#include "matrix.h"
+#include "gemm.h"
+#include "threadpool.h"
+#include "qr.h"
+#include "svd.h"
+
+
+// ---------------------------------------------------------------------
+// Jacobi à un côté (Hestenes)
+// ---------------------------------------------------------------------
+
+// Un tour de paires disjointes : la paire i est (haut[i], bas[i])
+typedef struct {
+    double * w;         // n lignes de longueur m (colonnes de la matrice)
+    double * vt;        // n x n (lignes = colonnes de V), ou NULL
+    unsigned int n;
+    unsigned int m;
+    const unsigned int * haut;
+    const unsigned int * bas;
+} args_jacobi;
+
+// Orthogonalise les paires [debut, fin[ du tour ; retourne le nombre de
+// rotations effectuées
+static double jacobi_morceau(void * arg, size_t debut, size_t fin) {
+    args_jacobi * j = arg;
+    unsigned int m = j->m, i, p, q, rotations = 0;
+    double alpha, beta, gamma, zeta, t, c, s, x, y, * wp, * wq;
+    size_t k;
+
+    for (k = debut; k < fin; k++) {
+        p = j->haut[k];
+        q = j->bas[k];
+        if (p >= j->n || q >= j->n) continue;
+        wp = j->w + (size_t) p * m;
+        wq = j->w + (size_t) q * m;
+
+        alpha = beta = gamma = 0;
+        for (i = 0; i < m; i++) {
+            alpha += wp[i] * wp[i];
+            beta += wq[i] * wq[i];
+            gamma += wp[i] * wq[i];
+        }
+        if (gamma == 0 || fabs(gamma) <= m * DBL_EPSILON * sqrt(alpha * beta)) continue;
+
+        // rotation qui rend les colonnes p et q orthogonales
+        zeta = (beta - alpha) / (2 * gamma);
+        t = (zeta >= 0 ? 1 : -1) / (fabs(zeta) + sqrt(1 + zeta * zeta));
+        c = 1 / sqrt(1 + t * t);
+        s = c * t;
+        for (i = 0; i < m; i++) {
+            x = wp[i];
+            y = wq[i];
+            wp[i] = c * x - s * y;
+            wq[i] = s * x + c * y;
+        }
+        if (j->vt) {
+            wp = j->vt + (size_t) p * j->n;
+            wq = j->vt + (size_t) q * j->n;
+            for (i = 0; i < j->n; i++) {
+                x = wp[i];
+                y = wq[i];
+                wp[i] = c * x - s * y;
+                wq[i] = s * x + c * y;
+            }
+        }
+        rotations++;
+    }
+
+    return rotations;
+}
+
+// Balayages de Jacobi sur les n colonnes (rangées en lignes dans w) :
+// chaque tour (ordre du tournoi à la ronde) traite n/2 paires disjointes,
+// réparties sur le pool. S'arrête quand un balayage n'a rien modifié.
+static void jacobi(double * w, unsigned int n, unsigned int m, double * vt) {
+    unsigned int nn = n + (n & 1), demi = nn / 2, i, tour, balayage, dernier;
+    unsigned int * pos = allouer(nn, sizeof(unsigned int));
+    unsigned int * haut = allouer(demi, sizeof(unsigned int)), * bas = allouer(demi, sizeof(unsigned int));
+    args_jacobi j = { w, vt, n, m, haut, bas };
+    double rotations;
+
+    for (i = 0; i < nn; i++) pos[i] = i;
+
+    for (balayage = 0; balayage < JACOBI_MAX_BALAYAGES && n > 1; balayage++) {
+        rotations = 0;
+        for (tour = 0; tour + 1 < nn; tour++) {
+            for (i = 0; i < demi; i++) {
+                haut[i] = pos[i];
+                bas[i] = pos[nn - 1 - i];
+            }
+            rotations += parallel_reduce(0, demi, PARALLEL_SEUIL / (3 * (size_t) m + 1) + 1, jacobi_morceau, &j);
+            // pos[0] reste en place, les autres tournent d'un cran
+            dernier = pos[nn - 1];
+            for (i = nn - 1; i > 1; i--) pos[i] = pos[i - 1];
+            pos[1] = dernier;
+        }
+        if (rotations == 0) break;
+    }
+
+    free(pos);
+    free(haut);
+    free(bas);
+}
+
+static const double * tri_normes;
+
+static int compare_normes(const void * a, const void * b) {
+    double x = tri_normes[*(const unsigned int *) a], y = tri_normes[*(const unsigned int *) b];
+    return x < y ? 1 : x > y ? -1 : 0;
+}
+
+// SVD d'une matrice b (r x n, r >= n) par Jacobi : les valeurs singulières
+// sont les normes des colonnes orthogonalisées
+static SVD svd_jacobi(Matrix b, int vecteurs) {
+    unsigned int r = b->nb_rows, n = b->nb_columns, i, j, c;
+    double * w = allouer((size_t) n * r, sizeof(double)), * vt = NULL, * normes = allouer(n, sizeof(double));
+    unsigned int * ordre = allouer(n, sizeof(unsigned int));
+    SVD f;
+
+
+    for (i = 0; i < r; i++) {
+        for (j = 0; j < n; j++) w[(size_t) j * r + i] = b->mat[(size_t) i * n + j];
+    }
+    if (vecteurs) {
+        vt = allouer((size_t) n * n, sizeof(double));
+        memset(vt, 0, (size_t) n * n * sizeof(double));
+        for (j = 0; j < n; j++) vt[(size_t) j * n + j] = 1;
+    }
+
+    jacobi(w, n, r, vt);
+
+    for (j = 0; j < n; j++) {
+        double s = 0;
+        for (i = 0; i < r; i++) s += w[(size_t) j * r + i] * w[(size_t) j * r + i];
+        normes[j] = sqrt(s);
+        ordre[j] = j;
+    }
+    tri_normes = normes;
+    qsort(ordre, n, sizeof(unsigned int), compare_normes);
+
+    f.s = newMatrix(n, 1);
+    for (c = 0; c < n; c++) f.s->mat[c] = normes[ordre[c]];
+    f.u = f.v = NULL;
+
+    if (vecteurs) {
+        // colonne c de U : colonne orthogonalisée divisée par sa norme
+        // (laissée nulle si la valeur singulière est nulle)
+        f.u = newMatrix(r, n);
+        f.v = newMatrix(n, n);
+        for (c = 0; c < n; c++) {
+            j = ordre[c];
+            for (i = 0; i < r; i++) {
+                f.u->mat[(size_t) i * n + c] = normes[j] == 0 ? 0 : w[(size_t) j * r + i] / normes[j];
+            }
+            for (i = 0; i < n; i++) f.v->mat[(size_t) i * n + c] = vt[(size_t) j * n + i];
+        }
+    }
+
+    free(w);
+    free(vt);
+    free(normes);
+    free(ordre);
+
+    return f;
+}
+
+// Échange les rôles de U et V (SVD de la transposée)
+static SVD svd_transposee(SVD f) {
+    Matrix t = f.u;
+    f.u = f.v;
+    f.v = t;
+    return f;
+}
+
+// Garde les k premières colonnes de m (m est libérée)
+static Matrix premieres_colonnes(Matrix m, unsigned int k) {
+    unsigned int i, n;
+    Matrix r;
+
+    if (!m || k >= m->nb_columns) return m;
+    n = m->nb_columns;
+    r = newMatrix(m->nb_rows, k);
+    for (i = 0; i < m->nb_rows; i++) memcpy(r->mat + (size_t) i * k, m->mat + (size_t) i * n, k * sizeof(E));
+    deleteMatrix(m);
+
+    return r;
+}
+
+// Garde les k premiers triplets singuliers
+static SVD tronquer(SVD f, unsigned int k) {
+    Matrix s;
+
+    if (k < f.s->nb_rows) {
+        s = newMatrix(k, 1);
+        memcpy(s->mat, f.s->mat, k * sizeof(E));
+        deleteMatrix(f.s);
+        f.s = s;
+    }
+    f.u = premieres_colonnes(f.u, k);
+    f.v = premieres_colonnes(f.v, k);
+
+    return f;
+}
+
+
+// Matrice n x m de coefficients gaussiens centrés réduits (Box-Muller sur
+// un générateur congruentiel à graine fixe : les résultats sont
+// reproductibles d'un appel à l'autre)
+static Matrix matrice_gaussienne(unsigned int n, unsigned int m) {
+    unsigned long graine = 12345;
+    double u1, u2, r;
+    size_t i, nb = (size_t) n * m;
+    Matrix g = newMatrix(n, m);
+
+    for (i = 0; i < nb; i += 2) {
+        graine = graine * 6364136223846793005UL + 1442695040888963407UL;
+        u1 = ((graine >> 11) + 1.0) / 9007199254740993.0;
+        graine = graine * 6364136223846793005UL + 1442695040888963407UL;
+        u2 = (graine >> 11) / 9007199254740992.0;
+        r = sqrt(-2 * log(u1));
+        g->mat[i] = r * cos(2 * M_PI * u2);
+        if (i + 1 < nb) g->mat[i + 1] = r * sin(2 * M_PI * u2);
+    }
+
+    return g;
+}
+
+
+// ---------------------------------------------------------------------
+// Interface
+// ---------------------------------------------------------------------
+
+// Décomposition en valeurs singulières réduite (k = min(m, n)) par la
+// méthode de Jacobi à un côté. Les matrices plus hautes que larges sont
+// d'abord factorisées en QR : Jacobi ne travaille alors que sur R (n x n)
+// et U = Q U_R. Si vecteurs vaut 0, seul s est calculé (u et v sont NULL).
+SVD decomposition_SVD(Matrix m, int vecteurs) {
+    SVD f;
+    QR qr;
+    Matrix t, q, u;
+
+    if (m->nb_rows < m->nb_columns) {
+        t = transpose(m);
+        f = decomposition_SVD(t, vecteurs);
+        deleteMatrix(t);
+        return svd_transposee(f);
+    }
+
+    if (m->nb_rows == m->nb_columns) return svd_jacobi(m, vecteurs);
+
+    qr = decomposition_QR(m);
+    t = QR_r(qr);
+    f = svd_jacobi(t, vecteurs);
+    if (vecteurs) {
+        q = QR_q(qr);
+        u = multiplication(q, f.u);
+        deleteMatrix(q);
+        deleteMatrix(f.u);
+        f.u = u;
+    }
+    deleteMatrix(t);
+    deleteQR(qr);
+
+    return f;
+}
+
+// Les k plus grands triplets singuliers, par itération de sous-espace à
+// deux côtés sur k + SVD_SURECHANTILLON vecteurs :
+//   Q = orth(A V), A^T Q = V R  (nouveau V)
+// jusqu'à stabilisation de la diagonale de R, puis Rayleigh-Ritz :
+// Q^T A V = R^T, dont la SVD (l x l) donne les triplets de A.
+// Le coût est en O(m n k) par itération au lieu de O(m n min(m, n)).
+SVD decomposition_SVD_tronquee(Matrix m, unsigned int k, int vecteurs) {
+    unsigned int nr = m->nb_rows, nc = m->nb_columns, p = nr < nc ? nr : nc, l, i, it;
+    double * precedent, ecart, s;
+    Matrix v, y, q, z, r, rt, u2, v2;
+    QR fz;
+    SVD f, g;
+
+    if (k + SVD_SURECHANTILLON >= p) return tronquer(decomposition_SVD(m, vecteurs), k);
+
+    l = k + SVD_SURECHANTILLON;
+    precedent = allouer(l, sizeof(double));
+    for (i = 0; i < l; i++) precedent[i] = 0;
+
+    // départ pseudo-aléatoire déterministe
+    v = matrice_gaussienne(nc, l);
+    q = m_QR_q(v);
+    deleteMatrix(v);
+    v = q;
+    q = NULL;
+    r = NULL;
+
+    for (it = 0; it < SVD_MAX_ITERATIONS; it++) {
+        y = multiplication(m, v);
+        deleteMatrix(q);
+        q = m_QR_q(y);
+        deleteMatrix(y);
+
+        z = newMatrix(nc, l);
+        gemm_t(1, 0, nc, l, nr, 1, m->mat, nc, q->mat, l, 0, z->mat, l);
+        fz = decomposition_QR_en_place(z);
+        deleteMatrix(v);
+        deleteMatrix(r);
+        v = QR_q(fz);
+        r = QR_r(fz);
+        deleteQR(fz);
+
+        ecart = 0;
+        for (i = 0; i < k; i++) {
+            s = fabs(r->mat[(size_t) i * l + i]);
+            if (fabs(s - precedent[i]) > ecart) ecart = fabs(s - precedent[i]);
+            precedent[i] = s;
+        }
+        if (ecart <= 10 * FLT_EPSILON * precedent[0]) break;
+    }
+
+    rt = transpose(r);
+    g = svd_jacobi(rt, vecteurs);
+    f.s = g.s;
+    f.u = f.v = NULL;
+    if (vecteurs) {
+        u2 = multiplication(q, g.u);
+        v2 = multiplication(v, g.v);
+        f.u = u2;
+        f.v = v2;
+        deleteMatrix(g.u);
+        deleteMatrix(g.v);
+    }
+
+    deleteMatrix(rt);
+    deleteMatrix(r);
+    deleteMatrix(q);
+    deleteMatrix(v);
+    free(precedent);
+
+    return tronquer(f, k);
+}
+
+// Approximation de rang k par SVD aléatoire (Halko, Martinsson, Tropp) :
+//   1. Y = A G avec G gaussienne n x (k + SVD_SURECHANTILLON)
+//   2. q itérations de puissance Y = A (A^T Y), réorthonormalisées par QR
+//      pour ne pas perdre les petites directions
+//   3. Q = orth(Y), B = Q^T A (petite, l x n)
+//   4. SVD de B, puis U = Q U_B
+// Le coût est dominé par les produits avec A, en O(m n k) : on n'itère
+// pas jusqu'à convergence comme decomposition_SVD_tronquee, la précision
+// dépend de la décroissance des valeurs singulières et de q.
+SVD decomposition_SVD_aleatoire(Matrix m, unsigned int k, unsigned int q, int vecteurs) {
+    unsigned int nr = m->nb_rows, nc = m->nb_columns, p = nr < nc ? nr : nc, l, i;
+    Matrix g, y, z, base, b, u;
+    SVD f;
+
+    if (k + SVD_SURECHANTILLON >= p) return tronquer(decomposition_SVD(m, vecteurs), k);
+
+    l = k + SVD_SURECHANTILLON;
+    g = matrice_gaussienne(nc, l);
+    y = multiplication(m, g);
+    deleteMatrix(g);
+    base = m_QR_q(y);
+    deleteMatrix(y);
+
+    for (i = 0; i < q; i++) {
+        z = newMatrix(nc, l);
+        gemm_t(1, 0, nc, l, nr, 1, m->mat, nc, base->mat, l, 0, z->mat, l);
+        deleteMatrix(base);
+        base = m_QR_q(z);
+        deleteMatrix(z);
+        y = multiplication(m, base);
+        deleteMatrix(base);
+        base = m_QR_q(y);
+        deleteMatrix(y);
+    }
+
+    // B = Q^T A
+    b = newMatrix(l, nc);
+    gemm_t(1, 0, l, nc, nr, 1, base->mat, l, m->mat, nc, 0, b->mat, nc);
+    f = decomposition_SVD(b, vecteurs);
+    if (vecteurs) {
+        u = multiplication(base, f.u);
+        deleteMatrix(f.u);
+        f.u = u;
+    }
+
+    deleteMatrix(b);
+    deleteMatrix(base);
+
+    return tronquer(f, k);
+}
+
+// Produit U S V^T d'une décomposition (approximation de rang k)
+Matrix recomposer_SVD(SVD f) {
+    unsigned int k = f.s->nb_rows, i, j;
+    Matrix us = new_matrix_copy(f.u), r = newMatrix(f.u->nb_rows, f.v->nb_rows);
+
+    for (i = 0; i < us->nb_rows; i++) {
+        for (j = 0; j < k; j++) us->mat[(size_t) i * k + j] *= f.s->mat[j];
+    }
+    gemm_t(0, 1, r->nb_rows, r->nb_columns, k, 1, us->mat, k, f.v->mat, k, 0, r->mat, r->nb_columns);
+    deleteMatrix(us);
+
+    return r;
+}
+
+void deleteSVD(SVD f) {
+    deleteMatrix(f.u);
+    deleteMatrix(f.s);
+    deleteMatrix(f.v);
+}
+
+// Seuil sous lequel une valeur singulière est considérée comme nulle
+static E seuil_svd(Matrix m, SVD f) {
+    unsigned int d = m->nb_rows > m->nb_columns ? m->nb_rows : m->nb_columns;
+    return f.s->nb_rows ? d * f.s->mat[0] * FLT_EPSILON : 0;
+}
+
+// Nombre de valeurs singulières non négligeables
+unsigned int rang(Matrix m) {
+    SVD f = decomposition_SVD(m, 0);
+    E seuil = seuil_svd(m, f);
+    unsigned int r = 0;
+
+    while (r < f.s->nb_rows && f.s->mat[r] > seuil) r++;
+    deleteSVD(f);
+
+    return r;
+}
+
+// Pseudo-inverse de Moore-Penrose : A+ = V S+ U^T, où S+ inverse les
+// valeurs singulières non négligeables et annule les autres
+Matrix pseudo_inverse(Matrix m) {
+    SVD f = decomposition_SVD(m, 1);
+    E seuil = seuil_svd(m, f);
+    unsigned int k = f.s->nb_rows, i, j;
+    Matrix r = newMatrix(m->nb_columns, m->nb_rows);
+
+    for (j = 0; j < k; j++) {
+        E inv = f.s->mat[j] > seuil ? 1 / f.s->mat[j] : 0;
+        for (i = 0; i < f.v->nb_rows; i++) f.v->mat[(size_t) i * k + j] *= inv;
+    }
+    gemm_t(0, 1, m->nb_columns, m->nb_rows, k, 1, f.v->mat, k, f.u->mat, k, 0, r->mat, m->nb_rows);
+
+    deleteSVD(f);
+
+    return r;
+}
+
+// Conditionnement en norme 2 : plus grande sur plus petite valeur
+// singulière (infini si la matrice n'est pas de rang plein)
+E conditionnement(Matrix m) {
+    SVD f = decomposition_SVD(m, 0);
+    unsigned int k = f.s->nb_rows;
+    E c = k && f.s->mat[k - 1] > 0 ? f.s->mat[0] / f.s->mat[k - 1] : INFINITY;
+
+    deleteSVD(f);
+
+    return c;
+}
@@ -1,6 +1,36 @@
+#include <stdint.h>
 #include <stdio.h>
+#include <stdlib.h>
+#include "system.h"
 
 // Affiche un message d'erreur
 void print_error(char * msg) {
     fprintf(stderr, "\033[1;31mERROR : %s\033[0m\n", msg);
 }
+
+static void * verifier(void * p) {
+    if (!p) {
+        print_error("Impossible d'allouer de la mémoire !");
+        exit(EXIT_FAILURE);
+    }
+    return p;
+}
+
+// Taille en octets de nb éléments, en refusant les débordements
+static size_t octets(size_t nb, size_t taille) {
+    if (!nb) nb = 1;
+    if (taille && nb > SIZE_MAX / taille) verifier(NULL);
+    return nb * taille;
+}
+
+void * allouer(size_t nb, size_t taille) {
+    return verifier(malloc(octets(nb, taille)));
+}
+
+void * allouer_zero(size_t nb, size_t taille) {
+    return verifier(calloc(nb ? nb : 1, taille));
+}
+
+void * reallouer(void * p, size_t nb, size_t taille) {
+    return verifier(realloc(p, octets(nb, taille)));
+}
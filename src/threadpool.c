@@ -0,0 +1,311 @@
+#include <pthread.h>
+#include <sched.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include "system.h"
+#include "threadpool.h"
+
+// Nombre de morceaux créés par thread : un peu plus que 1 pour que le vol
+// de tâches puisse équilibrer la charge
+#define MORCEAUX_PAR_THREAD 4
+
+// Nombre maximal de threads
+#define POOL_MAX 256
+
+// Un calcul parallèle en cours : compte les morceaux non terminés
+typedef struct s_job {
+    tache_f f;
+    void * arg;
+    size_t restant;
+} job;
+
+// Un morceau de travail
+typedef struct {
+    job * j;
+    size_t debut;
+    size_t fin;
+} tache;
+
+// File à deux bouts : le propriétaire empile et dépile en bas (LIFO),
+// les autres threads volent en haut (FIFO)
+typedef struct {
+    pthread_mutex_t verrou;
+    tache * taches;
+    size_t capacite;
+    size_t haut;
+    size_t bas;
+} deque;
+
+static struct {
+    int initialise;
+    unsigned int nb_threads;
+    pthread_t threads[POOL_MAX];
+    deque files[POOL_MAX];
+    pthread_mutex_t verrou;     // protège le sommeil des threads
+    pthread_cond_t reveil;
+    size_t en_attente;          // nombre de tâches dans les files
+    int arret;
+} pool;
+
+// Indice de la file du thread courant (0 pour les threads hors du pool)
+static __thread unsigned int mon_indice = 0;
+
+
+// ---------------------------------------------------------------------
+// Files de tâches
+// ---------------------------------------------------------------------
+
+static void deque_init(deque * d) {
+    pthread_mutex_init(&d->verrou, NULL);
+    d->capacite = 64;
+    d->taches = allouer(d->capacite, sizeof(tache));
+    d->haut = d->bas = 0;
+}
+
+static void deque_free(deque * d) {
+    pthread_mutex_destroy(&d->verrou);
+    free(d->taches);
+}
+
+static void deque_push(deque * d, tache t) {
+    pthread_mutex_lock(&d->verrou);
+    if (d->bas == d->capacite) {
+        // on tasse la file vers le début, puis on l'agrandit si besoin
+        size_t n = d->bas - d->haut, i;
+        for (i = 0; i < n; i++) d->taches[i] = d->taches[d->haut + i];
+        d->haut = 0;
+        d->bas = n;
+        if (n == d->capacite) {
+            d->capacite *= 2;
+            d->taches = reallouer(d->taches, d->capacite, sizeof(tache));
+        }
+    }
+    d->taches[d->bas++] = t;
+    pthread_mutex_unlock(&d->verrou);
+}
+
+static int deque_pop(deque * d, tache * t) {
+    int ok = 0;
+    pthread_mutex_lock(&d->verrou);
+    if (d->bas > d->haut) {
+        *t = d->taches[--d->bas];
+        ok = 1;
+    }
+    pthread_mutex_unlock(&d->verrou);
+    return ok;
+}
+
+static int deque_steal(deque * d, tache * t) {
+    int ok = 0;
+    if (pthread_mutex_trylock(&d->verrou)) return 0;
+    if (d->bas > d->haut) {
+        *t = d->taches[d->haut++];
+        ok = 1;
+    }
+    pthread_mutex_unlock(&d->verrou);
+    return ok;
+}
+
+
+// ---------------------------------------------------------------------
+// Exécution
+// ---------------------------------------------------------------------
+
+// Cherche une tâche : d'abord dans sa propre file, sinon chez les autres
+static int trouver_tache(unsigned int moi, tache * t) {
+    unsigned int i, n = pool.nb_threads;
+
+    if (deque_pop(&pool.files[moi], t)) goto trouve;
+    for (i = 1; i < n; i++) {
+        if (deque_steal(&pool.files[(moi + i) % n], t)) goto trouve;
+    }
+    return 0;
+
+trouve:
+    __atomic_sub_fetch(&pool.en_attente, 1, __ATOMIC_ACQ_REL);
+    return 1;
+}
+
+static void executer(tache * t) {
+    t->j->f(t->j->arg, t->debut, t->fin);
+    __atomic_sub_fetch(&t->j->restant, 1, __ATOMIC_ACQ_REL);
+}
+
+static void * travailleur(void * arg) {
+    tache t;
+
+    mon_indice = (unsigned int) (size_t) arg;
+
+    for (;;) {
+        if (trouver_tache(mon_indice, &t)) {
+            executer(&t);
+            continue;
+        }
+        pthread_mutex_lock(&pool.verrou);
+        while (!pool.arret && !__atomic_load_n(&pool.en_attente, __ATOMIC_ACQUIRE)) {
+            pthread_cond_wait(&pool.reveil, &pool.verrou);
+        }
+        if (pool.arret) {
+            pthread_mutex_unlock(&pool.verrou);
+            break;
+        }
+        pthread_mutex_unlock(&pool.verrou);
+    }
+
+    return NULL;
+}
+
+// Démarre n threads (le thread appelant compte pour un)
+static void pool_start(unsigned int n) {
+    unsigned int i;
+
+    if (n == 0) {
+        long c = sysconf(_SC_NPROCESSORS_ONLN);
+        n = c > 0 ? (unsigned int) c : 1;
+    }
+    if (n > POOL_MAX) n = POOL_MAX;
+
+    pool.nb_threads = n;
+    pool.arret = 0;
+    pool.en_attente = 0;
+    pthread_mutex_init(&pool.verrou, NULL);
+    pthread_cond_init(&pool.reveil, NULL);
+    for (i = 0; i < n; i++) deque_init(&pool.files[i]);
+    for (i = 1; i < n; i++) {
+        if (pthread_create(&pool.threads[i], NULL, travailleur, (void *) (size_t) i)) {
+            print_error("Cannot create the worker threads");
+            exit(EXIT_FAILURE);
+        }
+    }
+    pool.initialise = 1;
+}
+
+void pool_shutdown(void) {
+    unsigned int i;
+
+    if (!pool.initialise) return;
+
+    pthread_mutex_lock(&pool.verrou);
+    pool.arret = 1;
+    pthread_cond_broadcast(&pool.reveil);
+    pthread_mutex_unlock(&pool.verrou);
+
+    for (i = 1; i < pool.nb_threads; i++) pthread_join(pool.threads[i], NULL);
+    for (i = 0; i < pool.nb_threads; i++) deque_free(&pool.files[i]);
+    pthread_mutex_destroy(&pool.verrou);
+    pthread_cond_destroy(&pool.reveil);
+    pool.initialise = 0;
+}
+
+void pool_set_threads(unsigned int n) {
+    pool_shutdown();
+    pool_start(n);
+}
+
+unsigned int pool_threads(void) {
+    if (!pool.initialise) pool_start(0);
+    return pool.nb_threads;
+}
+
+void parallel_for(size_t debut, size_t fin, size_t grain, tache_f f, void * arg) {
+    size_t n, nb, taille, d;
+    unsigned int moi;
+    job j;
+    tache t;
+
+    if (fin <= debut) return;
+    if (!grain) grain = 1;
+
+    n = fin - debut;
+    if (n <= grain || pool_threads() == 1) {
+        f(arg, debut, fin);
+        return;
+    }
+
+    nb = (n + grain - 1) / grain;
+    if (nb > (size_t) pool.nb_threads * MORCEAUX_PAR_THREAD) {
+        nb = (size_t) pool.nb_threads * MORCEAUX_PAR_THREAD;
+    }
+    taille = (n + nb - 1) / nb;
+    nb = (n + taille - 1) / taille;
+
+    j.f = f;
+    j.arg = arg;
+    j.restant = nb;
+
+    // on empile à l'envers pour que l'appelant traite d'abord le début
+    moi = mon_indice;
+    for (d = nb; d-- > 0; ) {
+        t.j = &j;
+        t.debut = debut + d * taille;
+        t.fin = t.debut + taille < fin ? t.debut + taille : fin;
+        deque_push(&pool.files[moi], t);
+    }
+
+    __atomic_add_fetch(&pool.en_attente, nb, __ATOMIC_ACQ_REL);
+    pthread_mutex_lock(&pool.verrou);
+    pthread_cond_broadcast(&pool.reveil);
+    pthread_mutex_unlock(&pool.verrou);
+
+    // l'appelant travaille (éventuellement pour d'autres calculs) en
+    // attendant la fin de ses propres morceaux
+    while (__atomic_load_n(&j.restant, __ATOMIC_ACQUIRE)) {
+        if (trouver_tache(moi, &t)) executer(&t);
+        else sched_yield();
+    }
+}
+
+
+// Réduction : chaque morceau écrit son résultat dans sa case, puis on
+// somme les cases dans l'ordre pour un résultat reproductible
+typedef struct {
+    reduction_f f;
+    void * arg;
+    size_t debut;
+    size_t fin;
+    size_t taille;
+    double * resultats;
+} reduction;
+
+static void reduction_morceau(void * arg, size_t debut, size_t fin) {
+    reduction * r = arg;
+    size_t c, d, f;
+
+    for (c = debut; c < fin; c++) {
+        d = r->debut + c * r->taille;
+        f = d + r->taille < r->fin ? d + r->taille : r->fin;
+        r->resultats[c] = r->f(r->arg, d, f);
+    }
+}
+
+double parallel_reduce(size_t debut, size_t fin, size_t grain, reduction_f f, void * arg) {
+    size_t n, nb, c;
+    double somme = 0;
+    reduction r;
+
+    if (fin <= debut) return 0;
+    if (!grain) grain = 1;
+
+    n = fin - debut;
+    if (n <= grain || pool_threads() == 1) return f(arg, debut, fin);
+
+    nb = (n + grain - 1) / grain;
+    if (nb > (size_t) pool.nb_threads * MORCEAUX_PAR_THREAD) {
+        nb = (size_t) pool.nb_threads * MORCEAUX_PAR_THREAD;
+    }
+
+    r.f = f;
+    r.arg = arg;
+    r.debut = debut;
+    r.fin = fin;
+    r.taille = (n + nb - 1) / nb;
+    nb = (n + r.taille - 1) / r.taille;
+    r.resultats = allouer(nb, sizeof(double));
+
+    parallel_for(0, nb, 1, reduction_morceau, &r);
+
+    for (c = 0; c < nb; c++) somme += r.resultats[c];
+    free(r.resultats);
+
+    return somme;
+}
@@ -0,0 +1,99 @@
+#include <stdlib.h>
+#include "matrix.h"
+#include "gemm.h"
+#include "threadpool.h"
+#include "trsm.h"
+
+// Résolution d'un bloc diagonal [i0, i1[ sur les colonnes [debut, fin[ de B
+typedef struct {
+    const E * t;
+    unsigned int ldt;
+    int trans;
+    int unite;
+    int descente;       // 1 si op(T) est triangulaire inférieure
+    unsigned int i0;
+    unsigned int i1;
+    E * b;
+    unsigned int ldb;
+} args_trsm;
+
+// Élément (i, j) de op(T)
+#define OP_T(a, i, j) ((a)->trans ? (a)->t[(size_t) (j) * (a)->ldt + (i)] : (a)->t[(size_t) (i) * (a)->ldt + (j)])
+
+static void bloc_morceau(void * arg, size_t debut, size_t fin) {
+    args_trsm * a = arg;
+    unsigned int i, k, r;
+    E * bi, * bk, l;
+    size_t j;
+
+    for (r = 0; r < a->i1 - a->i0; r++) {
+        i = a->descente ? a->i0 + r : a->i1 - 1 - r;
+        bi = a->b + (size_t) i * a->ldb;
+        if (a->descente) {
+            for (k = a->i0; k < i; k++) {
+                l = OP_T(a, i, k);
+                if (l == 0) continue;
+                bk = a->b + (size_t) k * a->ldb;
+                for (j = debut; j < fin; j++) bi[j] -= l * bk[j];
+            }
+        } else {
+            for (k = i + 1; k < a->i1; k++) {
+                l = OP_T(a, i, k);
+                if (l == 0) continue;
+                bk = a->b + (size_t) k * a->ldb;
+                for (j = debut; j < fin; j++) bi[j] -= l * bk[j];
+            }
+        }
+        if (!a->unite) {
+            l = 1 / OP_T(a, i, i);
+            for (j = debut; j < fin; j++) bi[j] *= l;
+        }
+    }
+}
+
+// Résolution par blocs : chaque bloc diagonal de TRSM_NB lignes est résolu
+// directement (colonnes de B réparties sur le pool), puis retiré du reste
+// de B par un produit GEMM.
+void trsm(triangle uplo, int trans, int unite, unsigned int n, unsigned int m,
+          const E * t, unsigned int ldt, E * b, unsigned int ldb) {
+    unsigned int i0, i1, nb;
+    size_t grain;
+    args_trsm a;
+
+    if (!n || !m) return;
+
+    a.t = t;
+    a.ldt = ldt;
+    a.trans = trans;
+    a.unite = unite;
+    a.descente = (uplo == TRI_INF) != (trans != 0);
+    a.b = b;
+    a.ldb = ldb;
+
+    for (nb = 0; nb < n; nb += TRSM_NB) {
+        if (a.descente) {
+            i0 = nb;
+            i1 = n - nb < TRSM_NB ? n : nb + TRSM_NB;
+        } else {
+            i1 = n - nb;
+            i0 = i1 < TRSM_NB ? 0 : i1 - TRSM_NB;
+        }
+        a.i0 = i0;
+        a.i1 = i1;
+        grain = PARALLEL_SEUIL / ((size_t) (i1 - i0) * (i1 - i0)) + 1;
+        parallel_for(0, m, grain, bloc_morceau, &a);
+
+        // B[reste] -= op(T)[reste, i0:i1] * X[i0:i1]
+        if (a.descente && i1 < n) {
+            gemm_t(trans, 0, n - i1, m, i1 - i0,
+                   -1, trans ? t + (size_t) i0 * ldt + i1 : t + (size_t) i1 * ldt + i0, ldt,
+                   b + (size_t) i0 * ldb, ldb,
+                   1, b + (size_t) i1 * ldb, ldb);
+        } else if (!a.descente && i0 > 0) {
+            gemm_t(trans, 0, i0, m, i1 - i0,
+                   -1, trans ? t + (size_t) i0 * ldt : t + i0, ldt,
+                   b + (size_t) i0 * ldb, ldb,
+                   1, b, ldb);
+        }
+    }
+}
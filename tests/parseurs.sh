@@ -0,0 +1,34 @@
+#!/bin/sh
+# Compare, pour chaque fichier du corpus, la sortie de l'interpréteur avec
+# l'analyseur direct et avec mpc seul (MATRIX_PARSEUR=mpc) : les deux
+# analyseurs doivent construire les mêmes arbres, donc afficher la même
+# chose, y compris pour les lignes erronées.
+# Usage : tests/parseurs.sh [exécutable]   (par défaut bin/main)
+
+dossier=$(dirname "$0")
+exe=${1:-bin/main}
+tmp=${TMPDIR:-/tmp}/parseurs.$$
+echecs=0
+
+if [ ! -x "$exe" ]; then
+    echo "Exécutable introuvable : $exe" >&2
+    exit 2
+fi
+
+mkdir -p "$tmp" || exit 2
+trap 'rm -rf "$tmp"' EXIT
+
+for entree in "$dossier"/corpus/*.txt; do
+    nom=$(basename "$entree" .txt)
+    "$exe" < "$entree" > "$tmp/$nom.direct" 2>&1
+    MATRIX_PARSEUR=mpc "$exe" < "$entree" > "$tmp/$nom.mpc" 2>&1
+    if cmp -s "$tmp/$nom.direct" "$tmp/$nom.mpc"; then
+        echo "ok     $nom"
+    else
+        echo "ÉCHEC  $nom"
+        diff "$tmp/$nom.direct" "$tmp/$nom.mpc" | head -20
+        echecs=$((echecs + 1))
+    fi
+done
+
+[ "$echecs" -eq 0 ]